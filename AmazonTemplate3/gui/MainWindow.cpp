@@ -299,57 +299,7 @@ QSharedPointer<QSettings> MainWindow::settingsFolder() const
 
 QMap<QString, QString> MainWindow::get_skuPattern_customInstructions() const
 {
-    QMap<QString, QString> skuPattern_customInstructions;
-    auto customInstructions = ui->textEditExtraInfos->toPlainText().trimmed();
-    if (!customInstructions.isEmpty())
-    {
-        const QStringList &lines = customInstructions.split("\n");
-        skuPattern_customInstructions[QString{}] = lines[0].trimmed();
-        if (!skuPattern_customInstructions[QString{}].endsWith("."))
-        {
-            skuPattern_customInstructions[QString{}] += ".";
-        }
-        QStringList lastSkus;
-        QStringList lastInstructions;
-        for (int i=1; i<lines.size(); ++i)
-        {
-            const auto &line = lines[i];
-            if (line.startsWith("["))
-            {
-                if (!lastSkus.isEmpty() && !lastInstructions.isEmpty())
-                {
-                    for (const auto &sku : lastSkus)
-                    {
-                        skuPattern_customInstructions[sku] = lastInstructions.join(" ");
-                    }
-                }
-                lastSkus.clear();
-                lastInstructions.clear();
-                const auto &lineSkus = lines[i].mid(1, line.size()-2);
-                const auto &skus = lineSkus.split(",");
-                for (const auto &sku : skus)
-                {
-                    lastSkus << sku.trimmed();
-                }
-            }
-            else if (!lastSkus.isEmpty())
-            {
-                lastInstructions << line.trimmed();
-                if (!lastInstructions.last().endsWith("."))
-                {
-                    lastInstructions.last() += ".";
-                }
-            }
-        }
-        if (!lastSkus.isEmpty() && !lastInstructions.isEmpty())
-        {
-            for (const auto &sku : lastSkus)
-            {
-                skuPattern_customInstructions[sku] = lastInstructions.join(" ");
-            }
-        }
-    }
-    return skuPattern_customInstructions;
+    return TemplateFiller::parseCustomInstructions(ui->textEditExtraInfos->toPlainText());
 }
 
 void MainWindow::_enableGenerateButtonIfValid()
@@ -0,0 +1,199 @@
+#include <vector>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSettings>
+#include <QTextStream>
+
+#include <TemplateFiller.h>
+#include <ExceptionTemplate.h>
+#include <AiFailureTable.h>
+#include <AiReplyStore.h>
+#include <FileModelToFill.h>
+#include <FileModelSources.h>
+#include <fillers/FillerSelectable.h>
+
+#include "BatchRunner.h"
+
+const QString BatchRunner::SETTINGS_KEY_CUSTOM_INSTRUCTIONS{"MainWindowExtraInfos"};
+
+BatchRunner::Collection BatchRunner::collection(
+        const QString &workingDirOrTemplateFromPath)
+{
+    Collection collection;
+    QFileInfo fileInfo{workingDirOrTemplateFromPath};
+    QDir workingDir;
+    if (fileInfo.isDir())
+    {
+        workingDir = QDir{fileInfo.absoluteFilePath()};
+        const auto &templateToPaths = workingDir.entryList(FileModelToFill::NAME_FILTERS, QDir::Files);
+        if (templateToPaths.size() != 1)
+        {
+            ExceptionTemplate exception;
+            exception.setInfos(QObject::tr("Template from unknown")
+                               , QObject::tr("The directory %1 has %2 templates to fill, give the path of the from template instead: %3")
+                               .arg(workingDir.path(), QString::number(templateToPaths.size()), templateToPaths.join(", ")));
+            exception.raise();
+        }
+        collection.templateFromPath = workingDir.absoluteFilePath(templateToPaths.first());
+    }
+    else if (fileInfo.isFile())
+    {
+        workingDir = fileInfo.absoluteDir();
+        collection.templateFromPath = fileInfo.absoluteFilePath();
+    }
+    else
+    {
+        ExceptionTemplate exception;
+        exception.setInfos(QObject::tr("Not found")
+                           , QObject::tr("The working directory or template %1 doesn't exist")
+                           .arg(workingDirOrTemplateFromPath));
+        exception.raise();
+    }
+    const auto &toFileInfos = workingDir.entryInfoList(FileModelToFill::NAME_FILTERS, QDir::Files);
+    for (const auto &toFileInfo : toFileInfos)
+    {
+        collection.templateToPaths << toFileInfo.absoluteFilePath();
+    }
+    const auto &sourceFileInfos = workingDir.entryInfoList(FileModelSources::NAME_FILTERS, QDir::Files);
+    for (const auto &sourceFileInfo : sourceFileInfos)
+    {
+        collection.templateSourcePaths << sourceFileInfo.absoluteFilePath();
+    }
+    // Same custom instructions as the ones saved by the main window
+    QSettings settings{workingDir.absoluteFilePath("settings.ini"), QSettings::IniFormat};
+    collection.skuPattern_customInstructions = TemplateFiller::parseCustomInstructions(
+                settings.value(SETTINGS_KEY_CUSTOM_INSTRUCTIONS).toString());
+    return collection;
+}
+
+BatchRunner::BatchRunner(
+        const QString &workingDirCommon
+        , const QList<Collection> &collections
+        , int nJobs
+        , bool compactCaches
+        , bool incremental)
+{
+    m_workingDirCommon = workingDirCommon;
+    m_collections = collections;
+    m_nJobs = qMax(1, nJobs);
+    m_compactCaches = compactCaches;
+    m_incremental = incremental;
+    m_nextCollection = 0;
+    m_nFailed = 0;
+}
+
+void BatchRunner::recordMissingEquivalentPolicy(MissingEquivalentPolicy policy)
+{
+    if (policy == MissingEquivalentPolicy::Skip)
+    {
+        FillerSelectable::recordEditCallback(
+                    [](TemplateFiller *, const QString &title, const QString &message) -> QCoro::Task<bool>
+        {
+            QTextStream{stderr} << title << ": " << message << " (skipped)\n";
+            co_return false; // The value is left empty
+        });
+    }
+    else
+    {
+        FillerSelectable::recordEditCallback(nullptr); // An exception is raised
+    }
+}
+
+QCoro::Task<int> BatchRunner::run()
+{
+    m_nextCollection = 0;
+    m_nFailed = 0;
+    std::vector<QCoro::Task<void>> jobs;
+    int nJobs = qMin(m_nJobs, int(m_collections.size()));
+    for (int i=0; i<nJobs; ++i)
+    {
+        jobs.push_back(_runJobs());
+    }
+    for (auto &job : jobs)
+    {
+        co_await job;
+    }
+    if (m_compactCaches)
+    {
+        _compactCaches(m_workingDirCommon); // Once no collection uses it anymore
+    }
+    co_return m_nFailed;
+}
+
+QCoro::Task<void> BatchRunner::_runJobs()
+{
+    while (m_nextCollection < m_collections.size())
+    {
+        const Collection collection{m_collections[m_nextCollection]};
+        ++m_nextCollection;
+        if (!co_await _fill(collection))
+        {
+            ++m_nFailed;
+        }
+    }
+}
+
+QCoro::Task<bool> BatchRunner::_fill(const Collection &collection)
+{
+    const Collection collectionCopy{collection};
+    const auto &templateFromPath = collectionCopy.templateFromPath;
+    QTextStream out{stdout};
+    QTextStream err{stderr};
+    out << "Filling " << templateFromPath << Qt::endl;
+    bool success = false;
+    try
+    {
+        TemplateFiller templateFiller{
+            m_workingDirCommon
+                    , templateFromPath
+                    , collectionCopy.templateToPaths
+                    , collectionCopy.templateSourcePaths
+                    , collectionCopy.skuPattern_customInstructions};
+        // Same controls as MainWindow::baseControlsWithoutPopup
+        templateFiller.checkParentSkus();
+        templateFiller.checkPossibleValues();
+        templateFiller.checkColumnsFilled();
+        templateFiller.checkPreviewImages();
+        templateFiller.checkKeywords();
+        templateFiller.setIncremental(m_incremental);
+        co_await templateFiller.fillValues();
+        auto aiFailureTable = templateFiller.aiFailureTable();
+        for (int i=0; i<aiFailureTable->rowCount(); ++i)
+        {
+            QStringList cells;
+            for (int j=0; j<aiFailureTable->columnCount(); ++j)
+            {
+                cells << aiFailureTable->data(aiFailureTable->index(i, j)).toString();
+            }
+            err << "AI failure in " << templateFromPath << ": " << cells.join(" | ") << Qt::endl;
+        }
+        success = true;
+    }
+    catch (const ExceptionTemplate &exception)
+    {
+        err << "Error in " << templateFromPath << ": "
+            << exception.title() << ": " << exception.error() << Qt::endl;
+    }
+    catch (const std::exception &exception)
+    {
+        err << "Error in " << templateFromPath << ": " << exception.what() << Qt::endl;
+    }
+    if (m_compactCaches)
+    {
+        _compactCaches(QFileInfo{templateFromPath}.absolutePath());
+    }
+    out << (success ? "Done " : "Failed ") << templateFromPath << Qt::endl;
+    co_return success;
+}
+
+void BatchRunner::_compactCaches(const QString &workingDir) const
+{
+    QDir dir{workingDir};
+    const auto &logFileInfos = dir.entryInfoList(QStringList{"*.replies"}, QDir::Files);
+    for (const auto &logFileInfo : logFileInfos)
+    {
+        AiReplyStore::instance()->compact(
+                    dir.absoluteFilePath(logFileInfo.completeBaseName() + ".ini"));
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QCoro/QCoroTask>
+
+// Fills the templates of several collections without any user interaction.
+// Each collection is a working directory with its from template. Up to
+// nJobs collections are filled at the same time, sharing the AI queries and
+// the attribute tables of the common directory.
+class BatchRunner
+{
+public:
+    struct Collection
+    {
+        QString templateFromPath;
+        QStringList templateToPaths;
+        QStringList templateSourcePaths;
+        QMap<QString, QString> skuPattern_customInstructions;
+    };
+    enum class MissingEquivalentPolicy
+    {
+        Fail
+        , Skip
+    };
+    static const QString SETTINGS_KEY_CUSTOM_INSTRUCTIONS;
+    static Collection collection(const QString &workingDirOrTemplateFromPath);
+    BatchRunner(const QString &workingDirCommon
+                , const QList<Collection> &collections
+                , int nJobs
+                , bool compactCaches
+                , bool incremental);
+    static void recordMissingEquivalentPolicy(MissingEquivalentPolicy policy);
+    QCoro::Task<int> run(); // Returns the number of collections that failed
+
+private:
+    QString m_workingDirCommon;
+    QList<Collection> m_collections;
+    int m_nJobs;
+    bool m_compactCaches;
+    bool m_incremental;
+    int m_nextCollection;
+    int m_nFailed;
+    QCoro::Task<void> _runJobs();
+    QCoro::Task<bool> _fill(const Collection &collection);
+    void _compactCaches(const QString &workingDir) const;
+};
+
+#endif // BATCHRUNNER_H
@@ -0,0 +1,129 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QTimer>
+#include <QSet>
+#include <QCoro/QCoroTask>
+
+#include <ExceptionTemplate.h>
+#include <Tracer.h>
+#include "OpenAi2.h"
+
+#include "BatchRunner.h"
+
+int main(int argc, char *argv[])
+{
+    qRegisterMetaType<QSet<QString>>();
+    qRegisterMetaType<QHash<QString, QSet<QString>>>();
+    qRegisterMetaType<QMap<QString, bool>>();
+
+    QCoreApplication::setOrganizationName("Icinger Power");
+    QCoreApplication::setOrganizationDomain("ecomelitepro.com");
+    QCoreApplication::setApplicationName("Amazon Template 3 CLI");
+
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+                QCoreApplication::translate(
+                    "main", "Fills the Amazon templates of each collection without user interaction."));
+    parser.addHelpOption();
+    parser.addPositionalArgument(
+                "collections"
+                , QCoreApplication::translate(
+                    "main", "Working directories, or from templates when a directory has several templates to fill.")
+                , "<collection...>");
+    QCommandLineOption optionCommonDir{
+        "common-dir"
+        , QCoreApplication::translate("main", "Directory of the common settings (attributes, equivalences...).")
+        , "dir"};
+    QCommandLineOption optionApiKey{
+        "api-key"
+        , QCoreApplication::translate("main", "OpenAI API key. OPENAI_API_KEY is used by default.")
+        , "key"
+        , qEnvironmentVariable("OPENAI_API_KEY")};
+    QCommandLineOption optionJobs{
+        "jobs"
+        , QCoreApplication::translate("main", "Number of collections filled at the same time.")
+        , "n"
+        , "1"};
+    QCommandLineOption optionMaxQueries{
+        "max-queries"
+        , QCoreApplication::translate("main", "Maximum number of AI queries at the same time.")
+        , "n"
+        , "10"};
+    QCommandLineOption optionMissingEquivalent{
+        "on-missing-equivalent"
+        , QCoreApplication::translate("main", "What to do when a value has no equivalent: fail or skip (value left empty).")
+        , "policy"
+        , "fail"};
+    QCommandLineOption optionCompactCache{
+        "compact-cache"
+        , QCoreApplication::translate("main", "Compact the AI reply caches of each collection once filled.")};
+    QCommandLineOption optionIncremental{
+        "incremental"
+        , QCoreApplication::translate("main", "Only refill the SKUs whose inputs changed since the last fill, the other values being read back from the FILLED templates.")};
+    QCommandLineOption optionTrace{
+        "trace"
+        , QCoreApplication::translate("main", "Write a trace of the run that opens in Perfetto or chrome://tracing.")
+        , "file"};
+    parser.addOption(optionCommonDir);
+    parser.addOption(optionApiKey);
+    parser.addOption(optionJobs);
+    parser.addOption(optionMaxQueries);
+    parser.addOption(optionMissingEquivalent);
+    parser.addOption(optionCompactCache);
+    parser.addOption(optionIncremental);
+    parser.addOption(optionTrace);
+    parser.process(app);
+
+    QTextStream err{stderr};
+    const auto &collectionPaths = parser.positionalArguments();
+    const auto &apiKey = parser.value(optionApiKey);
+    const auto &missingEquivalent = parser.value(optionMissingEquivalent);
+    if (collectionPaths.isEmpty() || !parser.isSet(optionCommonDir) || apiKey.isEmpty())
+    {
+        err << QCoreApplication::translate("main", "A collection, --common-dir and an API key are needed.") << Qt::endl;
+        parser.showHelp(1);
+    }
+    if (missingEquivalent != "fail" && missingEquivalent != "skip")
+    {
+        err << QCoreApplication::translate("main", "Unknown policy: %1").arg(missingEquivalent) << Qt::endl;
+        return 1;
+    }
+
+    QList<BatchRunner::Collection> collections;
+    try
+    {
+        for (const auto &collectionPath : collectionPaths)
+        {
+            collections << BatchRunner::collection(collectionPath);
+        }
+    }
+    catch (const ExceptionTemplate &exception)
+    {
+        err << exception.title() << ": " << exception.error() << Qt::endl;
+        return 1;
+    }
+
+    if (parser.isSet(optionTrace))
+    {
+        Tracer::instance()->start(parser.value(optionTrace));
+    }
+    OpenAi2::instance()->init(apiKey);
+    OpenAi2::instance()->setMaxQueriesSameTime(parser.value(optionMaxQueries).toInt());
+    BatchRunner::recordMissingEquivalentPolicy(
+                missingEquivalent == "skip" ? BatchRunner::MissingEquivalentPolicy::Skip
+                                            : BatchRunner::MissingEquivalentPolicy::Fail);
+    BatchRunner runner{parser.value(optionCommonDir)
+                , collections
+                , parser.value(optionJobs).toInt()
+                , parser.isSet(optionCompactCache)
+                , parser.isSet(optionIncremental)};
+    QTimer::singleShot(0, &app, [&app, &runner]() {
+        QCoro::connect(runner.run(), &app, [&app](int nFailed) {
+            Tracer::instance()->save();
+            app.exit(nFailed > 0 ? 1 : 0);
+        });
+    });
+    return app.exec();
+}
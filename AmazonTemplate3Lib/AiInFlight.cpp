@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <exception>
+
+#include <QCryptographicHash>
+
+#include "AiInFlight.h"
+
+AiInFlight *AiInFlight::instance()
+{
+    static AiInFlight instance;
+    return &instance;
+}
+
+QByteArray AiInFlight::questionKey(const QStringList &parts)
+{
+    QCryptographicHash hash{QCryptographicHash::Sha1};
+    for (const auto &part : parts)
+    {
+        hash.addData(part.toUtf8());
+        hash.addData(QByteArrayView{"\x1f", 1});
+    }
+    return hash.result().toHex();
+}
+
+QByteArray AiInFlight::questionKey(
+        const QStringList &parts
+        , const QMap<QString, QString> &valuesForAi
+        , const QSet<QString> &possibleValues)
+{
+    QStringList allParts{parts};
+    for (auto it = valuesForAi.cbegin(); it != valuesForAi.cend(); ++it)
+    {
+        allParts << it.key() + "=" + it.value();
+    }
+    QStringList sortedValues{possibleValues.values()};
+    std::sort(sortedValues.begin(), sortedValues.end());
+    allParts << QString::number(sortedValues.size());
+    allParts << sortedValues;
+    return questionKey(allParts);
+}
+
+QCoro::Task<QString> AiInFlight::ask(
+        const QByteArray &key, std::function<QCoro::Task<QString>()> askAi)
+{
+    const QByteArray keyCopy{key}; // The caller's key may not outlive the first suspension
+    auto it = m_key_task.constFind(keyCopy);
+    if (it != m_key_task.cend())
+    {
+        auto task = it.value();
+        co_return co_await *task;
+    }
+    auto task = QSharedPointer<QCoro::Task<QString>>::create(_ask(std::move(askAi)));
+    m_key_task.insert(keyCopy, task);
+    QString reply;
+    std::exception_ptr exception;
+    try
+    {
+        reply = co_await *task;
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+    m_key_task.remove(keyCopy);
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+    co_return reply;
+}
+
+int AiInFlight::countInFlight() const
+{
+    return m_key_task.size();
+}
+
+QCoro::Task<QString> AiInFlight::_ask(std::function<QCoro::Task<QString>()> askAi)
+{
+    // The function is kept in this frame so lambda captures live until the reply
+    co_return co_await askAi();
+}
@@ -0,0 +1,37 @@
+#ifndef AIINFLIGHT_H
+#define AIINFLIGHT_H
+
+#include <functional>
+
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QCoro/QCoroTask>
+
+// Shares AI questions that are asked several times at once, for instance by
+// targets of different languages filled concurrently. A question is keyed by
+// a hash of what makes its prompt: while it is in flight, the requesters
+// asking the same key await the same reply instead of asking again.
+class AiInFlight
+{
+public:
+    static AiInFlight *instance();
+    static QByteArray questionKey(const QStringList &parts);
+    static QByteArray questionKey(const QStringList &parts
+                                  , const QMap<QString, QString> &valuesForAi
+                                  , const QSet<QString> &possibleValues);
+    QCoro::Task<QString> ask(const QByteArray &key
+                             , std::function<QCoro::Task<QString>()> askAi);
+    int countInFlight() const;
+
+private:
+    AiInFlight() = default;
+    QHash<QByteArray, QSharedPointer<QCoro::Task<QString>>> m_key_task;
+    static QCoro::Task<QString> _ask(std::function<QCoro::Task<QString>()> askAi);
+};
+
+#endif // AIINFLIGHT_H
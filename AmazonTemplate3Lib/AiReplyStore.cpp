@@ -0,0 +1,502 @@
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QObject>
+#include <QSaveFile>
+#include <QSettings>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+#include "ExceptionTemplate.h"
+
+#include "AiReplyStore.h"
+
+static const QByteArray LOG_MAGIC{"AIRLOG01"};
+static const QByteArray INDEX_MAGIC{"AIRIDX01"};
+static constexpr qint64 RECORD_HEADER_SIZE = 22; // hash, key size, value size, model size, timestamp
+static constexpr qint64 INDEX_HEADER_SIZE = 24; // magic, log size indexed, entry count
+static constexpr qint64 INDEX_ENTRY_SIZE = 16; // hash, reserved, offset
+
+static void raiseLogError(const QFileDevice &logFile, const QString &error)
+{
+    ExceptionTemplate exception;
+    exception.setInfos(QObject::tr("AI replies cache error")
+                       , error + ": " + logFile.fileName() + "\n" + logFile.errorString());
+    exception.raise();
+}
+
+AiReplyStore *AiReplyStore::instance()
+{
+    static AiReplyStore instance;
+    return &instance;
+}
+
+AiReplyStore::~AiReplyStore()
+{
+    clear();
+}
+
+bool AiReplyStore::contains(const QString &settingsFilePath, const QString &id)
+{
+    QMutexLocker locker(&m_mutex);
+    QString value;
+    return _find(_repliesLog(settingsFilePath), id, value);
+}
+
+QString AiReplyStore::value(const QString &settingsFilePath, const QString &id)
+{
+    QMutexLocker locker(&m_mutex);
+    QString value;
+    _find(_repliesLog(settingsFilePath), id, value);
+    return value;
+}
+
+void AiReplyStore::setValue(
+        const QString &settingsFilePath
+        , const QString &id
+        , const QString &value
+        , const QString &gptModel)
+{
+    QMutexLocker locker(&m_mutex);
+    auto &repliesLog = _repliesLog(settingsFilePath);
+    _setValue(repliesLog, id, value, gptModel.toUtf8());
+    if (!repliesLog.logFile->flush())
+    {
+        raiseLogError(*repliesLog.logFile, QObject::tr("The AI reply couldn't be saved"));
+    }
+}
+
+void AiReplyStore::setValues(
+        const QString &settingsFilePath
+        , const QHash<QString, QString> &id_values
+        , const QString &gptModel)
+{
+    QMutexLocker locker(&m_mutex);
+    auto &repliesLog = _repliesLog(settingsFilePath);
+    const QByteArray &gptModelUtf8 = gptModel.toUtf8();
+    for (auto it = id_values.begin(); it != id_values.end(); ++it)
+    {
+        _setValue(repliesLog, it.key(), it.value(), gptModelUtf8);
+    }
+    if (!repliesLog.logFile->flush())
+    {
+        raiseLogError(*repliesLog.logFile, QObject::tr("The AI replies couldn't be saved"));
+    }
+}
+
+void AiReplyStore::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    for (auto it = m_filePath_log.begin(); it != m_filePath_log.end(); ++it)
+    {
+        if (!it.value().logFile->flush())
+        {
+            qDebug() << "AiReplyStore can't flush" << it.value().logFile->fileName() << it.value().logFile->errorString();
+        }
+        if (!it.value().hash_offsetTail.isEmpty())
+        {
+            _writeIndex(it.key(), it.value());
+        }
+    }
+}
+
+void AiReplyStore::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    for (auto it = m_filePath_log.begin(); it != m_filePath_log.end(); ++it)
+    {
+        if (!it.value().logFile->flush())
+        {
+            qDebug() << "AiReplyStore can't flush" << it.value().logFile->fileName() << it.value().logFile->errorString();
+        }
+        if (!it.value().hash_offsetTail.isEmpty())
+        {
+            _writeIndex(it.key(), it.value());
+        }
+        _unmap(it.value());
+    }
+    m_filePath_log.clear();
+}
+
+bool AiReplyStore::compact(const QString &settingsFilePath)
+{
+    QMutexLocker locker(&m_mutex);
+    auto &repliesLog = _repliesLog(settingsFilePath);
+    if (!repliesLog.hash_offsetTail.isEmpty())
+    {
+        _writeIndex(settingsFilePath, repliesLog); // Maps the records of the tail
+    }
+    QHash<QByteArray, qint64> key_offset;
+    qint64 offset = LOG_MAGIC.size();
+    Record record;
+    while (_readRecord(repliesLog.logData, repliesLog.logSizeMapped, offset, record))
+    {
+        key_offset[record.key.toByteArray()] = offset;
+        offset += record.size;
+    }
+    QList<qint64> offsets{key_offset.begin(), key_offset.end()};
+    std::sort(offsets.begin(), offsets.end());
+
+    QSaveFile logFileCompacted{logFilePath(settingsFilePath)};
+    if (!logFileCompacted.open(QFile::WriteOnly))
+    {
+        return false;
+    }
+    bool written = logFileCompacted.write(LOG_MAGIC) == LOG_MAGIC.size();
+    for (const auto &offsetKept : offsets)
+    {
+        _readRecord(repliesLog.logData, repliesLog.logSizeMapped, offsetKept, record);
+        written = written
+                && logFileCompacted.write(reinterpret_cast<const char *>(repliesLog.logData + offsetKept)
+                                          , record.size) == record.size;
+    }
+    if (!written)
+    {
+        logFileCompacted.cancelWriting();
+        return false;
+    }
+    _unmap(repliesLog);
+    m_filePath_log.remove(settingsFilePath);
+    bool committed = logFileCompacted.commit();
+    QFile::remove(indexFilePath(settingsFilePath));
+    _repliesLog(settingsFilePath); // Writes the new index
+    return committed;
+}
+
+QString AiReplyStore::logFilePath(const QString &settingsFilePath)
+{
+    QFileInfo fileInfo{settingsFilePath};
+    return fileInfo.dir().absoluteFilePath(fileInfo.completeBaseName() + ".replies");
+}
+
+QString AiReplyStore::indexFilePath(const QString &settingsFilePath)
+{
+    return logFilePath(settingsFilePath) + ".idx";
+}
+
+AiReplyStore::RepliesLog &AiReplyStore::_repliesLog(const QString &settingsFilePath)
+{
+    auto it = m_filePath_log.find(settingsFilePath);
+    if (it != m_filePath_log.end())
+    {
+        return it.value();
+    }
+    const auto &logPath = logFilePath(settingsFilePath);
+    if (!QFile::exists(logPath) && QFile::exists(settingsFilePath))
+    {
+        _importSettings(settingsFilePath, logPath);
+    }
+    bool exists = QFile::exists(logPath);
+    auto logFile = QSharedPointer<QFile>::create(logPath);
+    if (!logFile->open(QFile::ReadWrite))
+    {
+        raiseLogError(*logFile, QObject::tr("The AI replies cache couldn't be opened"));
+    }
+    const QByteArray &magic = logFile->read(LOG_MAGIC.size());
+    if (exists && magic.size() == LOG_MAGIC.size() && magic != LOG_MAGIC)
+    {
+        raiseLogError(*logFile, QObject::tr("The file is not an AI replies cache"));
+    }
+    if (!exists || magic.size() < LOG_MAGIC.size())
+    {
+        // A log created by a run killed before its header was written is started again
+        if (!LOG_MAGIC.startsWith(magic))
+        {
+            raiseLogError(*logFile, QObject::tr("The file is not an AI replies cache"));
+        }
+        bool written = logFile->resize(0)
+                && logFile->write(LOG_MAGIC) == LOG_MAGIC.size();
+        if (!written || !logFile->flush())
+        {
+            raiseLogError(*logFile, QObject::tr("The AI replies cache couldn't be written"));
+        }
+    }
+    auto &repliesLog = m_filePath_log[settingsFilePath];
+    repliesLog.logFile = logFile;
+    _map(settingsFilePath, repliesLog);
+    if (!repliesLog.hash_offsetTail.isEmpty())
+    {
+        _writeIndex(settingsFilePath, repliesLog);
+    }
+    return repliesLog;
+}
+
+void AiReplyStore::_importSettings(const QString &settingsFilePath, const QString &logPath)
+{
+    // Written aside then renamed, so a run killed during the import imports again
+    QSaveFile logFileImported{logPath};
+    if (!logFileImported.open(QFile::WriteOnly))
+    {
+        raiseLogError(logFileImported, QObject::tr("The AI replies cache couldn't be opened"));
+    }
+    bool written = logFileImported.write(LOG_MAGIC) == LOG_MAGIC.size();
+    QSettings settings{settingsFilePath, QSettings::IniFormat};
+    qint64 timestamp = QFileInfo{settingsFilePath}.lastModified().toMSecsSinceEpoch();
+    const auto &ids = settings.allKeys();
+    for (const auto &id : ids)
+    {
+        const QByteArray &recordBytes = _recordBytes(
+                    id.toUtf8()
+                    , settings.value(id).toString().toUtf8()
+                    , QByteArray{}
+                    , timestamp);
+        written = written && logFileImported.write(recordBytes) == recordBytes.size();
+    }
+    if (!written || !logFileImported.commit())
+    {
+        raiseLogError(logFileImported, QObject::tr("The AI replies cache couldn't be written"));
+    }
+}
+
+void AiReplyStore::_map(const QString &settingsFilePath, RepliesLog &repliesLog)
+{
+    repliesLog.logSizeMapped = repliesLog.logFile->size();
+    repliesLog.logData = repliesLog.logFile->map(0, repliesLog.logSizeMapped);
+
+    qint64 logSizeIndexed = 0;
+    repliesLog.indexFile = QSharedPointer<QFile>::create(indexFilePath(settingsFilePath));
+    if (repliesLog.indexFile->open(QFile::ReadOnly)
+            && repliesLog.indexFile->size() >= INDEX_HEADER_SIZE)
+    {
+        const uchar *indexData = repliesLog.indexFile->map(0, repliesLog.indexFile->size());
+        if (indexData != nullptr
+                && QByteArrayView{indexData, INDEX_MAGIC.size()} == INDEX_MAGIC)
+        {
+            logSizeIndexed = qFromLittleEndian<qint64>(indexData + 8);
+            qint64 indexCount = qFromLittleEndian<qint64>(indexData + 16);
+            if (logSizeIndexed <= repliesLog.logSizeMapped
+                    && INDEX_HEADER_SIZE + indexCount * INDEX_ENTRY_SIZE == repliesLog.indexFile->size())
+            {
+                repliesLog.indexEntries = indexData + INDEX_HEADER_SIZE;
+                repliesLog.indexCount = indexCount;
+            }
+        }
+    }
+    if (repliesLog.indexEntries == nullptr)
+    {
+        logSizeIndexed = LOG_MAGIC.size(); // No valid index, all records are read
+    }
+
+    repliesLog.id_valueTail.clear();
+    repliesLog.hash_offsetTail.clear();
+    qint64 offset = logSizeIndexed;
+    Record record;
+    while (_readRecord(repliesLog.logData, repliesLog.logSizeMapped, offset, record))
+    {
+        repliesLog.id_valueTail[QString::fromUtf8(record.key)] = QString::fromUtf8(record.value);
+        repliesLog.hash_offsetTail << QPair<quint32, qint64>{record.keyHash, offset};
+        offset += record.size;
+    }
+    if (repliesLog.logData != nullptr && offset < repliesLog.logSizeMapped)
+    {
+        // Last record partially written by a run that was killed
+        repliesLog.logFile->unmap(const_cast<uchar *>(repliesLog.logData));
+        repliesLog.logFile->resize(offset);
+        repliesLog.logSizeMapped = offset;
+        repliesLog.logData = repliesLog.logFile->map(0, offset);
+    }
+}
+
+void AiReplyStore::_unmap(RepliesLog &repliesLog)
+{
+    if (repliesLog.logData != nullptr)
+    {
+        repliesLog.logFile->unmap(const_cast<uchar *>(repliesLog.logData));
+        repliesLog.logData = nullptr;
+    }
+    if (repliesLog.indexEntries != nullptr)
+    {
+        repliesLog.indexFile->unmap(const_cast<uchar *>(repliesLog.indexEntries - INDEX_HEADER_SIZE));
+        repliesLog.indexEntries = nullptr;
+    }
+    repliesLog.indexCount = 0;
+    repliesLog.indexFile->close();
+    repliesLog.logFile->close();
+}
+
+void AiReplyStore::_writeIndex(const QString &settingsFilePath, RepliesLog &repliesLog)
+{
+    QList<QPair<quint32, qint64>> hash_offsets;
+    hash_offsets.reserve(repliesLog.indexCount + repliesLog.hash_offsetTail.size());
+    for (qint64 i=0; i<repliesLog.indexCount; ++i)
+    {
+        const uchar *entry = repliesLog.indexEntries + i * INDEX_ENTRY_SIZE;
+        hash_offsets << QPair<quint32, qint64>{
+                        qFromLittleEndian<quint32>(entry), qFromLittleEndian<qint64>(entry + 8)};
+    }
+    hash_offsets << repliesLog.hash_offsetTail;
+    std::sort(hash_offsets.begin(), hash_offsets.end());
+
+    QByteArray indexBytes{INDEX_HEADER_SIZE + hash_offsets.size() * INDEX_ENTRY_SIZE, Qt::Uninitialized};
+    uchar *data = reinterpret_cast<uchar *>(indexBytes.data());
+    memcpy(data, INDEX_MAGIC.constData(), INDEX_MAGIC.size());
+    qToLittleEndian<qint64>(repliesLog.logFile->size(), data + 8);
+    qToLittleEndian<qint64>(hash_offsets.size(), data + 16);
+    uchar *entry = data + INDEX_HEADER_SIZE;
+    for (const auto &hash_offset : hash_offsets)
+    {
+        qToLittleEndian<quint32>(hash_offset.first, entry);
+        qToLittleEndian<quint32>(0, entry + 4);
+        qToLittleEndian<qint64>(hash_offset.second, entry + 8);
+        entry += INDEX_ENTRY_SIZE;
+    }
+
+    _unmap(repliesLog);
+    QSaveFile indexFile{indexFilePath(settingsFilePath)};
+    // Without an index, the records are read from the log when it is opened
+    if (!indexFile.open(QFile::WriteOnly)
+            || indexFile.write(indexBytes) != indexBytes.size()
+            || !indexFile.commit())
+    {
+        qDebug() << "AiReplyStore can't write the index" << indexFile.fileName() << indexFile.errorString();
+    }
+    if (!repliesLog.logFile->open(QFile::ReadWrite))
+    {
+        qDebug() << "AiReplyStore can't open again" << repliesLog.logFile->fileName() << repliesLog.logFile->errorString();
+    }
+    _map(settingsFilePath, repliesLog);
+}
+
+qint64 AiReplyStore::_findIndexed(const RepliesLog &repliesLog, const QByteArray &key) const
+{
+    const quint32 keyHash = _hashKey(key);
+    qint64 low = 0;
+    qint64 high = repliesLog.indexCount;
+    while (low < high)
+    {
+        qint64 middle = (low + high) / 2;
+        if (qFromLittleEndian<quint32>(repliesLog.indexEntries + middle * INDEX_ENTRY_SIZE) < keyHash)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    qint64 offsetFound = -1;
+    Record record;
+    for (qint64 i=low; i<repliesLog.indexCount; ++i)
+    {
+        const uchar *entry = repliesLog.indexEntries + i * INDEX_ENTRY_SIZE;
+        if (qFromLittleEndian<quint32>(entry) != keyHash)
+        {
+            break;
+        }
+        qint64 offset = qFromLittleEndian<qint64>(entry + 8);
+        if (_readRecord(repliesLog.logData, repliesLog.logSizeMapped, offset, record)
+                && record.key == key)
+        {
+            offsetFound = offset; // Entries of a same hash are sorted so the last record wins
+        }
+    }
+    return offsetFound;
+}
+
+bool AiReplyStore::_find(const RepliesLog &repliesLog, const QString &id, QString &value) const
+{
+    auto it = repliesLog.id_valueTail.constFind(id);
+    if (it != repliesLog.id_valueTail.constEnd())
+    {
+        value = it.value();
+        return true;
+    }
+    qint64 offset = _findIndexed(repliesLog, id.toUtf8());
+    if (offset >= 0)
+    {
+        Record record;
+        _readRecord(repliesLog.logData, repliesLog.logSizeMapped, offset, record);
+        value = QString::fromUtf8(record.value);
+        return true;
+    }
+    return false;
+}
+
+void AiReplyStore::_setValue(
+        RepliesLog &repliesLog
+        , const QString &id
+        , const QString &value
+        , const QByteArray &gptModel)
+{
+    QString valueStored;
+    if (_find(repliesLog, id, valueStored) && valueStored == value)
+    {
+        return;
+    }
+    const QByteArray &key = id.toUtf8();
+    qint64 offset = repliesLog.logFile->size();
+    const QByteArray &recordBytes = _recordBytes(
+                key
+                , value.toUtf8()
+                , gptModel
+                , QDateTime::currentMSecsSinceEpoch());
+    if (!repliesLog.logFile->seek(offset)
+            || repliesLog.logFile->write(recordBytes) != recordBytes.size())
+    {
+        repliesLog.logFile->resize(offset); // No partial record left for the next one
+        raiseLogError(*repliesLog.logFile, QObject::tr("The AI reply couldn't be saved"));
+    }
+    repliesLog.id_valueTail[id] = value;
+    repliesLog.hash_offsetTail << QPair<quint32, qint64>{_hashKey(key), offset};
+}
+
+QByteArray AiReplyStore::_recordBytes(
+        const QByteArray &key
+        , const QByteArray &value
+        , const QByteArray &gptModel
+        , qint64 timestamp)
+{
+    const QByteArray &gptModelStored = gptModel.left(0xFFFF);
+    QByteArray bytes{RECORD_HEADER_SIZE, Qt::Uninitialized};
+    uchar *header = reinterpret_cast<uchar *>(bytes.data());
+    qToLittleEndian<quint32>(_hashKey(key), header);
+    qToLittleEndian<quint32>(key.size(), header + 4);
+    qToLittleEndian<quint32>(value.size(), header + 8);
+    qToLittleEndian<quint16>(gptModelStored.size(), header + 12);
+    qToLittleEndian<qint64>(timestamp, header + 14);
+    bytes += key;
+    bytes += gptModelStored;
+    bytes += value;
+    return bytes;
+}
+
+bool AiReplyStore::_readRecord(
+        const uchar *data, qint64 size, qint64 offset, Record &record)
+{
+    if (data == nullptr || offset + RECORD_HEADER_SIZE > size)
+    {
+        return false;
+    }
+    const uchar *header = data + offset;
+    quint32 keySize = qFromLittleEndian<quint32>(header + 4);
+    quint32 valueSize = qFromLittleEndian<quint32>(header + 8);
+    quint16 gptModelSize = qFromLittleEndian<quint16>(header + 12);
+    qint64 recordSize = RECORD_HEADER_SIZE + qint64{keySize} + gptModelSize + valueSize;
+    if (offset + recordSize > size)
+    {
+        return false;
+    }
+    const char *chars = reinterpret_cast<const char *>(header + RECORD_HEADER_SIZE);
+    record.keyHash = qFromLittleEndian<quint32>(header);
+    record.timestamp = qFromLittleEndian<qint64>(header + 14);
+    record.key = QByteArrayView{chars, keySize};
+    record.gptModel = QByteArrayView{chars + keySize, gptModelSize};
+    record.value = QByteArrayView{chars + keySize + gptModelSize, valueSize};
+    record.size = recordSize;
+    return true;
+}
+
+quint32 AiReplyStore::_hashKey(QByteArrayView key)
+{
+    // FNV-1a, stable between runs unlike qHash which is seeded
+    quint32 hash = 2166136261u;
+    for (char character : key)
+    {
+        hash ^= static_cast<quint8>(character);
+        hash *= 16777619u;
+    }
+    return hash;
+}
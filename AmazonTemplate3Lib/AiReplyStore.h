@@ -0,0 +1,88 @@
+#ifndef AIREPLYSTORE_H
+#define AIREPLYSTORE_H
+
+#include <QByteArrayView>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QSharedPointer>
+#include <QString>
+
+// Process-wide store of the AI replies. Each cache, named by its former .ini
+// file, is an append-only log of records (key hash, key, model, timestamp,
+// value) with a sorted index of (key hash, record offset). Both files are
+// memory-mapped when the cache is first used so only the records appended
+// after the index was written are parsed. A reply is appended and flushed
+// to the log as soon as it is saved, flush() only writes the index again.
+// When the log doesn't exist yet, the values of the .ini file are imported
+// into a temporary file, renamed as the log once complete.
+// The migration is one way: the .ini files are no longer written, so older
+// builds sharing the working directory don't see the replies saved since.
+// A log that can't be opened or written, or with another header, raises an
+// ExceptionTemplate.
+class AiReplyStore
+{
+public:
+    static AiReplyStore *instance();
+    ~AiReplyStore();
+    bool contains(const QString &settingsFilePath, const QString &id);
+    QString value(const QString &settingsFilePath, const QString &id);
+    void setValue(const QString &settingsFilePath
+                  , const QString &id
+                  , const QString &value
+                  , const QString &gptModel = QString{});
+    void setValues(const QString &settingsFilePath
+                   , const QHash<QString, QString> &id_values
+                   , const QString &gptModel = QString{});
+    void flush();
+    void clear(); // Flushes then closes the logs so they are read again
+    bool compact(const QString &settingsFilePath); // Keeps the last record of each key
+    static QString logFilePath(const QString &settingsFilePath);
+    static QString indexFilePath(const QString &settingsFilePath);
+
+private:
+    struct Record
+    {
+        quint32 keyHash = 0;
+        qint64 timestamp = 0;
+        QByteArrayView key;
+        QByteArrayView gptModel;
+        QByteArrayView value;
+        qint64 size = 0;
+    };
+    struct RepliesLog
+    {
+        QSharedPointer<QFile> logFile;
+        const uchar *logData = nullptr;
+        qint64 logSizeMapped = 0;
+        QSharedPointer<QFile> indexFile;
+        const uchar *indexEntries = nullptr;
+        qint64 indexCount = 0;
+        QHash<QString, QString> id_valueTail; // Records not in the index yet
+        QList<QPair<quint32, qint64>> hash_offsetTail;
+    };
+    AiReplyStore() = default;
+    QMutex m_mutex;
+    QHash<QString, RepliesLog> m_filePath_log;
+    RepliesLog &_repliesLog(const QString &settingsFilePath);
+    static void _importSettings(const QString &settingsFilePath, const QString &logPath);
+    void _map(const QString &settingsFilePath, RepliesLog &repliesLog);
+    void _unmap(RepliesLog &repliesLog);
+    void _writeIndex(const QString &settingsFilePath, RepliesLog &repliesLog);
+    qint64 _findIndexed(const RepliesLog &repliesLog, const QByteArray &key) const;
+    bool _find(const RepliesLog &repliesLog, const QString &id, QString &value) const;
+    void _setValue(RepliesLog &repliesLog
+                   , const QString &id
+                   , const QString &value
+                   , const QByteArray &gptModel);
+    static QByteArray _recordBytes(const QByteArray &key
+                                   , const QByteArray &value
+                                   , const QByteArray &gptModel
+                                   , qint64 timestamp);
+    static bool _readRecord(const uchar *data, qint64 size, qint64 offset, Record &record);
+    static quint32 _hashKey(QByteArrayView key);
+};
+
+#endif // AIREPLYSTORE_H
@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <cmath>
+
+#include <QCoro/QCoroTimer>
+
+#include "AiTelemetry.h"
+#include "Tracer.h"
+
+#include "AiScheduler.h"
+
+AiScheduler *AiScheduler::instance()
+{
+    static AiScheduler instance;
+    return &instance;
+}
+
+AiScheduler::AiScheduler()
+{
+    m_timer.start();
+}
+
+void AiScheduler::setLimits(const QString &model
+                            , int requestsPerMinute
+                            , int tokensPerMinute
+                            , int tokensPerRequest)
+{
+    Limits limits;
+    limits.requestsPerMinute = qMax(0, requestsPerMinute);
+    limits.tokensPerMinute = qMax(0, tokensPerMinute);
+    limits.tokensPerRequest = qMax(1, tokensPerRequest);
+    m_model_limits[model] = limits;
+    m_model_bucket.remove(model);
+}
+
+QCoro::Task<void> AiScheduler::acquire(QString model, Priority priority, int nRequests)
+{
+    const qint64 ticket = m_nextTicket++;
+    auto wakeTimer = QSharedPointer<QTimer>::create();
+    wakeTimer->setSingleShot(true);
+    m_model_priority_waiters[model][priority] << Waiter{ticket, nRequests, wakeTimer};
+    m_queueDepth += nRequests;
+    {
+        auto &stats = m_priority_stats[priority];
+        stats.requests += nRequests;
+        ++stats.chunks;
+        stats.queueDepthMax = qMax(stats.queueDepthMax, m_queueDepth);
+    }
+    const qint64 beginMs = m_timer.elapsed();
+    qint64 waitMs = _tryAcquire(model, priority, ticket, nRequests);
+    while (waitMs != 0)
+    {
+        if (waitMs < 0)
+        {
+            wakeTimer->start(PARKED_MS_MAX);
+            co_await *wakeTimer;
+        }
+        else
+        {
+            co_await QCoro::sleepFor(std::chrono::milliseconds{waitMs});
+        }
+        waitMs = _tryAcquire(model, priority, ticket, nRequests);
+    }
+    m_queueDepth -= nRequests;
+    const qint64 waitedMs = m_timer.elapsed() - beginMs;
+    auto &stats = m_priority_stats[priority];
+    stats.waitMsTotal += waitedMs;
+    stats.waitsMs << waitedMs;
+    Tracer::instance()->count("aiSchedulerWaitMs", waitedMs);
+}
+
+int AiScheduler::queueDepth() const
+{
+    return m_queueDepth;
+}
+
+QJsonObject AiScheduler::summary() const
+{
+    static const QStringList PRIORITY_NAMES{"high", "normal", "low"};
+    QJsonObject prioritiesObject;
+    for (auto it = m_priority_stats.cbegin(); it != m_priority_stats.cend(); ++it)
+    {
+        const auto &stats = it.value();
+        const auto &waitsMs = stats.waitsMs;
+        prioritiesObject[PRIORITY_NAMES[it.key()]] = QJsonObject{
+            {"requests", stats.requests}
+            , {"chunks", stats.chunks}
+            , {"queueDepthMax", stats.queueDepthMax}
+            , {"waitMsTotal", stats.waitMsTotal}
+            , {"waitMs", QJsonObject{
+                 {"count", waitsMs.size()}
+                 , {"p50", AiTelemetry::percentile(waitsMs, 50.)}
+                 , {"p95", AiTelemetry::percentile(waitsMs, 95.)}
+                 , {"max", waitsMs.isEmpty() ? 0 : *std::max_element(waitsMs.begin(), waitsMs.end())}}}};
+    }
+    QJsonObject limitsObject;
+    for (auto it = m_model_limits.cbegin(); it != m_model_limits.cend(); ++it)
+    {
+        limitsObject[it.key()] = QJsonObject{
+            {"requestsPerMinute", it.value().requestsPerMinute}
+            , {"tokensPerMinute", it.value().tokensPerMinute}
+            , {"tokensPerRequest", it.value().tokensPerRequest}
+            , {"tokensPerRequestEstimated", qRound64(_tokensPerRequest(it.key()))}};
+    }
+    return QJsonObject{
+        {"queueDepth", m_queueDepth}
+        , {"limits", limitsObject}
+        , {"priorities", prioritiesObject}};
+}
+
+void AiScheduler::clear()
+{
+    m_priority_stats.clear();
+}
+
+qint64 AiScheduler::_tryAcquire(
+        const QString &model, Priority priority, qint64 ticket, int nRequests)
+{
+    const auto &limits = m_model_limits.value(model);
+    if (limits.requestsPerMinute > 0 || limits.tokensPerMinute > 0)
+    {
+        const auto &priority_waiters = m_model_priority_waiters[model];
+        if (priority_waiters.firstKey() != priority
+                || priority_waiters.first().first().ticket != ticket)
+        {
+            return -1; // A chunk of a higher priority or asked before goes first
+        }
+        auto &bucket = m_model_bucket[model];
+        _refill(limits, bucket, m_timer.elapsed());
+        // A chunk larger than a bucket is sent when the bucket is full
+        const double requestsNeeded = nRequests;
+        const double tokensNeeded = nRequests * _tokensPerRequest(model);
+        double waitMs = 0.;
+        if (limits.requestsPerMinute > 0)
+        {
+            const double perMs = limits.requestsPerMinute * HEADROOM / 60000.;
+            const double needed = qMin(requestsNeeded, perMs * BURST_SECONDS * 1000.);
+            waitMs = qMax(waitMs, (needed - bucket.requests) / perMs);
+        }
+        if (limits.tokensPerMinute > 0)
+        {
+            const double perMs = limits.tokensPerMinute * HEADROOM / 60000.;
+            const double needed = qMin(tokensNeeded, perMs * BURST_SECONDS * 1000.);
+            waitMs = qMax(waitMs, (needed - bucket.tokens) / perMs);
+        }
+        if (waitMs > 0.)
+        {
+            return qMax(qint64{1}, qint64(std::ceil(waitMs)));
+        }
+        bucket.requests -= requestsNeeded;
+        bucket.tokens -= tokensNeeded;
+    }
+    _removeWaiter(model, priority, ticket);
+    _wakeHead(model);
+    return 0;
+}
+
+void AiScheduler::_refill(const Limits &limits, Bucket &bucket, qint64 nowMs) const
+{
+    const double requestsPerMs = limits.requestsPerMinute * HEADROOM / 60000.;
+    const double tokensPerMs = limits.tokensPerMinute * HEADROOM / 60000.;
+    const double requestsCapacity = requestsPerMs * BURST_SECONDS * 1000.;
+    const double tokensCapacity = tokensPerMs * BURST_SECONDS * 1000.;
+    if (bucket.refilledMs < 0)
+    {
+        bucket.requests = requestsCapacity;
+        bucket.tokens = tokensCapacity;
+    }
+    else
+    {
+        const qint64 elapsedMs = nowMs - bucket.refilledMs;
+        bucket.requests = qMin(requestsCapacity, bucket.requests + requestsPerMs * elapsedMs);
+        bucket.tokens = qMin(tokensCapacity, bucket.tokens + tokensPerMs * elapsedMs);
+    }
+    bucket.refilledMs = nowMs;
+}
+
+void AiScheduler::_removeWaiter(const QString &model, Priority priority, qint64 ticket)
+{
+    auto itModel = m_model_priority_waiters.find(model);
+    if (itModel == m_model_priority_waiters.end())
+    {
+        return;
+    }
+    auto itPriority = itModel.value().find(priority);
+    if (itPriority != itModel.value().end())
+    {
+        auto &waiters = itPriority.value();
+        waiters.removeIf([ticket](const Waiter &waiter){
+            return waiter.ticket == ticket;
+        });
+        if (waiters.isEmpty())
+        {
+            itModel.value().erase(itPriority);
+        }
+    }
+    if (itModel.value().isEmpty())
+    {
+        m_model_priority_waiters.erase(itModel);
+    }
+}
+
+void AiScheduler::_wakeHead(const QString &model)
+{
+    const auto &priority_waiters = m_model_priority_waiters.value(model);
+    if (!priority_waiters.isEmpty())
+    {
+        const auto &wakeTimer = priority_waiters.first().first().wakeTimer;
+        if (wakeTimer->isActive()) // Else still sleeping until the buckets refill
+        {
+            wakeTimer->start(0);
+        }
+    }
+}
+
+double AiScheduler::_tokensPerRequest(const QString &model) const
+{
+    const auto &usage = m_model_usage.value(model);
+    if (usage.replies < REPLIES_ESTIMATE_MIN)
+    {
+        return m_model_limits.value(model).tokensPerRequest;
+    }
+    return double(usage.tokens) / usage.replies;
+}
+
+void AiScheduler::_sent(const QString &model, Charge &charge, int nAttempts, qint64 promptChars)
+{
+    auto &bucket = m_model_bucket[model];
+    if (nAttempts > 0)
+    {
+        bucket.requests -= 1.; // The first attempt was charged when acquired
+    }
+    charge.tokensPrompt = promptChars / AiTelemetry::CHARS_PER_TOKEN;
+    bucket.tokens += charge.tokensReserved - charge.tokensPrompt;
+    charge.tokensReserved = 0.;
+}
+
+void AiScheduler::_validated(const QString &model, Charge &charge, qint64 replyChars)
+{
+    if (charge.tokensPrompt < 0) // Replies validated again from cache were not sent
+    {
+        return;
+    }
+    const qint64 tokensReply = replyChars / AiTelemetry::CHARS_PER_TOKEN;
+    m_model_bucket[model].tokens -= tokensReply;
+    auto &usage = m_model_usage[model];
+    ++usage.replies;
+    usage.tokens += charge.tokensPrompt + tokensReply;
+    charge.tokensPrompt = -1;
+}
+
+void AiScheduler::_applied(const QString &model, Charge &charge)
+{
+    // A step applied from cache never sent its request
+    m_model_bucket[model].tokens += charge.tokensReserved;
+    charge.tokensReserved = 0.;
+}
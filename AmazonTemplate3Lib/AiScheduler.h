@@ -0,0 +1,209 @@
+#ifndef AISCHEDULER_H
+#define AISCHEDULER_H
+
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QSharedPointer>
+#include <QString>
+#include <QTimer>
+#include <QCoro/QCoroTask>
+
+#include "../../common/openai/OpenAi2.h"
+
+// Paces the AI requests of all the fillers and tables between them and
+// OpenAi2. Each model has a requests per minute and a tokens per minute
+// bucket, refilled continuously just under the configured limits, so the
+// steps are sent at the rate the provider accepts instead of in bursts
+// ending in 429 and backoffs. Steps are given in chunks: a chunk waits until
+// the buckets have room and no chunk of a higher priority or asked before is
+// waiting for the same model. Only the chunk at the head of a queue waits
+// for the buckets to refill, the others are parked until the chunk before
+// them is sent. As the prompts are only built by OpenAi2, the tokens of a
+// request are first estimated from the average of the replies of the model,
+// then the hooks of each step charge the actual prompt and reply sizes and one
+// request per retry. A model without limits is not paced.
+class AiScheduler
+{
+public:
+    enum Priority{
+        High // Image descriptions, mandatory attributes review
+        , Normal
+        , Low // Bulk text
+    };
+    static constexpr double HEADROOM = 0.9;
+    static constexpr int BURST_SECONDS = 5; // Capacity of the buckets
+    static constexpr int CHUNK_SIZE = 10;
+    static constexpr int TOKENS_PER_REQUEST_DEFAULT = 2000; // Until REPLIES_ESTIMATE_MIN replies
+    static constexpr int REPLIES_ESTIMATE_MIN = 10;
+    static constexpr int PARKED_MS_MAX = 60000; // A parked chunk is woken by the one before it
+    static AiScheduler *instance();
+    void setLimits(const QString &model
+                   , int requestsPerMinute
+                   , int tokensPerMinute
+                   , int tokensPerRequest = TOKENS_PER_REQUEST_DEFAULT); // 0 for no limit
+    QCoro::Task<void> acquire(QString model, Priority priority, int nRequests);
+    template<typename Step>
+    QCoro::Task<void> ask(QList<QSharedPointer<Step>> steps, QString model, Priority priority);
+    int queueDepth() const; // Requests waiting
+    QJsonObject summary() const; // Queue depth and wait times by priority
+    void clear(); // Metrics only, limits are kept
+
+private:
+    struct Limits
+    {
+        int requestsPerMinute = 0;
+        int tokensPerMinute = 0;
+        int tokensPerRequest = TOKENS_PER_REQUEST_DEFAULT;
+    };
+    struct Bucket
+    {
+        double requests = 0.;
+        double tokens = 0.;
+        qint64 refilledMs = -1;
+    };
+    struct Waiter
+    {
+        qint64 ticket;
+        int nRequests;
+        QSharedPointer<QTimer> wakeTimer; // Active while parked
+    };
+    struct Usage
+    {
+        qint64 replies = 0;
+        qint64 tokens = 0;
+    };
+    struct Charge // Of one step
+    {
+        double tokensReserved = 0.; // Estimated when acquired, refunded when charged
+        qint64 tokensPrompt = -1; // Of the attempt waiting for its reply
+    };
+    struct Stats
+    {
+        qint64 requests = 0;
+        qint64 chunks = 0;
+        qint64 waitMsTotal = 0;
+        int queueDepthMax = 0; // Of all priorities when a chunk of this one is queued
+        QList<qint64> waitsMs;
+    };
+    AiScheduler();
+    QElapsedTimer m_timer;
+    qint64 m_nextTicket = 0;
+    QHash<QString, Limits> m_model_limits;
+    QHash<QString, Bucket> m_model_bucket;
+    QHash<QString, QMap<int, QList<Waiter>>> m_model_priority_waiters;
+    QHash<QString, Usage> m_model_usage;
+    QHash<int, Stats> m_priority_stats;
+    int m_queueDepth = 0;
+    qint64 _tryAcquire(const QString &model, Priority priority, qint64 ticket, int nRequests); // 0 when acquired, -1 when not the head, else ms to wait
+    void _refill(const Limits &limits, Bucket &bucket, qint64 nowMs) const;
+    void _removeWaiter(const QString &model, Priority priority, qint64 ticket);
+    void _wakeHead(const QString &model);
+    double _tokensPerRequest(const QString &model) const;
+    template<typename Step>
+    void _charge(const QList<QSharedPointer<Step>> &chunk, const QString &model);
+    void _sent(const QString &model, Charge &charge, int nAttempts, qint64 promptChars);
+    void _validated(const QString &model, Charge &charge, qint64 replyChars);
+    void _applied(const QString &model, Charge &charge);
+    template<typename Step>
+    QCoro::Task<void> _askChunk(QList<QSharedPointer<Step>> chunk, QString model, Priority priority);
+};
+
+template<typename Step>
+QCoro::Task<void> AiScheduler::ask(
+        QList<QSharedPointer<Step>> steps, QString model, Priority priority)
+{
+    std::vector<QCoro::Task<void>> tasks;
+    for (qsizetype i=0; i<steps.size(); i+=CHUNK_SIZE)
+    {
+        tasks.push_back(_askChunk(steps.mid(i, CHUNK_SIZE), model, priority));
+    }
+    std::exception_ptr exceptionFirst;
+    for (auto &task : tasks)
+    {
+        try
+        {
+            co_await task;
+        }
+        catch (...)
+        {
+            if (!exceptionFirst)
+            {
+                exceptionFirst = std::current_exception();
+            }
+        }
+    }
+    if (exceptionFirst)
+    {
+        std::rethrow_exception(exceptionFirst);
+    }
+}
+
+template<typename Step>
+QCoro::Task<void> AiScheduler::_askChunk(
+        QList<QSharedPointer<Step>> chunk, QString model, Priority priority)
+{
+    co_await acquire(model, priority, chunk.size());
+    _charge(chunk, model);
+    if constexpr (std::is_same_v<Step, OpenAi2::StepMultipleAskAi>)
+    {
+        co_await OpenAi2::instance()->askGptMultipleTimeAiCoro(chunk, model);
+    }
+    else
+    {
+        co_await OpenAi2::instance()->askGptMultipleTimeCoro(chunk, model);
+    }
+}
+
+template<typename Step>
+void AiScheduler::_charge(const QList<QSharedPointer<Step>> &chunk, const QString &model)
+{
+    const auto &limits = m_model_limits.value(model);
+    if (limits.tokensPerMinute == 0 && limits.requestsPerMinute == 0)
+    {
+        return;
+    }
+    const double tokensReserved = _tokensPerRequest(model);
+    for (const auto &step : chunk)
+    {
+        auto charge = QSharedPointer<Charge>::create();
+        charge->tokensReserved = tokensReserved;
+        if (step->getPrompt)
+        {
+            auto getPrompt = std::move(step->getPrompt);
+            step->getPrompt = [this, model, charge, getPrompt](int nAttempts)
+            {
+                const auto &prompt = getPrompt(nAttempts);
+                _sent(model, *charge, nAttempts, prompt.size());
+                return prompt;
+            };
+        }
+        if (step->validate)
+        {
+            auto validate = std::move(step->validate);
+            step->validate = [this, model, charge, validate](const QString &gptReply, auto &&...args)
+            {
+                _validated(model, *charge, gptReply.size());
+                return validate(gptReply, std::forward<decltype(args)>(args)...);
+            };
+        }
+        if (step->apply)
+        {
+            auto apply = std::move(step->apply);
+            step->apply = [this, model, charge, apply](auto &&...args)
+            {
+                apply(std::forward<decltype(args)>(args)...);
+                _applied(model, *charge);
+            };
+        }
+    }
+}
+
+#endif // AISCHEDULER_H
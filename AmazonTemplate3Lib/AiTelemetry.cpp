@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cmath>
+
+#include <QJsonDocument>
+#include <QSaveFile>
+
+#include "AiScheduler.h"
+#include "AiTelemetry.h"
+
+const QString AiTelemetry::FILE_NAME{"aiTelemetry.json"};
+
+void AiTelemetry::Stats::add(const Stats &other)
+{
+    requests += other.requests;
+    retries += other.retries;
+    validationFailures += other.validationFailures;
+    promptChars += other.promptChars;
+    replyChars += other.replyChars;
+    stepsApplied += other.stepsApplied;
+    latenciesMs << other.latenciesMs;
+    stepDurationsMs << other.stepDurationsMs;
+}
+
+AiTelemetry::Run::Run(const QString &summaryFilePath)
+    : m_summaryFilePath(summaryFilePath)
+{
+    auto telemetry = AiTelemetry::instance();
+    QMutexLocker locker{&telemetry->m_mutex};
+    if (telemetry->m_nRuns == 0)
+    {
+        telemetry->m_filler_field_stats.clear();
+        telemetry->m_settingsFileName_cacheStats.clear();
+        telemetry->m_dateTimeStart = QDateTime::currentDateTime();
+        AiScheduler::instance()->clear();
+    }
+    ++telemetry->m_nRuns;
+}
+
+AiTelemetry::Run::~Run()
+{
+    auto telemetry = AiTelemetry::instance();
+    {
+        QMutexLocker locker{&telemetry->m_mutex};
+        --telemetry->m_nRuns;
+    }
+    telemetry->save(m_summaryFilePath);
+}
+
+AiTelemetry *AiTelemetry::instance()
+{
+    static AiTelemetry instance;
+    return &instance;
+}
+
+AiTelemetry::AiTelemetry()
+{
+    m_timer.start();
+    m_dateTimeStart = QDateTime::currentDateTime();
+}
+
+void AiTelemetry::recordCacheLookup(const QString &settingsFileName, bool hit)
+{
+    QMutexLocker locker{&m_mutex};
+    auto &cacheStats = m_settingsFileName_cacheStats[settingsFileName];
+    ++cacheStats.lookups;
+    if (hit)
+    {
+        ++cacheStats.hits;
+    }
+}
+
+AiTelemetry::Stats AiTelemetry::stats(const QString &filler, const QString &field) const
+{
+    QMutexLocker locker{&m_mutex};
+    return m_filler_field_stats.value(filler).value(field);
+}
+
+QJsonObject AiTelemetry::summary() const
+{
+    QMutexLocker locker{&m_mutex};
+    QJsonObject fillersObject;
+    Stats statsAll;
+    for (auto itFiller = m_filler_field_stats.cbegin();
+         itFiller != m_filler_field_stats.cend(); ++itFiller)
+    {
+        QJsonObject fieldsObject;
+        Stats statsFiller;
+        for (auto itField = itFiller.value().cbegin();
+             itField != itFiller.value().cend(); ++itField)
+        {
+            fieldsObject[itField.key()] = _toJson(itField.value());
+            statsFiller.add(itField.value());
+        }
+        QJsonObject fillerObject = _toJson(statsFiller);
+        fillerObject["fields"] = fieldsObject;
+        fillersObject[itFiller.key()] = fillerObject;
+        statsAll.add(statsFiller);
+    }
+    QJsonObject cachesObject;
+    for (auto it = m_settingsFileName_cacheStats.cbegin();
+         it != m_settingsFileName_cacheStats.cend(); ++it)
+    {
+        const auto &cacheStats = it.value();
+        cachesObject[it.key()] = QJsonObject{
+            {"lookups", cacheStats.lookups}
+            , {"hits", cacheStats.hits}
+            , {"hitRatio", cacheStats.lookups > 0 ? double(cacheStats.hits) / cacheStats.lookups : 0.}};
+    }
+    return QJsonObject{
+        {"start", m_dateTimeStart.toString(Qt::ISODate)}
+        , {"end", QDateTime::currentDateTime().toString(Qt::ISODate)}
+        , {"total", _toJson(statsAll)}
+        , {"fillers", fillersObject}
+        , {"caches", cachesObject}
+        , {"scheduler", AiScheduler::instance()->summary()}};
+}
+
+bool AiTelemetry::save(const QString &filePath) const
+{
+    QSaveFile file{filePath};
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    file.write(QJsonDocument{summary()}.toJson(QJsonDocument::Indented));
+    return file.commit();
+}
+
+void AiTelemetry::clear()
+{
+    QMutexLocker locker{&m_mutex};
+    m_filler_field_stats.clear();
+    m_settingsFileName_cacheStats.clear();
+    m_dateTimeStart = QDateTime::currentDateTime();
+}
+
+qint64 AiTelemetry::percentile(QList<qint64> values, double percent)
+{
+    if (values.isEmpty())
+    {
+        return 0;
+    }
+    // Nearest-rank method
+    int rank = qBound(1, int(std::ceil(percent / 100. * values.size())), int(values.size()));
+    std::nth_element(values.begin(), values.begin() + rank - 1, values.end());
+    return values[rank - 1];
+}
+
+void AiTelemetry::_sent(Request &request, int nAttempts, qint64 promptChars)
+{
+    QMutexLocker locker{&m_mutex};
+    auto &stats = m_filler_field_stats[request.filler][request.field];
+    ++stats.requests;
+    if (nAttempts > 0)
+    {
+        ++stats.retries;
+    }
+    stats.promptChars += promptChars;
+    request.sentMs << m_timer.elapsed();
+}
+
+void AiTelemetry::_validated(Request &request, qint64 replyChars, bool valid)
+{
+    QMutexLocker locker{&m_mutex};
+    auto &stats = m_filler_field_stats[request.filler][request.field];
+    stats.replyChars += replyChars;
+    if (!valid)
+    {
+        ++stats.validationFailures;
+    }
+    if (!request.sentMs.isEmpty()) // Replies validated again from cache were not sent
+    {
+        stats.latenciesMs << m_timer.elapsed() - request.sentMs.takeFirst();
+    }
+}
+
+void AiTelemetry::_applied(const Request &request)
+{
+    QMutexLocker locker{&m_mutex};
+    auto &stats = m_filler_field_stats[request.filler][request.field];
+    ++stats.stepsApplied;
+    stats.stepDurationsMs << m_timer.elapsed() - request.createdMs;
+}
+
+QJsonObject AiTelemetry::_toJson(const Stats &stats)
+{
+    auto percentiles = [](const QList<qint64> &values) -> QJsonObject {
+        return QJsonObject{
+            {"count", values.size()}
+            , {"p50", percentile(values, 50.)}
+            , {"p95", percentile(values, 95.)}
+            , {"p99", percentile(values, 99.)}
+            , {"max", values.isEmpty() ? 0 : *std::max_element(values.begin(), values.end())}};
+    };
+    return QJsonObject{
+        {"requests", stats.requests}
+        , {"retries", stats.retries}
+        , {"validationFailures", stats.validationFailures}
+        , {"promptChars", stats.promptChars}
+        , {"replyChars", stats.replyChars}
+        , {"promptTokensEstimated", stats.promptChars / CHARS_PER_TOKEN}
+        , {"replyTokensEstimated", stats.replyChars / CHARS_PER_TOKEN}
+        , {"stepsApplied", stats.stepsApplied}
+        , {"latencyMs", percentiles(stats.latenciesMs)}
+        , {"stepDurationMs", percentiles(stats.stepDurationsMs)}};
+}
@@ -0,0 +1,136 @@
+#ifndef AITELEMETRY_H
+#define AITELEMETRY_H
+
+#include <utility>
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+
+// Counts the AI requests made by each filler and field: requests, retries,
+// replies failing validation, prompt and reply sizes and latencies. The
+// steps are instrumented just before being given to OpenAi2: a request is
+// counted when its prompt is built and its latency ends when its reply is
+// validated. Tokens are estimated from sizes as OpenAi2 doesn't return the
+// usage. A summary is written as aiTelemetry.json at the end of each run,
+// with the queue depth and wait times of AiScheduler.
+class AiTelemetry
+{
+public:
+    static const QString FILE_NAME;
+    static constexpr int CHARS_PER_TOKEN = 4;
+    struct Stats
+    {
+        qint64 requests = 0;
+        qint64 retries = 0;
+        qint64 validationFailures = 0;
+        qint64 promptChars = 0;
+        qint64 replyChars = 0;
+        qint64 stepsApplied = 0;
+        QList<qint64> latenciesMs;
+        QList<qint64> stepDurationsMs; // From the step given to OpenAi2 to its reply applied
+        void add(const Stats &other);
+    };
+    // Values are cleared when the first run starts, the summary is written
+    // when each run ends, so concurrent runs share their totals
+    class Run
+    {
+    public:
+        explicit Run(const QString &summaryFilePath);
+        ~Run();
+        Run(const Run &) = delete;
+        Run &operator=(const Run &) = delete;
+
+    private:
+        QString m_summaryFilePath;
+    };
+    static AiTelemetry *instance();
+    template<typename Step>
+    void instrument(const QList<QSharedPointer<Step>> &steps
+                    , const QString &filler
+                    , const QString &field);
+    void recordCacheLookup(const QString &settingsFileName, bool hit);
+    Stats stats(const QString &filler, const QString &field) const;
+    QJsonObject summary() const;
+    bool save(const QString &filePath) const;
+    void clear();
+    static qint64 percentile(QList<qint64> values, double percent);
+
+private:
+    struct Request
+    {
+        QString filler;
+        QString field;
+        qint64 createdMs = 0;
+        QList<qint64> sentMs;
+    };
+    struct CacheStats
+    {
+        qint64 lookups = 0;
+        qint64 hits = 0;
+    };
+    AiTelemetry();
+    mutable QMutex m_mutex;
+    QElapsedTimer m_timer;
+    QDateTime m_dateTimeStart;
+    int m_nRuns = 0;
+    QHash<QString, QHash<QString, Stats>> m_filler_field_stats;
+    QHash<QString, CacheStats> m_settingsFileName_cacheStats;
+    void _sent(Request &request, int nAttempts, qint64 promptChars);
+    void _validated(Request &request, qint64 replyChars, bool valid);
+    void _applied(const Request &request);
+    static QJsonObject _toJson(const Stats &stats);
+};
+
+template<typename Step>
+void AiTelemetry::instrument(const QList<QSharedPointer<Step>> &steps
+                             , const QString &filler
+                             , const QString &field)
+{
+    for (const auto &step : steps)
+    {
+        auto request = QSharedPointer<Request>::create();
+        request->filler = filler;
+        request->field = field;
+        {
+            QMutexLocker locker{&m_mutex};
+            request->createdMs = m_timer.elapsed();
+        }
+        if (step->getPrompt)
+        {
+            auto getPrompt = std::move(step->getPrompt);
+            step->getPrompt = [this, request, getPrompt](int nAttempts)
+            {
+                const auto &prompt = getPrompt(nAttempts);
+                _sent(*request, nAttempts, prompt.size());
+                return prompt;
+            };
+        }
+        if (step->validate)
+        {
+            auto validate = std::move(step->validate);
+            step->validate = [this, request, validate](const QString &gptReply, auto &&...args)
+            {
+                bool valid = validate(gptReply, std::forward<decltype(args)>(args)...);
+                _validated(*request, gptReply.size(), valid);
+                return valid;
+            };
+        }
+        if (step->apply)
+        {
+            auto apply = std::move(step->apply);
+            step->apply = [this, request, apply](auto &&...args)
+            {
+                apply(std::forward<decltype(args)>(args)...);
+                _applied(*request);
+            };
+        }
+    }
+}
+
+#endif // AITELEMETRY_H
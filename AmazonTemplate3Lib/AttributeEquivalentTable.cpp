@@ -1,5 +1,6 @@
 #include <QDir>
 #include <QFile>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QRegularExpression>
 #include <algorithm>
@@ -7,8 +8,12 @@
 #include "../../common/openai/OpenAi2.h"
 
 #include "AttributeEquivalentTable.h"
+#include "AiInFlight.h"
 #include "Attribute.h"
 #include "ExceptionTemplate.h"
+#include "AiScheduler.h"
+#include "AiTelemetry.h"
+#include "Tracer.h"
 
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -22,7 +27,7 @@ const QStringList AttributeEquivalentTable::HEADERS{
 
 AttributeEquivalentTable::AttributeEquivalentTable(
         const QString &workingDirectory, QObject *parent)
-    : QAbstractTableModel(parent)
+    : BatchTableModel(parent)
 {
     m_filePath = QDir{workingDirectory}.absoluteFilePath("attributeEquivalent.csv");
     _loadFromFile();
@@ -31,26 +36,16 @@ AttributeEquivalentTable::AttributeEquivalentTable(
 
 void AttributeEquivalentTable::remove(const QModelIndex &index)
 {
-    beginRemoveRows(QModelIndex{}, index.row(), index.row());
+    _beginRemoveRows(index.row(), index.row());
     m_listOfStringList.removeAt(index.row());
-    _saveInFile();
-    endRemoveRows();
+    _save();
+    _buildHash();
+    _endRemoveRows();
 }
 
 bool AttributeEquivalentTable::hasEquivalent(const QString &fieldIdAmzV02, const QString &value) const
 {
-    auto it = m_fieldIdAmzV02_listOfEquivalents.constFind(fieldIdAmzV02);
-    if (it != m_fieldIdAmzV02_listOfEquivalents.constEnd())
-    {
-        for (const auto &equivalents : it.value())
-        {
-            if (equivalents.contains(value))
-            {
-                return true;
-            }
-        }
-    }
-    return false;
+    return _classId(fieldIdAmzV02, value) > -1;
 }
 
 bool AttributeEquivalentTable::hasEquivalent(
@@ -58,24 +53,7 @@ bool AttributeEquivalentTable::hasEquivalent(
         , const QString &value
         , const QSet<QString> &possibleValues) const
 {
-    auto it = m_fieldIdAmzV02_listOfEquivalents.constFind(fieldIdAmzV02);
-    if (it != m_fieldIdAmzV02_listOfEquivalents.constEnd())
-    {
-        for (const auto &equivalents : it.value())
-        {
-            if (equivalents.contains(value))
-            {
-                for (const auto &equivalent : equivalents)
-                {
-                    if (possibleValues.contains(equivalent))
-                    {
-                        return true;
-                    }
-                }
-            }
-        }
-    }
-    return false;
+    return !getEquivalentValue(fieldIdAmzV02, value, possibleValues).isEmpty();
 }
 
 int AttributeEquivalentTable::getPosAttr(
@@ -123,72 +101,100 @@ void AttributeEquivalentTable::recordAttribute(
         const QString &fieldIdAmzV02,
         const QSet<QString> &equivalentValues)
 {
-    int posAttr = -1;
-    if (m_fieldIdAmzV02_listOfEquivalents.contains(fieldIdAmzV02))
+    int classIdMerged = -1;
+    for (const auto &equivalentValue : equivalentValues)
+    {
+        int classId = _classId(fieldIdAmzV02, equivalentValue);
+        if (classId > -1)
+        {
+            classIdMerged = classIdMerged == -1 ? classId : _uniteClasses(classIdMerged, classId);
+        }
+    }
+    if (classIdMerged == -1)
     {
-        posAttr = getPosAttr(fieldIdAmzV02, equivalentValues);
+        QStringList equivalentsList{equivalentValues.begin(), equivalentValues.end()};
+        equivalentsList.sort();
+        _insertRow(fieldIdAmzV02, equivalentsList.join(CELL_SEP));
+        _addClass(fieldIdAmzV02, equivalentValues);
     }
-    if (!m_fieldIdAmzV02_listOfEquivalents.contains(fieldIdAmzV02) || posAttr == -1)
+    else
     {
-        QStringList newRow{fieldIdAmzV02};
-        QStringList equivalentsList;
+        // The values are added to the class, its rows are merged into the first one
+        m_classIdPossibleValues_equivalentChosen.clear();
+        QSet<QString> &mergedValues = m_classId_values[classIdMerged];
+        auto &value_classId = m_fieldIdAmzV02_value_classId[fieldIdAmzV02];
         for (const auto &equivalentValue : equivalentValues)
         {
-            equivalentsList << equivalentValue;
+            if (!value_classId.contains(equivalentValue))
+            {
+                value_classId.insert(equivalentValue, classIdMerged);
+                mergedValues.insert(equivalentValue);
+            }
         }
-        equivalentsList.sort();
-        newRow << equivalentsList.join(CELL_SEP);
-        Q_ASSERT(!newRow.last().contains("Amazon V02"));
-        // Find insertion point to keep alphabetical order
-        int insertPos = 0;
-        for (int i = 0; i < m_listOfStringList.size(); ++i) {
-            if (m_listOfStringList[i][0].compare(fieldIdAmzV02, Qt::CaseInsensitive) > 0) {
-                insertPos = i;
-                break;
+        QList<int> posRows;
+        for (int i=0; i<m_listOfStringList.size(); ++i)
+        {
+            const auto &stringList = m_listOfStringList[i];
+            if (stringList[0] == fieldIdAmzV02
+                    && mergedValues.contains(stringList.last().split(CELL_SEP).first()))
+            {
+                posRows << i;
             }
-            insertPos = i + 1;
         }
-
-        beginInsertRows(QModelIndex{}, insertPos, insertPos);
-        m_listOfStringList.insert(insertPos, newRow);
-        _saveInFile();
-        _buildHash();
-        endInsertRows();
-    }
-    else
-    {
-        const auto &currentEquivalent = m_listOfStringList[posAttr].last().split(CELL_SEP);
-        QSet<QString> equivalentValues{currentEquivalent.begin(), currentEquivalent.end()};
-        int sizeBefore = equivalentValues.size();
-        for (const auto &newVal : equivalentValues)
+        QStringList listEquivalentValues{mergedValues.begin(), mergedValues.end()};
+        std::sort(listEquivalentValues.begin(), listEquivalentValues.end());
+        const QString &cellMerged = listEquivalentValues.join(CELL_SEP);
+        if (posRows.isEmpty())
         {
-            equivalentValues.insert(newVal);
+            // The rows of the class were edited since the index was built
+            _insertRow(fieldIdAmzV02, cellMerged);
+            return;
         }
-        if (sizeBefore != equivalentValues.size())
+        int posAttr = posRows.takeFirst();
+        int indColLast = m_listOfStringList[posAttr].size() - 1;
+        bool changed = !posRows.isEmpty() || m_listOfStringList[posAttr][indColLast] != cellMerged;
+        for (int i=posRows.size()-1; i>=0; --i)
         {
-            QStringList listEquivalentValues{equivalentValues.begin(), equivalentValues.end()};
-            std::sort(listEquivalentValues.begin(), listEquivalentValues.end());
-            int indColLast = m_listOfStringList[posAttr].size() - 1;
-            m_listOfStringList[posAttr][indColLast] = listEquivalentValues.join(CELL_SEP);
-            _buildHash();
-            emit dataChanged(index(posAttr, indColLast)
+            _beginRemoveRows(posRows[i], posRows[i]);
+            m_listOfStringList.removeAt(posRows[i]);
+            _endRemoveRows();
+        }
+        if (changed)
+        {
+            m_listOfStringList[posAttr][indColLast] = cellMerged;
+            _save();
+            _emitDataChanged(index(posAttr, indColLast)
                              , index(posAttr, indColLast));
         }
     }
 }
 
+void AttributeEquivalentTable::_insertRow(
+        const QString &fieldIdAmzV02, const QString &cellEquivalents)
+{
+    Q_ASSERT(!cellEquivalents.contains("Amazon V02"));
+    // Find insertion point to keep alphabetical order
+    int insertPos = 0;
+    for (int i = 0; i < m_listOfStringList.size(); ++i) {
+        if (m_listOfStringList[i][0].compare(fieldIdAmzV02, Qt::CaseInsensitive) > 0) {
+            insertPos = i;
+            break;
+        }
+        insertPos = i + 1;
+    }
+    _beginInsertRows(insertPos, insertPos);
+    m_listOfStringList.insert(insertPos, QStringList{fieldIdAmzV02, cellEquivalents});
+    _save();
+    _endInsertRows();
+}
+
 const QSet<QString> &AttributeEquivalentTable::getEquivalentValues(
         const QString &fieldIdAmzV02, const QString &value) const
 {
-    if (m_fieldIdAmzV02_listOfEquivalents.contains(fieldIdAmzV02))
+    int classId = _classId(fieldIdAmzV02, value);
+    if (classId > -1)
     {
-        for (const auto &listOfEquivalent : m_fieldIdAmzV02_listOfEquivalents[fieldIdAmzV02])
-        {
-            if (listOfEquivalent.contains(value))
-            {
-                return listOfEquivalent;
-            }
-        }
+        return m_classId_values[classId];
     }
     static QSet<QString> empty;
     return empty;
@@ -199,29 +205,110 @@ const QString &AttributeEquivalentTable::getEquivalentValue(
         , const QString &value
         , const QSet<QString> &possibleValues) const
 {
-    auto it = m_fieldIdAmzV02_listOfEquivalents.constFind(fieldIdAmzV02);
-    if (it != m_fieldIdAmzV02_listOfEquivalents.constEnd())
+    int classId = _classId(fieldIdAmzV02, value);
+    if (classId > -1)
     {
-        for (const auto &equivalents : it.value())
+        // The same possible values are asked for every SKU of a target, so the
+        // value chosen in a class is kept until the classes change
+        const QPair<int, size_t> cacheKey{classId, qHash(possibleValues)};
+        auto it = m_classIdPossibleValues_equivalentChosen.constFind(cacheKey);
+        if (it == m_classIdPossibleValues_equivalentChosen.constEnd()
+                || it.value().possibleValues != possibleValues)
         {
-            if (equivalents.contains(value))
-            {
-                for (const auto &equivalent : equivalents)
-                {
-                    if (possibleValues.contains(equivalent))
-                    {
-                        return equivalent;
-                    }
-                }
-            }
+            it = m_classIdPossibleValues_equivalentChosen.insert(
+                        cacheKey
+                        , EquivalentChosen{possibleValues, _equivalentChosen(fieldIdAmzV02, value, classId, possibleValues)});
+        }
+        if (it.value().equivalent != nullptr)
+        {
+            return *it.value().equivalent;
         }
     }
     static QString empty;
     return empty;
 }
 
+const QString *AttributeEquivalentTable::_equivalentChosen(
+        const QString &fieldIdAmzV02
+        , const QString &value
+        , int classId
+        , const QSet<QString> &possibleValues) const
+{
+    // A class has one value per language so it is smaller than possibleValues.
+    // Rows merged by a shared value can give several possible values: the
+    // smallest one is returned so the choice doesn't depend on the hash order
+    const QString *equivalentChosen = nullptr;
+    int nPossible = 0;
+    for (const auto &equivalent : m_classId_values[classId])
+    {
+        if (possibleValues.contains(equivalent))
+        {
+            ++nPossible;
+            if (equivalentChosen == nullptr || equivalent < *equivalentChosen)
+            {
+                equivalentChosen = &equivalent;
+            }
+        }
+    }
+    if (nPossible > 1)
+    {
+        _reportConflict(fieldIdAmzV02, value, *equivalentChosen);
+    }
+    return equivalentChosen;
+}
+
+void AttributeEquivalentTable::_reportConflict(
+        const QString &fieldIdAmzV02, const QString &value, const QString &equivalentChosen) const
+{
+    const QString &conflictKey = QStringList{fieldIdAmzV02, value}.join(CELL_SEP);
+    if (!m_conflictsReported.contains(conflictKey))
+    {
+        m_conflictsReported.insert(conflictKey);
+        const auto &equivalentValues = getEquivalentValues(fieldIdAmzV02, value);
+        QStringList listEquivalentValues{equivalentValues.begin(), equivalentValues.end()};
+        std::sort(listEquivalentValues.begin(), listEquivalentValues.end());
+        qDebug() << "AttributeEquivalentTable: several possible values are equivalent to"
+                 << value << "for" << fieldIdAmzV02 << "in" << listEquivalentValues
+                 << ", using" << equivalentChosen;
+    }
+}
+
 QCoro::Task<void> AttributeEquivalentTable::askAiEquivalentValues(
         const QString &fieldIdAmzV02, const QString &value, const Attribute *attribute)
+{
+    const QByteArray &questionKey = AiInFlight::questionKey(
+                {"equivalent", fieldIdAmzV02, value});
+    co_await AiInFlight::instance()->ask(
+                questionKey
+                , [this, fieldIdAmzV02, value, attribute]() -> QCoro::Task<QString>
+    {
+        co_await _askAiEquivalentValues(fieldIdAmzV02, value, attribute);
+        co_return QString{};
+    });
+}
+
+QCoro::Task<void> AttributeEquivalentTable::askAiEquivalentValues(
+        const QString &fieldIdAmzV02
+        , const QString &value
+        , const QString &langCodeFrom
+        , const QString &langCodeTo
+        , const QSet<QString> &possibleValues)
+{
+    const QByteArray &questionKey = AiInFlight::questionKey(
+                {"equivalentLang", fieldIdAmzV02, value, langCodeFrom, langCodeTo}
+                , QMap<QString, QString>{}
+                , possibleValues);
+    co_await AiInFlight::instance()->ask(
+                questionKey
+                , [this, fieldIdAmzV02, value, langCodeFrom, langCodeTo, possibleValues]() -> QCoro::Task<QString>
+    {
+        co_await _askAiEquivalentValues(fieldIdAmzV02, value, langCodeFrom, langCodeTo, possibleValues);
+        co_return QString{};
+    });
+}
+
+QCoro::Task<void> AttributeEquivalentTable::_askAiEquivalentValues(
+        const QString &fieldIdAmzV02, const QString &value, const Attribute *attribute)
 {
     qDebug() << "parseAndValidated::askAiEquivalentValues..." << fieldIdAmzV02 << value;
     const auto &marketplace_countryCode_langCode_category_possibleValues
@@ -399,7 +486,9 @@ QCoro::Task<void> AttributeEquivalentTable::askAiEquivalentValues(
         
         QList<QSharedPointer<OpenAi2::StepMultipleAsk>> phase1;
         phase1 << step;
-        co_await OpenAi2::instance()->askGptMultipleTimeCoro(phase1, "gpt-5.2");
+        Tracer::instance()->traceSteps(phase1);
+        AiTelemetry::instance()->instrument(phase1, "AttributeEquivalentTable.phase1", fieldIdAmzV02);
+        co_await AiScheduler::instance()->ask(phase1, "gpt-5.2", AiScheduler::Normal);
         
         if (*success) co_return;
     }
@@ -450,11 +539,13 @@ QCoro::Task<void> AttributeEquivalentTable::askAiEquivalentValues(
         
         QList<QSharedPointer<OpenAi2::StepMultipleAskAi>> phase2;
         phase2 << step;
-        co_await OpenAi2::instance()->askGptMultipleTimeAiCoro(phase2, "gpt-5.2");
+        Tracer::instance()->traceSteps(phase2);
+        AiTelemetry::instance()->instrument(phase2, "AttributeEquivalentTable.phase2", fieldIdAmzV02);
+        co_await AiScheduler::instance()->ask(phase2, "gpt-5.2", AiScheduler::Normal);
     }
 }
 
-QCoro::Task<void> AttributeEquivalentTable::askAiEquivalentValues(
+QCoro::Task<void> AttributeEquivalentTable::_askAiEquivalentValues(
         const QString &fieldIdAmzV02
         , const QString &value
         , const QString &langCodeFrom
@@ -549,7 +640,9 @@ QCoro::Task<void> AttributeEquivalentTable::askAiEquivalentValues(
 
     QList<QSharedPointer<OpenAi2::StepMultipleAsk>> steps;
     steps << step;
-    co_await OpenAi2::instance()->askGptMultipleTimeCoro(steps, "gpt-5.2");
+    Tracer::instance()->traceSteps(steps);
+    AiTelemetry::instance()->instrument(steps, "AttributeEquivalentTable.language", fieldIdAmzV02);
+    co_await AiScheduler::instance()->ask(steps, "gpt-5.2", AiScheduler::Normal);
 }
 
 
@@ -628,9 +721,9 @@ bool AttributeEquivalentTable::setData(
             index.column() >= 0 && index.column() < HEADERS.size())
         {
             m_listOfStringList[index.row()][index.column()] = value.toString();
-            _saveInFile();
+            _save();
             _buildHash();
-            emit dataChanged(index, index, {role});
+            _emitDataChanged(index, index, {role});
             return true;
         }
     }
@@ -644,12 +737,86 @@ Qt::ItemFlags AttributeEquivalentTable::flags(const QModelIndex &) const
 
 void AttributeEquivalentTable::_buildHash()
 {
+    m_fieldIdAmzV02_value_classId.clear();
+    m_classId_parentClassId.clear();
+    m_classId_values.clear();
+    m_classIdPossibleValues_equivalentChosen.clear();
+    m_conflictsReported.clear();
     for (const auto &stringList : m_listOfStringList)
     {
         const auto &cellValues = stringList.last().split(CELL_SEP);
-        m_fieldIdAmzV02_listOfEquivalents[stringList[0]]
-                << QSet<QString>{cellValues.begin(), cellValues.end()};
+        _addClass(stringList[0], QSet<QString>{cellValues.begin(), cellValues.end()});
+    }
+}
+
+int AttributeEquivalentTable::_rootClassId(int classId) const
+{
+    while (m_classId_parentClassId[classId] != classId)
+    {
+        // Path halving
+        m_classId_parentClassId[classId] = m_classId_parentClassId[m_classId_parentClassId[classId]];
+        classId = m_classId_parentClassId[classId];
     }
+    return classId;
+}
+
+int AttributeEquivalentTable::_classId(
+        const QString &fieldIdAmzV02, const QString &value) const
+{
+    auto itField = m_fieldIdAmzV02_value_classId.constFind(fieldIdAmzV02);
+    if (itField != m_fieldIdAmzV02_value_classId.constEnd())
+    {
+        auto it = itField.value().constFind(value);
+        if (it != itField.value().constEnd())
+        {
+            return _rootClassId(it.value());
+        }
+    }
+    return -1;
+}
+
+int AttributeEquivalentTable::_addClass(
+        const QString &fieldIdAmzV02, const QSet<QString> &values)
+{
+    m_classIdPossibleValues_equivalentChosen.clear();
+    int classIdNew = m_classId_parentClassId.size();
+    m_classId_parentClassId << classIdNew;
+    m_classId_values << QSet<QString>{};
+    int classId = classIdNew;
+    auto &value_classId = m_fieldIdAmzV02_value_classId[fieldIdAmzV02];
+    for (const auto &value : values)
+    {
+        auto it = value_classId.constFind(value);
+        if (it == value_classId.constEnd())
+        {
+            value_classId.insert(value, classIdNew);
+            m_classId_values[_rootClassId(classId)].insert(value);
+        }
+        else
+        {
+            classId = _uniteClasses(classId, it.value());
+        }
+    }
+    return _rootClassId(classId);
+}
+
+int AttributeEquivalentTable::_uniteClasses(int classId1, int classId2)
+{
+    int root1 = _rootClassId(classId1);
+    int root2 = _rootClassId(classId2);
+    if (root1 == root2)
+    {
+        return root1;
+    }
+    m_classIdPossibleValues_equivalentChosen.clear();
+    if (m_classId_values[root1].size() < m_classId_values[root2].size())
+    {
+        std::swap(root1, root2);
+    }
+    m_classId_parentClassId[root2] = root1;
+    m_classId_values[root1].unite(m_classId_values[root2]);
+    m_classId_values[root2].clear();
+    return root1;
 }
 
 void AttributeEquivalentTable::_loadFromFile()
@@ -689,7 +856,7 @@ void AttributeEquivalentTable::_loadFromFile()
 
 void AttributeEquivalentTable::_saveInFile()
 {
-    QFile file{m_filePath};
+    QSaveFile file{m_filePath};
     if (file.open(QFile::WriteOnly))
     {
         QTextStream stream{&file};
@@ -698,6 +865,7 @@ void AttributeEquivalentTable::_saveInFile()
         {
             stream << "\n" + row.join(COL_SEP);
         }
-        file.close();
+        stream.flush();
+        file.commit();
     }
 }
@@ -1,13 +1,17 @@
 #ifndef ATTRIBUTEEQUIVALENTTABLE_H
 #define ATTRIBUTEEQUIVALENTTABLE_H
 
-#include <QAbstractTableModel>
+#include <QHash>
+#include <QPair>
+#include <QSet>
 #include <QStringList>
 #include <QCoro/QCoroTask>
 
+#include "BatchTableModel.h"
+
 class Attribute;
 
-class AttributeEquivalentTable : public QAbstractTableModel
+class AttributeEquivalentTable : public BatchTableModel
 {
     Q_OBJECT
 
@@ -64,14 +68,48 @@ public:
 
     Qt::ItemFlags flags(const QModelIndex& index) const override;
 
+protected:
+    void _saveInFile() override;
+
 private:
     static const QStringList HEADERS;
     void _buildHash();
+    QCoro::Task<void> _askAiEquivalentValues(
+            const QString &fieldIdAmzV02, const QString &value, const Attribute *attribute);
+    QCoro::Task<void> _askAiEquivalentValues(
+            const QString &fieldIdAmzV02
+            , const QString &value
+            , const QString &langCodeFrom
+            , const QString &langCodeTo
+            , const QSet<QString> &possibleValues);
     QString m_filePath;
     QList<QStringList> m_listOfStringList;
-    QHash<QString, QList<QSet<QString>>> m_fieldIdAmzV02_listOfEquivalents;
+    // Union-find of the equivalent values: each (field, value) has a class,
+    // classes sharing a value are merged into the class of the largest one
+    QHash<QString, QHash<QString, int>> m_fieldIdAmzV02_value_classId;
+    mutable QList<int> m_classId_parentClassId; // Compressed during lookups
+    QList<QSet<QString>> m_classId_values; // Up to date for the root classes only
+    int _rootClassId(int classId) const;
+    int _classId(const QString &fieldIdAmzV02, const QString &value) const;
+    int _addClass(const QString &fieldIdAmzV02, const QSet<QString> &values);
+    int _uniteClasses(int classId1, int classId2);
+    void _insertRow(const QString &fieldIdAmzV02, const QString &cellEquivalents);
+    struct EquivalentChosen
+    {
+        QSet<QString> possibleValues; // Shared with the caller's set, compared in case of hash collision
+        const QString *equivalent = nullptr; // In m_classId_values, nullptr if none is possible
+    };
+    // Cleared each time a class changes, so the pointers stay valid
+    mutable QHash<QPair<int, size_t>, EquivalentChosen> m_classIdPossibleValues_equivalentChosen;
+    const QString *_equivalentChosen(const QString &fieldIdAmzV02
+                                     , const QString &value
+                                     , int classId
+                                     , const QSet<QString> &possibleValues) const;
+    mutable QSet<QString> m_conflictsReported; // Reported once per (field, value), when the choice is cached
+    void _reportConflict(const QString &fieldIdAmzV02
+                         , const QString &value
+                         , const QString &equivalentChosen) const;
     void _loadFromFile();
-    void _saveInFile();
 };
 
 #endif // ATTRIBUTEEQUIVALENTTABLE_H
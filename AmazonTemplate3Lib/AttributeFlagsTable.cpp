@@ -1,4 +1,5 @@
 #include <QDir>
+#include <QSaveFile>
 #include <algorithm>
 #include <QColor>
 #include <QBrush>
@@ -7,7 +8,7 @@
 
 AttributeFlagsTable::AttributeFlagsTable(
         const QString &workingDirectory, QObject *parent)
-    : QAbstractTableModel(parent)
+    : BatchTableModel(parent)
 {
     m_filePath = QDir{workingDirectory}.absoluteFilePath("attributeFlags.csv");
     for (const auto &markeplace : Attribute::MARKETPLACES)
@@ -28,52 +29,24 @@ QString AttributeFlagsTable::getFieldId(
         , const QString &fieldIdFrom
         , const QString &marketplaceTo) const
 {
-    if (marketplaceFrom == marketplaceTo)
-    {
-        return fieldIdFrom;
-    }
-    
-    if (m_marketplace_fieldId_indRow.contains(marketplaceFrom))
-    {
-        const auto &fieldId_indRow = m_marketplace_fieldId_indRow[marketplaceFrom];
-        if (fieldId_indRow.contains(fieldIdFrom))
-        {
-            int rowIndex = fieldId_indRow[fieldIdFrom];
-            int colIndex = m_colNames.indexOf(marketplaceTo);
-            
-            if (colIndex != -1 && rowIndex >= 0 && rowIndex < m_listOfVariantList.size())
-            {
-                // Ensure colIndex is within bounds of the specific row (though rows should be full size)
-                if (colIndex < m_listOfVariantList[rowIndex].size())
-                {
-                    return m_listOfVariantList[rowIndex][colIndex].toString();
-                }
-            }
-        }
-    }
-    return QString{};
+    return _schema().fieldId(marketplaceFrom, fieldIdFrom, marketplaceTo);
 }
 
 QSet<QString> AttributeFlagsTable::getUnrecordedFieldIds(
         const QString &marketplace, const QSet<QString> &fieldIds) const
 {
-    int colIdx = m_colNames.indexOf(marketplace);
-    if (colIdx == -1)
+    const auto &schema = _schema();
+    if (schema.marketplaceIndex(marketplace) == -1)
     {
         return fieldIds;
     }
 
-    QSet<QString> unrecordedIds = fieldIds;
-    for (const auto &variantList : std::as_const(m_listOfVariantList))
+    QSet<QString> unrecordedIds;
+    for (const auto &fieldId : fieldIds)
     {
-        const QString &val = variantList[colIdx].toString();
-        if (!val.isEmpty())
+        if (schema.row(marketplace, fieldId) == -1)
         {
-            unrecordedIds.remove(val);
-            if (unrecordedIds.isEmpty())
-            {
-                break;
-            }
+            unrecordedIds.insert(fieldId);
         }
     }
     return unrecordedIds;
@@ -82,47 +55,35 @@ QSet<QString> AttributeFlagsTable::getUnrecordedFieldIds(
 QHash<QString, QString> AttributeFlagsTable::get_marketplace_id(
         const QString &marketplace, const QString &fieldId) const
 {
-    QHash<QString, QString> marketplace_id;
-    int rowIndex = m_marketplace_fieldId_indRow[marketplace][fieldId];
-    for (int i=0; i<m_indFirstFlag; ++i)
-    {
-        const auto &curMarketplace = m_colNames[i];
-        const auto &fieldId = m_listOfVariantList[rowIndex][i].toString();
-        if (!fieldId.isEmpty())
-        {
-            marketplace_id[curMarketplace] = fieldId;
-        }
-    }
-    return marketplace_id;
+    return _schema().marketplace_id(marketplace, fieldId);
 }
 
 Attribute::Flag AttributeFlagsTable::getFlags(
         const QString &marketplace, const QString &fieldId) const
 {
-    Attribute::Flag flags = Attribute::NoFlag;
-    if (m_marketplace_fieldId_indRow.contains(marketplace) &&
-        m_marketplace_fieldId_indRow[marketplace].contains(fieldId))
-    {
-        int rowIndex = m_marketplace_fieldId_indRow[marketplace][fieldId];
-        for (int i = m_indFirstFlag; i < m_colNames.size(); ++i)
-        {
-            if (m_listOfVariantList[rowIndex][i].toBool())
-            {
-                const QString &flagName = m_colNames[i];
-                Attribute::Flag curFlag = Attribute::STRING_FLAG.value(flagName);
-                flags = static_cast<Attribute::Flag>(
-                            static_cast<int>(flags) | static_cast<int>(curFlag));
-            }
-        }
-    }
-    return flags;
+    return _schema().flags(marketplace, fieldId);
 }
 
 bool AttributeFlagsTable::hasFlag(
         const QString &marketplace, const QString &fieldId, Attribute::Flag flag) const
 {
-    Attribute::Flag flags = getFlags(marketplace, fieldId);
-    return (flags & flag) == flag;
+    return _schema().hasFlag(marketplace, fieldId, flag);
+}
+
+QSharedPointer<const AttributeSchema> AttributeFlagsTable::schema() const
+{
+    _schema();
+    return m_schema;
+}
+
+const AttributeSchema &AttributeFlagsTable::_schema() const
+{
+    if (m_schema.isNull())
+    {
+        m_schema = QSharedPointer<const AttributeSchema>::create(
+                    m_colNames, m_indFirstFlag, m_listOfVariantList);
+    }
+    return *m_schema;
 }
 
 QStringList AttributeFlagsTable::getSizeFieldIds() const
@@ -178,7 +139,7 @@ QStringList AttributeFlagsTable::getSizeFieldIds() const
 void AttributeFlagsTable::recordAttributeNotRecordedYet(
         const QString &marketplace, const QSet<QString> &fieldIds)
 {
-    bool added = false;
+    TableBatch batch{this};
     for (const auto &fieldId : fieldIds)
     {
         QHash<QString, QString> marketplace_ids{{marketplace, fieldId}};
@@ -203,17 +164,9 @@ void AttributeFlagsTable::recordAttributeNotRecordedYet(
             {
                 variantList << false;
             }
-            beginInsertRows(QModelIndex{}, 0, 0);
-            m_listOfVariantList.insert(0, variantList);
-            endInsertRows();
-            added = true;
+            _insertRow(variantList);
         }
     }
-    if (added)
-    {
-        _sort();
-        _saveInFile();
-    }
 }
 
 void AttributeFlagsTable::recordAttribute(const QHash<QString, QString> &marketplace_ids)
@@ -254,11 +207,7 @@ void AttributeFlagsTable::recordAttribute(const QHash<QString, QString> &marketp
         {
             variantList << false;
         }
-        beginInsertRows(QModelIndex{}, 0, 0);
-        m_listOfVariantList.insert(0, variantList);
-        _sort();
-        _saveInFile();
-        endInsertRows();
+        _insertRow(variantList);
     }
 }
 
@@ -359,11 +308,7 @@ void AttributeFlagsTable::recordAttribute(
             bool contains = (flag & curFlag) == curFlag;
             variantList << contains;
         }
-        beginInsertRows(QModelIndex{}, 0, 0);
-        m_listOfVariantList.insert(0, variantList);
-        _sort();
-        _saveInFile();
-        endInsertRows();
+        _insertRow(variantList);
     }
 }
 
@@ -419,8 +364,9 @@ bool AttributeFlagsTable::setData(
     if (data(index, role) != value)
     {
         m_listOfVariantList[index.row()][index.column()] = value;
-        _saveInFile();
-        emit dataChanged(index, index, {role});
+        m_schema.reset();
+        _save();
+        _emitDataChanged(index, index, {role});
         return true;
     }
     return false;
@@ -503,7 +449,7 @@ void AttributeFlagsTable::_loadFromFile()
 
 void AttributeFlagsTable::_saveInFile()
 {
-    QFile file{m_filePath};
+    QSaveFile file{m_filePath};
     if (file.open(QFile::WriteOnly))
     {
         QTextStream stream{&file};
@@ -528,26 +474,51 @@ void AttributeFlagsTable::_saveInFile()
             }
             stream << "\n" + elements.join(COL_SEP);
         }
-        file.close();
+        stream.flush();
+        file.commit();
     }
 }
 
-void AttributeFlagsTable::_updateMap()
+void AttributeFlagsTable::_commitBatch()
 {
-    m_marketplace_fieldId_indRow.clear();
-    for (int i=0; i<m_listOfVariantList.size(); ++i)
+    _sortRows();
+}
+
+void AttributeFlagsTable::_insertRow(const QVariantList &variantList)
+{
+    if (isInBatch())
     {
-        for (int j=0; j<m_indFirstFlag; ++j)
-        {
-            const auto &marketplace = m_colNames[j];
-            const auto &fieldId = m_listOfVariantList[i][j].toString();
-            m_marketplace_fieldId_indRow[marketplace][fieldId] = i;
-        }
+        int rowIndex = m_listOfVariantList.size();
+        _beginInsertRows(rowIndex, rowIndex);
+        m_listOfVariantList << variantList; // Sorted when the batch is committed
+        m_schema.reset();
+        _save();
+        _endInsertRows();
+    }
+    else
+    {
+        beginInsertRows(QModelIndex{}, 0, 0);
+        m_listOfVariantList.insert(0, variantList);
+        _sort();
+        _saveInFile();
+        endInsertRows();
     }
 }
 
 void AttributeFlagsTable::_sort()
 {
+    if (isInBatch())
+    {
+        return; // Sorted once when the batch is committed
+    }
+    _sortRows();
+    // Notify views that the layout changed
+    emit layoutChanged();
+}
+
+void AttributeFlagsTable::_sortRows()
+{
+    m_schema.reset();
     // Determine column indices for sorting priority
     int idxV02 = m_colNames.indexOf(Attribute::AMAZON_V02);
     int idxV01 = m_colNames.indexOf(Attribute::AMAZON_V01);
@@ -570,9 +541,6 @@ void AttributeFlagsTable::_sort()
             const QString bTemu = b[idxTemu].toString();
             return aTemu < bTemu;
         });
-    // Notify views that the layout changed
-    _updateMap();
-    emit layoutChanged();
 }
 
 
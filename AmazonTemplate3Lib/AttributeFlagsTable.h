@@ -1,15 +1,16 @@
 #ifndef ATTRIBUTEFLAGSTABLE_H
 #define ATTRIBUTEFLAGSTABLE_H
 
-#include <QAbstractTableModel>
 #include <QSettings>
 #include <QSharedPointer>
 
 #include "../../common/utils/CsvReader.h"
 
 #include "Attribute.h"
+#include "AttributeSchema.h"
+#include "BatchTableModel.h"
 
-class AttributeFlagsTable : public QAbstractTableModel
+class AttributeFlagsTable : public BatchTableModel
 {
     Q_OBJECT
 
@@ -27,6 +28,7 @@ public:
     Attribute::Flag getFlags(const QString &marketplace, const QString &fieldId) const;
     bool hasFlag(const QString &marketplace, const QString &fieldId, Attribute::Flag flag) const;
     QStringList getSizeFieldIds() const;
+    QSharedPointer<const AttributeSchema> schema() const; // Compiled again after the table changes
     //Attribute::Flag getFlag(const QString &attrId, const QString &marketplace) const;
 
     void recordAttributeNotRecordedYet(
@@ -51,16 +53,21 @@ public:
 
     Qt::ItemFlags flags(const QModelIndex& index) const override;
 
+protected:
+    void _saveInFile() override;
+    void _commitBatch() override;
+
 private:
     void _sort();
+    void _sortRows();
     QString m_filePath;
     QStringList m_colNames;
     int m_indFirstFlag;
     QList<QVariantList> m_listOfVariantList;
     void _loadFromFile();
-    void _saveInFile();
-    void _updateMap();
-    QHash<QString, QHash<QString, int>> m_marketplace_fieldId_indRow;
+    void _insertRow(const QVariantList &variantList);
+    mutable QSharedPointer<const AttributeSchema> m_schema;
+    const AttributeSchema &_schema() const;
 };
 
 #endif // ATTRIBUTEFLAGSTABLE_H
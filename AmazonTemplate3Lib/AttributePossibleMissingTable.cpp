@@ -1,5 +1,6 @@
 #include <QDir>
 #include <QFile>
+#include <QSaveFile>
 #include <QTextStream>
 #include <algorithm>
 
@@ -16,7 +17,7 @@ const QStringList AttributePossibleMissingTable::HEADERS{
 
 AttributePossibleMissingTable::AttributePossibleMissingTable(
         const QString &workingDirectory, QObject *parent)
-    : QAbstractTableModel(parent)
+    : BatchTableModel(parent)
 {
     m_filePath = QDir{workingDirectory}.absoluteFilePath("attributePossibleMissing.csv");
     _loadFromFile();
@@ -24,10 +25,11 @@ AttributePossibleMissingTable::AttributePossibleMissingTable(
 
 void AttributePossibleMissingTable::remove(const QModelIndex &index)
 {
-    beginRemoveRows(QModelIndex{}, index.row(), index.row());
+    _beginRemoveRows(index.row(), index.row());
     m_listOfStringList.removeAt(index.row());
-    _saveInFile();
-    endRemoveRows();
+    _buildIndex();
+    _save();
+    _endRemoveRows();
 }
 
 bool AttributePossibleMissingTable::contains(
@@ -37,19 +39,8 @@ bool AttributePossibleMissingTable::contains(
         , const QString &productType
         , const QString &attrId) const
 {
-    for (const auto &row : std::as_const(m_listOfStringList))
-    {
-        if (row.size() >= 5 &&
-            row[0] == marketplace &&
-            row[1] == countryCode &&
-            row[2] == langCode &&
-            row[3] == productType &&
-            row[4] == attrId)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_key_possibleValues.contains(
+                Key{marketplace, countryCode, langCode, productType, attrId});
 }
 
 void AttributePossibleMissingTable::recordAttribute(
@@ -65,10 +56,14 @@ void AttributePossibleMissingTable::recordAttribute(
         QStringList newRow;
         newRow << marketplace << countryCode << langCode << productType << attrId << possibleValues.join(CELL_SEP);
 
-        beginInsertRows(QModelIndex{}, 0, 0);
+        _beginInsertRows(0, 0);
         m_listOfStringList.insert(0, newRow);
-        _saveInFile();
-        endInsertRows();
+        const auto &listValues = newRow[5].split(CELL_SEP); // Same values as read from the file
+        m_key_possibleValues.insert(
+                    Key{marketplace, countryCode, langCode, productType, attrId}
+                    , QSet<QString>{listValues.begin(), listValues.end()});
+        _save();
+        _endInsertRows();
     }
 }
 
@@ -79,21 +74,8 @@ QSet<QString> AttributePossibleMissingTable::possibleValues(
         , const QString &productType
         , const QString &attrId) const
 {
-    QSet<QString> values;
-    for (const auto &row : std::as_const(m_listOfStringList))
-    {
-        if (row.size() >= 5 &&
-            row[0] == marketplace &&
-            row[1] == countryCode &&
-            row[2] == langCode &&
-            row[3] == productType &&
-            row[4] == attrId)
-        {
-            const auto &listValues = row[5].split(CELL_SEP);
-            return QSet<QString>{listValues.begin(), listValues.end()};
-        }
-    }
-    return QSet<QString>{};
+    return m_key_possibleValues.value(
+                Key{marketplace, countryCode, langCode, productType, attrId});
 }
 
 QVariant AttributePossibleMissingTable::headerData(
@@ -141,8 +123,9 @@ bool AttributePossibleMissingTable::setData(
             index.column() >= 0 && index.column() < HEADERS.size())
         {
             m_listOfStringList[index.row()][index.column()] = value.toString();
-            _saveInFile();
-            emit dataChanged(index, index, {role});
+            _buildIndex();
+            _save();
+            _emitDataChanged(index, index, {role});
             return true;
         }
     }
@@ -179,11 +162,12 @@ void AttributePossibleMissingTable::_loadFromFile()
         }
         file.close();
     }
+    _buildIndex();
 }
 
 void AttributePossibleMissingTable::_saveInFile()
 {
-    QFile file{m_filePath};
+    QSaveFile file{m_filePath};
     if (file.open(QFile::WriteOnly))
     {
         QTextStream stream{&file};
@@ -192,6 +176,25 @@ void AttributePossibleMissingTable::_saveInFile()
         {
             stream << "\n" + row.join(COL_SEP);
         }
-        file.close();
+        stream.flush();
+        file.commit();
+    }
+}
+
+void AttributePossibleMissingTable::_buildIndex()
+{
+    m_key_possibleValues.clear();
+    m_key_possibleValues.reserve(m_listOfStringList.size());
+    for (const auto &row : std::as_const(m_listOfStringList))
+    {
+        if (row.size() >= 6)
+        {
+            const Key key{row[0], row[1], row[2], row[3], row[4]};
+            if (!m_key_possibleValues.contains(key)) // The first row wins as when the rows were scanned
+            {
+                const auto &listValues = row[5].split(CELL_SEP);
+                m_key_possibleValues.insert(key, QSet<QString>{listValues.begin(), listValues.end()});
+            }
+        }
     }
 }
@@ -1,10 +1,13 @@
 #ifndef ATTRIBUTEPOSSIBLEMISSINGTABLE_H
 #define ATTRIBUTEPOSSIBLEMISSINGTABLE_H
 
-#include <QAbstractTableModel>
+#include <QHash>
+#include <QSet>
 #include <QStringList>
 
-class AttributePossibleMissingTable : public QAbstractTableModel
+#include "BatchTableModel.h"
+
+class AttributePossibleMissingTable : public BatchTableModel
 {
     Q_OBJECT
 
@@ -47,12 +50,30 @@ public:
 
     Qt::ItemFlags flags(const QModelIndex& index) const override;
 
+protected:
+    void _saveInFile() override;
+
 private:
+    struct Key
+    {
+        QString marketplace;
+        QString countryCode;
+        QString langCode;
+        QString productType;
+        QString attrId;
+        friend bool operator==(const Key &, const Key &) = default;
+        friend size_t qHash(const Key &key, size_t seed = 0)
+        {
+            return qHashMulti(seed, key.marketplace, key.countryCode, key.langCode
+                              , key.productType, key.attrId);
+        }
+    };
     static const QStringList HEADERS;
     QString m_filePath;
     QList<QStringList> m_listOfStringList;
+    QHash<Key, QSet<QString>> m_key_possibleValues; // First row of each key, rebuilt when rows change
     void _loadFromFile();
-    void _saveInFile();
+    void _buildIndex();
 };
 
 #endif // ATTRIBUTEPOSSIBLEMISSINGTABLE_H
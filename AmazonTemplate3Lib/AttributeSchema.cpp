@@ -0,0 +1,169 @@
+#include "AttributeSchema.h"
+
+AttributeSchema::AttributeSchema(
+        const QStringList &colNames
+        , int indFirstFlag
+        , const QList<QVariantList> &listOfVariantList)
+{
+    m_marketplaces = colNames.mid(0, indFirstFlag);
+    QList<int> flagCol_mask;
+    for (int i=indFirstFlag; i<colNames.size(); ++i)
+    {
+        flagCol_mask << static_cast<int>(Attribute::STRING_FLAG.value(colNames[i]));
+    }
+    const int nMarketplaces = m_marketplaces.size();
+    QList<QList<int>> marketplaceIndex_fieldIndexes(nMarketplaces);
+    m_row_marketplaceIndex_fieldId.reserve(listOfVariantList.size() * nMarketplaces);
+    m_row_flags.reserve(listOfVariantList.size());
+    for (int i=0; i<listOfVariantList.size(); ++i)
+    {
+        const auto &variantList = listOfVariantList[i];
+        for (int j=0; j<nMarketplaces; ++j)
+        {
+            const QString &fieldId = variantList[j].toString();
+            int fieldIndex = -1;
+            if (fieldId.isEmpty())
+            {
+                m_row_marketplaceIndex_fieldId << fieldId;
+            }
+            else
+            {
+                auto it = m_fieldId_fieldIndex.constFind(fieldId);
+                if (it == m_fieldId_fieldIndex.constEnd())
+                {
+                    it = m_fieldId_fieldIndex.insert(fieldId, m_fieldId_fieldIndex.size());
+                }
+                fieldIndex = it.value();
+                m_row_marketplaceIndex_fieldId << it.key(); // Equal field ids share one copy
+            }
+            marketplaceIndex_fieldIndexes[j] << fieldIndex;
+        }
+        int flags = Attribute::NoFlag;
+        for (int j=0; j<flagCol_mask.size(); ++j)
+        {
+            if (variantList[indFirstFlag + j].toBool())
+            {
+                flags |= flagCol_mask[j];
+            }
+        }
+        m_row_flags << flags;
+    }
+    m_marketplaceIndex_fieldIndex_row.resize(nMarketplaces);
+    for (int j=0; j<nMarketplaces; ++j)
+    {
+        auto &fieldIndex_row = m_marketplaceIndex_fieldIndex_row[j];
+        fieldIndex_row.fill(-1, m_fieldId_fieldIndex.size());
+        const auto &fieldIndexes = marketplaceIndex_fieldIndexes[j];
+        for (int i=0; i<fieldIndexes.size(); ++i)
+        {
+            if (fieldIndexes[i] >= 0)
+            {
+                fieldIndex_row[fieldIndexes[i]] = i; // The last row wins as in the former map
+            }
+        }
+    }
+}
+
+int AttributeSchema::marketplaceIndex(const QString &marketplace) const
+{
+    return m_marketplaces.indexOf(marketplace);
+}
+
+int AttributeSchema::row(const QString &marketplace, const QString &fieldId) const
+{
+    int indMarketplace = marketplaceIndex(marketplace);
+    if (indMarketplace < 0)
+    {
+        return -1;
+    }
+    return row(indMarketplace, fieldIndex(fieldId));
+}
+
+int AttributeSchema::fieldIndex(const QString &fieldId) const
+{
+    return m_fieldId_fieldIndex.value(fieldId, -1);
+}
+
+int AttributeSchema::row(int marketplaceIndex, int fieldIndex) const
+{
+    if (marketplaceIndex < 0 || marketplaceIndex >= m_marketplaceIndex_fieldIndex_row.size())
+    {
+        return -1;
+    }
+    const auto &fieldIndex_row = m_marketplaceIndex_fieldIndex_row[marketplaceIndex];
+    if (fieldIndex < 0 || fieldIndex >= fieldIndex_row.size())
+    {
+        return -1;
+    }
+    return fieldIndex_row[fieldIndex];
+}
+
+int AttributeSchema::rowCount() const
+{
+    return m_row_flags.size();
+}
+
+Attribute::Flag AttributeSchema::flags(int row) const
+{
+    return static_cast<Attribute::Flag>(m_row_flags[row]);
+}
+
+const QString &AttributeSchema::fieldId(int row, int marketplaceIndex) const
+{
+    return m_row_marketplaceIndex_fieldId[row * m_marketplaces.size() + marketplaceIndex];
+}
+
+Attribute::Flag AttributeSchema::flags(
+        const QString &marketplace, const QString &fieldId) const
+{
+    int indRow = row(marketplace, fieldId);
+    if (indRow < 0)
+    {
+        return Attribute::NoFlag;
+    }
+    return flags(indRow);
+}
+
+bool AttributeSchema::hasFlag(
+        const QString &marketplace, const QString &fieldId, Attribute::Flag flag) const
+{
+    const int mask = static_cast<int>(flag);
+    return (static_cast<int>(flags(marketplace, fieldId)) & mask) == mask;
+}
+
+QString AttributeSchema::fieldId(
+        const QString &marketplaceFrom
+        , const QString &fieldIdFrom
+        , const QString &marketplaceTo) const
+{
+    if (marketplaceFrom == marketplaceTo)
+    {
+        return fieldIdFrom;
+    }
+    int indRow = row(marketplaceFrom, fieldIdFrom);
+    int indMarketplaceTo = marketplaceIndex(marketplaceTo);
+    if (indRow < 0 || indMarketplaceTo < 0)
+    {
+        return QString{};
+    }
+    return fieldId(indRow, indMarketplaceTo);
+}
+
+QHash<QString, QString> AttributeSchema::marketplace_id(
+        const QString &marketplace, const QString &fieldId) const
+{
+    QHash<QString, QString> marketplace_id;
+    int indRow = row(marketplace, fieldId);
+    if (indRow >= 0)
+    {
+        for (int i=0; i<m_marketplaces.size(); ++i)
+        {
+            const auto &curFieldId = this->fieldId(indRow, i);
+            if (!curFieldId.isEmpty())
+            {
+                marketplace_id[m_marketplaces[i]] = curFieldId;
+            }
+        }
+    }
+    return marketplace_id;
+}
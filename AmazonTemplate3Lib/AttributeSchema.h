@@ -0,0 +1,48 @@
+#ifndef ATTRIBUTESCHEMA_H
+#define ATTRIBUTESCHEMA_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+
+#include "Attribute.h"
+
+// Read-only copy of the attribute flags table compiled for the lookups of
+// the fill: the flags of each row are packed in a bitmask and the field ids
+// of the marketplaces are stored in one dense array. The row of a
+// (marketplace, field id) is read in an array indexed by the field index,
+// dense over the field ids of the table only, so a lookup is one hash read
+// and the arrays don't grow with anything else the fill reads.
+class AttributeSchema
+{
+public:
+    AttributeSchema(const QStringList &colNames
+                    , int indFirstFlag
+                    , const QList<QVariantList> &listOfVariantList);
+    int marketplaceIndex(const QString &marketplace) const;
+    int row(const QString &marketplace, const QString &fieldId) const; // -1 if not recorded
+    int fieldIndex(const QString &fieldId) const; // -1 if in no marketplace
+    int row(int marketplaceIndex, int fieldIndex) const;
+    int rowCount() const;
+    Attribute::Flag flags(int row) const;
+    const QString &fieldId(int row, int marketplaceIndex) const;
+
+    Attribute::Flag flags(const QString &marketplace, const QString &fieldId) const;
+    bool hasFlag(const QString &marketplace, const QString &fieldId, Attribute::Flag flag) const;
+    QString fieldId(const QString &marketplaceFrom
+                    , const QString &fieldIdFrom
+                    , const QString &marketplaceTo) const;
+    QHash<QString, QString> marketplace_id(
+            const QString &marketplace, const QString &fieldId) const;
+
+private:
+    QStringList m_marketplaces;
+    QHash<QString, int> m_fieldId_fieldIndex;
+    QList<QList<int>> m_marketplaceIndex_fieldIndex_row;
+    QList<QString> m_row_marketplaceIndex_fieldId; // Index: row * marketplaces + marketplace index
+    QList<int> m_row_flags;
+};
+
+#endif // ATTRIBUTESCHEMA_H
@@ -1,5 +1,6 @@
 #include <QDir>
 #include <QFile>
+#include <QSaveFile>
 #include <QTextStream>
 #include <algorithm>
 
@@ -17,7 +18,7 @@ const QStringList AttributeValueReplacedTable::HEADERS{
 
 AttributeValueReplacedTable::AttributeValueReplacedTable(
         const QString &workingDirectory, QObject *parent)
-    : QAbstractTableModel(parent)
+    : BatchTableModel(parent)
 {
     m_filePath = QDir{workingDirectory}.absoluteFilePath("attributeReplacement.csv");
     _loadFromFile();
@@ -25,10 +26,11 @@ AttributeValueReplacedTable::AttributeValueReplacedTable(
 
 void AttributeValueReplacedTable::remove(const QModelIndex &index)
 {
-    beginRemoveRows(QModelIndex{}, index.row(), index.row());
+    _beginRemoveRows(index.row(), index.row());
     m_listOfStringList.removeAt(index.row());
-    _saveInFile();
-    endRemoveRows();
+    _buildIndex();
+    _save();
+    _endRemoveRows();
 }
 
 bool AttributeValueReplacedTable::contains(
@@ -39,20 +41,8 @@ bool AttributeValueReplacedTable::contains(
         , const QString &fieldId
         , const QString &valueFrom) const
 {
-    for (const auto &row : std::as_const(m_listOfStringList))
-    {
-        if (row.size() >= 6 && // Increased size check
-            row[0] == marketplace &&
-            row[1] == countryCode &&
-            row[2] == langCode &&
-            row[3] == productType && // Added productType check
-            row[4] == fieldId &&     // Shifted index
-            row[5] == valueFrom)     // Shifted index
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_key_valueTo.contains(
+                Key{marketplace, countryCode, langCode, productType, fieldId, valueFrom});
 }
 
 bool AttributeValueReplacedTable::replaceIfContains(
@@ -63,19 +53,12 @@ bool AttributeValueReplacedTable::replaceIfContains(
         , const QString &fieldId
         , QString &valueToUpdate) const
 {
-    for (const auto &row : std::as_const(m_listOfStringList))
+    auto it = m_key_valueTo.constFind(
+                Key{marketplace, countryCode, langCode, productType, fieldId, valueToUpdate});
+    if (it != m_key_valueTo.constEnd())
     {
-        if (row.size() >= 6 &&
-            row[0] == marketplace &&
-            row[1] == countryCode &&
-            row[2] == langCode &&
-            row[3] == productType &&
-            row[4] == fieldId &&
-            row[5] == valueToUpdate)
-        {
-            valueToUpdate = row[6];
-            return true;
-        }
+        valueToUpdate = it.value();
+        return true;
     }
     return false;
 }
@@ -88,13 +71,17 @@ void AttributeValueReplacedTable::replaceIfContains(
         , const QString &fieldId
         , QSet<QString> &possibleValues) const
 {
+    if (m_key_valueTo.isEmpty())
+    {
+        return;
+    }
     QSet<QString> possibleValuesReplaced;
-    for (const auto &possibleValue : possibleValues)
+    possibleValuesReplaced.reserve(possibleValues.size());
+    Key key{marketplace, countryCode, langCode, productType, fieldId, QString{}};
+    for (const auto &possibleValue : std::as_const(possibleValues))
     {
-        QString valueReplaced = possibleValue;
-        replaceIfContains(
-                    marketplace, countryCode, langCode, productType, fieldId, valueReplaced);
-        possibleValuesReplaced.insert(valueReplaced);
+        key.valueFrom = possibleValue;
+        possibleValuesReplaced.insert(m_key_valueTo.value(key, possibleValue));
     }
     possibleValues = possibleValuesReplaced;
 }
@@ -114,10 +101,12 @@ void AttributeValueReplacedTable::recordAttribute(
         QStringList newRow;
         newRow << marketplace << countryCode << langCode << productType << fieldId << valueFrom << valueTo;
 
-        beginInsertRows(QModelIndex{}, 0, 0);
+        _beginInsertRows(0, 0);
         m_listOfStringList.insert(0, newRow);
-        _saveInFile();
-        endInsertRows();
+        m_key_valueTo.insert(
+                    Key{marketplace, countryCode, langCode, productType, fieldId, valueFrom}, valueTo);
+        _save();
+        _endInsertRows();
     }
 }
 
@@ -166,8 +155,9 @@ bool AttributeValueReplacedTable::setData(
             index.column() >= 0 && index.column() < HEADERS.size())
         {
             m_listOfStringList[index.row()][index.column()] = value.toString();
-            _saveInFile();
-            emit dataChanged(index, index, {role});
+            _buildIndex();
+            _save();
+            _emitDataChanged(index, index, {role});
             return true;
         }
     }
@@ -214,11 +204,12 @@ void AttributeValueReplacedTable::_loadFromFile()
         }
         file.close();
     }
+    _buildIndex();
 }
 
 void AttributeValueReplacedTable::_saveInFile()
 {
-    QFile file{m_filePath};
+    QSaveFile file{m_filePath};
     if (file.open(QFile::WriteOnly))
     {
         QTextStream stream{&file};
@@ -227,6 +218,24 @@ void AttributeValueReplacedTable::_saveInFile()
         {
             stream << "\n" + row.join(COL_SEP);
         }
-        file.close();
+        stream.flush();
+        file.commit();
+    }
+}
+
+void AttributeValueReplacedTable::_buildIndex()
+{
+    m_key_valueTo.clear();
+    m_key_valueTo.reserve(m_listOfStringList.size());
+    for (const auto &row : std::as_const(m_listOfStringList))
+    {
+        if (row.size() >= 7)
+        {
+            const Key key{row[0], row[1], row[2], row[3], row[4], row[5]};
+            if (!m_key_valueTo.contains(key)) // The first row wins as when the rows were scanned
+            {
+                m_key_valueTo.insert(key, row[6]);
+            }
+        }
     }
 }
@@ -1,10 +1,13 @@
 #ifndef ATTRIBUTEVALUEREPLACEDTABLE_H
 #define ATTRIBUTEVALUEREPLACEDTABLE_H
 
-#include <QAbstractTableModel>
+#include <QHash>
+#include <QSet>
 #include <QStringList>
 
-class AttributeValueReplacedTable : public QAbstractTableModel
+#include "BatchTableModel.h"
+
+class AttributeValueReplacedTable : public BatchTableModel
 {
     Q_OBJECT
 
@@ -56,12 +59,31 @@ public:
 
     Qt::ItemFlags flags(const QModelIndex& index) const override;
 
+protected:
+    void _saveInFile() override;
+
 private:
+    struct Key
+    {
+        QString marketplace;
+        QString countryCode;
+        QString langCode;
+        QString productType;
+        QString fieldId;
+        QString valueFrom;
+        friend bool operator==(const Key &, const Key &) = default;
+        friend size_t qHash(const Key &key, size_t seed = 0)
+        {
+            return qHashMulti(seed, key.marketplace, key.countryCode, key.langCode
+                              , key.productType, key.fieldId, key.valueFrom);
+        }
+    };
     static const QStringList HEADERS;
     QString m_filePath;
     QList<QStringList> m_listOfStringList;
+    QHash<Key, QString> m_key_valueTo; // First row of each key, rebuilt when rows change
     void _loadFromFile();
-    void _saveInFile();
+    void _buildIndex();
 };
 
 #endif // ATTRIBUTEVALUEREPLACEDTABLE_H
@@ -3,6 +3,9 @@
 #include "../../common/openai/OpenAi2.h"
 
 #include "AttributesMandatoryAiTable.h"
+#include "AiScheduler.h"
+#include "AiTelemetry.h"
+#include "Tracer.h"
 
 const QString AttributesMandatoryAiTable::SETTINGS_KEYS_GROUP{"attributesReviewed"};
 
@@ -132,7 +135,9 @@ QCoro::Task<void> AttributesMandatoryAiTable::load(
         phase1.push_back(step);
     }
 
-    co_await OpenAi2::instance()->askGptMultipleTimeCoro(phase1, "removeparam");
+    Tracer::instance()->traceSteps(phase1);
+    AiTelemetry::instance()->instrument(phase1, "AttributesMandatoryAiTable.phase1", "mandatory");
+    co_await AiScheduler::instance()->ask(phase1, "removeparam", AiScheduler::High);
 
     if (undecided->isEmpty())
     {
@@ -170,7 +175,9 @@ QCoro::Task<void> AttributesMandatoryAiTable::load(
         phase2.push_back(step);
     }
 
-    co_await OpenAi2::instance()->askGptMultipleTimeCoro(phase2, "gpt-5.2");
+    Tracer::instance()->traceSteps(phase2);
+    AiTelemetry::instance()->instrument(phase2, "AttributesMandatoryAiTable.phase2", "mandatory");
+    co_await AiScheduler::instance()->ask(phase2, "gpt-5.2", AiScheduler::High);
 
 }
 
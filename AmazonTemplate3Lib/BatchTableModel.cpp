@@ -0,0 +1,117 @@
+#include "BatchTableModel.h"
+
+BatchTableModel::BatchTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void BatchTableModel::beginBatch()
+{
+    ++m_batchDepth;
+}
+
+void BatchTableModel::commitBatch()
+{
+    Q_ASSERT(m_batchDepth > 0);
+    --m_batchDepth;
+    if (m_batchDepth == 0)
+    {
+        if (m_modifiedInBatch)
+        {
+            _commitBatch();
+            _saveInFile();
+            m_modifiedInBatch = false;
+            endResetModel();
+        }
+    }
+}
+
+bool BatchTableModel::isInBatch() const
+{
+    return m_batchDepth > 0;
+}
+
+void BatchTableModel::_commitBatch()
+{
+}
+
+void BatchTableModel::_save()
+{
+    if (m_batchDepth > 0)
+    {
+        _beginBatchReset();
+    }
+    else
+    {
+        _saveInFile();
+    }
+}
+
+void BatchTableModel::_beginInsertRows(int first, int last)
+{
+    if (m_batchDepth == 0)
+    {
+        beginInsertRows(QModelIndex{}, first, last);
+    }
+    else
+    {
+        _beginBatchReset();
+    }
+}
+
+void BatchTableModel::_endInsertRows()
+{
+    if (m_batchDepth == 0)
+    {
+        endInsertRows();
+    }
+}
+
+void BatchTableModel::_beginRemoveRows(int first, int last)
+{
+    if (m_batchDepth == 0)
+    {
+        beginRemoveRows(QModelIndex{}, first, last);
+    }
+    else
+    {
+        _beginBatchReset();
+    }
+}
+
+void BatchTableModel::_endRemoveRows()
+{
+    if (m_batchDepth == 0)
+    {
+        endRemoveRows();
+    }
+}
+
+void BatchTableModel::_emitDataChanged(
+        const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles)
+{
+    if (m_batchDepth == 0)
+    {
+        emit dataChanged(topLeft, bottomRight, roles);
+    }
+}
+
+void BatchTableModel::_beginBatchReset()
+{
+    if (!m_modifiedInBatch)
+    {
+        m_modifiedInBatch = true;
+        beginResetModel();
+    }
+}
+
+TableBatch::TableBatch(BatchTableModel *table)
+    : m_table(table)
+{
+    m_table->beginBatch();
+}
+
+TableBatch::~TableBatch()
+{
+    m_table->commitBatch();
+}
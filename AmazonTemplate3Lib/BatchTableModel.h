@@ -0,0 +1,52 @@
+#ifndef BATCHTABLEMODEL_H
+#define BATCHTABLEMODEL_H
+
+#include <QAbstractTableModel>
+
+// Table model saved in a file after each change. Between beginBatch() and
+// commitBatch() the changes only mark the table as modified: the views get
+// a single model reset and the file is written once when the outermost
+// batch is committed. Batches can be nested, they must not wait on the
+// event loop as the views are reset at the end only.
+class BatchTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit BatchTableModel(QObject *parent = nullptr);
+    void beginBatch();
+    void commitBatch();
+    bool isInBatch() const;
+
+protected:
+    virtual void _saveInFile() = 0;
+    virtual void _commitBatch(); // Called before the file is written, to sort or index the rows once
+    void _save(); // Saves now or when the batch is committed
+    void _beginInsertRows(int first, int last);
+    void _endInsertRows();
+    void _beginRemoveRows(int first, int last);
+    void _endRemoveRows();
+    void _emitDataChanged(const QModelIndex &topLeft
+                          , const QModelIndex &bottomRight
+                          , const QList<int> &roles = QList<int>{});
+
+private:
+    int m_batchDepth = 0;
+    bool m_modifiedInBatch = false; // The model reset was started
+    void _beginBatchReset();
+};
+
+// Opens a batch on a table until the end of the scope
+class TableBatch
+{
+public:
+    explicit TableBatch(BatchTableModel *table);
+    ~TableBatch();
+    TableBatch(const TableBatch &) = delete;
+    TableBatch &operator=(const TableBatch &) = delete;
+
+private:
+    BatchTableModel *m_table;
+};
+
+#endif // BATCHTABLEMODEL_H
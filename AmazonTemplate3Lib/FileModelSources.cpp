@@ -1,10 +1,13 @@
 #include "FileModelSources.h"
 
+const QStringList FileModelSources::NAME_FILTERS{
+    "*SOURCE*.xlsm", "*SOURCE.xlsm", "*SOURCE*.xlsx", "*SOURCE.xlsx"};
+
 FileModelSources::FileModelSources(const QString &dirPath, QObject *parent)
     : QFileSystemModel(parent)
 {
     setRootPath(dirPath);
-    setNameFilters(QStringList{"*SOURCE*.xlsm", "*SOURCE.xlsm", "*SOURCE*.xlsx", "*SOURCE.xlsx"});
+    setNameFilters(NAME_FILTERS);
     setNameFilterDisables(false);
 }
 
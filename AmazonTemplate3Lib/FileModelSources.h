@@ -7,6 +7,7 @@
 class FileModelSources : public QFileSystemModel
 {
 public:
+    static const QStringList NAME_FILTERS;
     FileModelSources(const QString &dirPath, QObject *parent = nullptr);
     QList<QFileInfo> getFileInfos() const;
     QStringList getFilePaths() const;
@@ -1,10 +1,13 @@
 #include "FileModelToFill.h"
 
+const QStringList FileModelToFill::NAME_FILTERS{
+    "*TOFILL*.xlsm", "*TOFILL.xlsm", "*TOFILL*.xlsx", "*TOFILL.xlsx"};
+
 FileModelToFill::FileModelToFill(const QString &dirPath, QObject *parent)
     : QFileSystemModel(parent)
 {
     setRootPath(dirPath);
-    setNameFilters(QStringList{"*TOFILL*.xlsm", "*TOFILL.xlsm", "*TOFILL*.xlsx", "*TOFILL.xlsx"});
+    setNameFilters(NAME_FILTERS);
     setNameFilterDisables(false);
 }
 
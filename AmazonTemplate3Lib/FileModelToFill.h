@@ -6,6 +6,7 @@
 class FileModelToFill : public QFileSystemModel
 {
 public:
+    static const QStringList NAME_FILTERS;
     FileModelToFill(const QString &dirPath, QObject *parent = nullptr);
     QList<QFileInfo> getFileInfos() const;
     QStringList getFilePaths() const;
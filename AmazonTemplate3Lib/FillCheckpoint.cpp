@@ -0,0 +1,264 @@
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+#include "FillCheckpoint.h"
+
+const QString FillCheckpoint::FILE_NAME{"fillCheckpoint.dat"};
+
+FillCheckpoint::FillCheckpoint(const QString &filePath, const QByteArray &inputsFingerprint)
+    : m_filePath(filePath)
+    , m_inputsFingerprint(inputsFingerprint)
+{
+}
+
+bool FillCheckpoint::load(
+        QHash<QString, QHash<QString, QHash<QString, QHash<QString, QString>>>> &countryCode_langCode_sku_fieldId_toValues
+        , QHash<QString, QHash<QString, QHash<QString, QString>>> &langCode_sku_fieldId_toValues)
+{
+    QFile file{m_filePath};
+    if (m_filePath.isEmpty() || !file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QDataStream stream{&file};
+    stream.setVersion(QDataStream::Qt_6_0);
+    qint32 version = 0;
+    QByteArray inputsFingerprint;
+    stream >> version;
+    if (version != VERSION)
+    {
+        return false;
+    }
+    stream >> inputsFingerprint;
+    if (inputsFingerprint != m_inputsFingerprint)
+    {
+        return false;
+    }
+    bool snapshotRead = false;
+    QSet<QString> workItemsDone;
+    QSet<QString> targetPathsDone;
+    QHash<QString, QHash<QString, QHash<QString, QHash<QString, QString>>>> countryCode_langCode_sku_fieldId_toValuesSaved;
+    QHash<QString, QHash<QString, QHash<QString, QString>>> langCode_sku_fieldId_toValuesSaved;
+    while (!stream.atEnd())
+    {
+        QByteArray record;
+        stream >> record;
+        if (stream.status() != QDataStream::Ok)
+        {
+            break; // Last record truncated by a crash, its fields are filled again
+        }
+        QDataStream streamRecord{record};
+        streamRecord.setVersion(QDataStream::Qt_6_0);
+        qint8 recordType = -1;
+        streamRecord >> recordType;
+        if (recordType == Snapshot)
+        {
+            streamRecord >> workItemsDone
+                         >> targetPathsDone
+                         >> countryCode_langCode_sku_fieldId_toValuesSaved
+                         >> langCode_sku_fieldId_toValuesSaved;
+            snapshotRead = streamRecord.status() == QDataStream::Ok;
+        }
+        else if (recordType == Progress && snapshotRead)
+        {
+            QString targetPath;
+            QStringList workItems;
+            bool targetDone = false;
+            QString countryCode;
+            QString langCode;
+            QHash<QString, QHash<QString, QString>> sku_fieldId_toValuesChanged;
+            QHash<QString, QHash<QString, QString>> sku_fieldId_toValueslangCommonChanged;
+            streamRecord >> targetPath
+                         >> workItems
+                         >> targetDone
+                         >> countryCode
+                         >> langCode
+                         >> sku_fieldId_toValuesChanged
+                         >> sku_fieldId_toValueslangCommonChanged;
+            if (streamRecord.status() != QDataStream::Ok)
+            {
+                break;
+            }
+            workItemsDone.unite(QSet<QString>{workItems.begin(), workItems.end()});
+            if (targetDone)
+            {
+                targetPathsDone.insert(targetPath);
+            }
+            _merge(countryCode_langCode_sku_fieldId_toValuesSaved[countryCode][langCode]
+                   , sku_fieldId_toValuesChanged);
+            _merge(langCode_sku_fieldId_toValuesSaved[langCode]
+                   , sku_fieldId_toValueslangCommonChanged);
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (!snapshotRead)
+    {
+        return false; // Truncated, the fill starts again
+    }
+    m_workItemsDone = workItemsDone;
+    m_targetPathsDone = targetPathsDone;
+    m_targetPath_workItemsPending.clear();
+    countryCode_langCode_sku_fieldId_toValues = countryCode_langCode_sku_fieldId_toValuesSaved;
+    langCode_sku_fieldId_toValues = langCode_sku_fieldId_toValuesSaved;
+    return true;
+}
+
+bool FillCheckpoint::save(
+        const QHash<QString, QHash<QString, QHash<QString, QHash<QString, QString>>>> &countryCode_langCode_sku_fieldId_toValues
+        , const QHash<QString, QHash<QString, QHash<QString, QString>>> &langCode_sku_fieldId_toValues)
+{
+    if (m_filePath.isEmpty())
+    {
+        return false;
+    }
+    QSaveFile file{m_filePath};
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    QByteArray record;
+    QDataStream streamRecord{&record, QIODevice::WriteOnly};
+    streamRecord.setVersion(QDataStream::Qt_6_0);
+    streamRecord << static_cast<qint8>(Snapshot)
+                 << m_workItemsDone
+                 << m_targetPathsDone
+                 << countryCode_langCode_sku_fieldId_toValues
+                 << langCode_sku_fieldId_toValues;
+    QDataStream stream{&file};
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << VERSION
+           << m_inputsFingerprint
+           << record;
+    if (!file.commit())
+    {
+        return false;
+    }
+    m_targetPath_workItemsPending.clear();
+    return true;
+}
+
+bool FillCheckpoint::appendProgress(
+        const QString &targetPath
+        , const QString &countryCode
+        , const QString &langCode
+        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesChanged
+        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommonChanged)
+{
+    if (m_filePath.isEmpty())
+    {
+        return false;
+    }
+    QFile file{m_filePath};
+    if (!file.exists() || !file.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        return false; // save() starts the journal
+    }
+    QByteArray record;
+    QDataStream streamRecord{&record, QIODevice::WriteOnly};
+    streamRecord.setVersion(QDataStream::Qt_6_0);
+    streamRecord << static_cast<qint8>(Progress)
+                 << targetPath
+                 << m_targetPath_workItemsPending.value(targetPath)
+                 << m_targetPathsDone.contains(targetPath)
+                 << countryCode
+                 << langCode
+                 << sku_fieldId_toValuesChanged
+                 << sku_fieldId_toValueslangCommonChanged;
+    QDataStream stream{&file};
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << record;
+    if (stream.status() != QDataStream::Ok || !file.flush())
+    {
+        return false;
+    }
+    m_targetPath_workItemsPending.remove(targetPath);
+    return true;
+}
+
+QHash<QString, QHash<QString, QString>> FillCheckpoint::changedValues(
+        const QHash<QString, QHash<QString, QString>> &sku_fieldId_valuesBefore
+        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_valuesAfter)
+{
+    QHash<QString, QHash<QString, QString>> sku_fieldId_valuesChanged;
+    for (auto it = sku_fieldId_valuesAfter.cbegin(); it != sku_fieldId_valuesAfter.cend(); ++it)
+    {
+        const auto &fieldId_valuesBefore = sku_fieldId_valuesBefore.value(it.key());
+        if (fieldId_valuesBefore == it.value())
+        {
+            continue; // Same data when not detached by a write
+        }
+        for (auto itField = it.value().cbegin(); itField != it.value().cend(); ++itField)
+        {
+            auto itBefore = fieldId_valuesBefore.constFind(itField.key());
+            if (itBefore == fieldId_valuesBefore.cend() || itBefore.value() != itField.value())
+            {
+                sku_fieldId_valuesChanged[it.key()][itField.key()] = itField.value();
+            }
+        }
+    }
+    return sku_fieldId_valuesChanged;
+}
+
+void FillCheckpoint::remove()
+{
+    if (!m_filePath.isEmpty())
+    {
+        QFile::remove(m_filePath);
+    }
+    m_workItemsDone.clear();
+    m_targetPathsDone.clear();
+    m_targetPath_workItemsPending.clear();
+}
+
+bool FillCheckpoint::isDone(
+        const QString &targetPath, const QString &filler, const QString &fieldId) const
+{
+    return m_workItemsDone.contains(_workItem(targetPath, filler, fieldId));
+}
+
+void FillCheckpoint::setDone(
+        const QString &targetPath, const QString &filler, const QString &fieldId)
+{
+    const QString &workItem = _workItem(targetPath, filler, fieldId);
+    m_workItemsDone.insert(workItem);
+    m_targetPath_workItemsPending[targetPath] << workItem;
+}
+
+bool FillCheckpoint::isTargetDone(const QString &targetPath) const
+{
+    return m_targetPathsDone.contains(targetPath);
+}
+
+void FillCheckpoint::setTargetDone(const QString &targetPath)
+{
+    m_targetPathsDone.insert(targetPath);
+}
+
+int FillCheckpoint::nDone() const
+{
+    return m_workItemsDone.size();
+}
+
+QString FillCheckpoint::_workItem(
+        const QString &targetPath, const QString &filler, const QString &fieldId)
+{
+    return targetPath + "\t" + filler + "\t" + fieldId;
+}
+
+void FillCheckpoint::_merge(
+        QHash<QString, QHash<QString, QString>> &sku_fieldId_values
+        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_valuesChanged)
+{
+    for (auto it = sku_fieldId_valuesChanged.cbegin(); it != sku_fieldId_valuesChanged.cend(); ++it)
+    {
+        auto &fieldId_values = sku_fieldId_values[it.key()];
+        for (auto itField = it.value().cbegin(); itField != it.value().cend(); ++itField)
+        {
+            fieldId_values[itField.key()] = itField.value();
+        }
+    }
+}
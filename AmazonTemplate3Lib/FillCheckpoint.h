@@ -0,0 +1,65 @@
+#ifndef FILLCHECKPOINT_H
+#define FILLCHECKPOINT_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+// Progress of a fill saved as fillCheckpoint.dat in the working directory:
+// the values of each market and the (target, filler, field) already done.
+// The file is a snapshot of all the values written by save(), followed by a
+// journal: each time a field is done for a target, appendProgress() adds the
+// cells this field changed, with the fields done since the previous record.
+// load() merges the journal over the snapshot, a truncated last record being
+// ignored. A fill stopped by an error or a crash resumes from
+// there when its inputs have the same fingerprint, then saves one snapshot
+// again so the journal is compacted. The file is removed once the FILLED
+// templates are written.
+class FillCheckpoint
+{
+public:
+    static const QString FILE_NAME;
+    static constexpr qint32 VERSION = 3;
+    FillCheckpoint() = default;
+    FillCheckpoint(const QString &filePath, const QByteArray &inputsFingerprint);
+    // Replaces the values by the saved ones, false if none for these inputs
+    bool load(QHash<QString, QHash<QString, QHash<QString, QHash<QString, QString>>>> &countryCode_langCode_sku_fieldId_toValues
+              , QHash<QString, QHash<QString, QHash<QString, QString>>> &langCode_sku_fieldId_toValues);
+    bool save(const QHash<QString, QHash<QString, QHash<QString, QHash<QString, QString>>>> &countryCode_langCode_sku_fieldId_toValues
+              , const QHash<QString, QHash<QString, QHash<QString, QString>>> &langCode_sku_fieldId_toValues);
+    // Appends the values changed in a target and its fields done since its last record
+    bool appendProgress(const QString &targetPath
+                        , const QString &countryCode
+                        , const QString &langCode
+                        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesChanged
+                        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommonChanged);
+    // Values of after that are new or different, fast on the SKUs still shared with before
+    static QHash<QString, QHash<QString, QString>> changedValues(
+            const QHash<QString, QHash<QString, QString>> &sku_fieldId_valuesBefore
+            , const QHash<QString, QHash<QString, QString>> &sku_fieldId_valuesAfter);
+    void remove();
+    bool isDone(const QString &targetPath, const QString &filler, const QString &fieldId) const;
+    void setDone(const QString &targetPath, const QString &filler, const QString &fieldId);
+    bool isTargetDone(const QString &targetPath) const;
+    void setTargetDone(const QString &targetPath);
+    int nDone() const;
+
+private:
+    enum RecordType : qint8
+    {
+        Snapshot
+        , Progress
+    };
+    QString m_filePath;
+    QByteArray m_inputsFingerprint;
+    QSet<QString> m_workItemsDone;
+    QSet<QString> m_targetPathsDone;
+    QHash<QString, QStringList> m_targetPath_workItemsPending; // Not in the journal yet
+    static QString _workItem(const QString &targetPath, const QString &filler, const QString &fieldId);
+    static void _merge(QHash<QString, QHash<QString, QString>> &sku_fieldId_values
+                       , const QHash<QString, QHash<QString, QString>> &sku_fieldId_valuesChanged);
+};
+
+#endif // FILLCHECKPOINT_H
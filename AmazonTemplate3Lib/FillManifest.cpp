@@ -0,0 +1,170 @@
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include "FillManifest.h"
+
+const QString FillManifest::FILE_NAME{"fillManifest.json"};
+
+FillManifest FillManifest::load(const QString &filePath)
+{
+    FillManifest manifest;
+    QFile file{filePath};
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return manifest;
+    }
+    const auto &object = QJsonDocument::fromJson(file.readAll()).object();
+    if (object["version"].toInt() != VERSION)
+    {
+        return manifest;
+    }
+    manifest.m_runFingerprint = QByteArray::fromHex(object["run"].toString().toLatin1());
+    const auto &skusObject = object["skus"].toObject();
+    for (auto it = skusObject.begin(); it != skusObject.end(); ++it)
+    {
+        manifest.m_sku_fingerprint[it.key()] = QByteArray::fromHex(it.value().toString().toLatin1());
+    }
+    const auto &filledObject = object["filled"].toObject();
+    for (auto it = filledObject.begin(); it != filledObject.end(); ++it)
+    {
+        const auto &stampObject = it.value().toObject();
+        FileStamp stamp;
+        stamp.size = stampObject["size"].toInteger(-1);
+        stamp.lastModifiedMs = stampObject["lastModified"].toInteger(-1);
+        manifest.m_filePath_stamp[it.key()] = stamp;
+    }
+    return manifest;
+}
+
+bool FillManifest::save(const QString &filePath) const
+{
+    QJsonObject skusObject;
+    for (auto it = m_sku_fingerprint.cbegin(); it != m_sku_fingerprint.cend(); ++it)
+    {
+        skusObject[it.key()] = QString::fromLatin1(it.value().toHex());
+    }
+    QJsonObject filledObject;
+    for (auto it = m_filePath_stamp.cbegin(); it != m_filePath_stamp.cend(); ++it)
+    {
+        filledObject[it.key()] = QJsonObject{
+            {"size", it.value().size}
+            , {"lastModified", it.value().lastModifiedMs}};
+    }
+    QJsonObject object{
+        {"version", VERSION}
+        , {"run", QString::fromLatin1(m_runFingerprint.toHex())}
+        , {"skus", skusObject}
+        , {"filled", filledObject}};
+    QSaveFile file{filePath};
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    file.write(QJsonDocument{object}.toJson(QJsonDocument::Indented));
+    return file.commit();
+}
+
+bool FillManifest::isEmpty() const
+{
+    return m_runFingerprint.isEmpty();
+}
+
+const QByteArray &FillManifest::runFingerprint() const
+{
+    return m_runFingerprint;
+}
+
+void FillManifest::setRunFingerprint(const QByteArray &fingerprint)
+{
+    m_runFingerprint = fingerprint;
+}
+
+QByteArray FillManifest::skuFingerprint(const QString &sku) const
+{
+    return m_sku_fingerprint.value(sku);
+}
+
+void FillManifest::setSkuFingerprint(const QString &sku, const QByteArray &fingerprint)
+{
+    m_sku_fingerprint[sku] = fingerprint;
+}
+
+QByteArray FillManifest::fingerprint() const
+{
+    QCryptographicHash hash{QCryptographicHash::Sha1};
+    hash.addData(m_runFingerprint);
+    QStringList skus{m_sku_fingerprint.keyBegin(), m_sku_fingerprint.keyEnd()};
+    skus.sort();
+    for (const auto &sku : std::as_const(skus))
+    {
+        hash.addData(sku.toUtf8());
+        hash.addData(m_sku_fingerprint[sku]);
+    }
+    return hash.result();
+}
+
+void FillManifest::recordFilled(const QString &filePath)
+{
+    m_filePath_stamp[QFileInfo{filePath}.absoluteFilePath()] = _stamp(filePath);
+}
+
+bool FillManifest::isFilledUnchanged(const QString &filePath) const
+{
+    const auto &absFilePath = QFileInfo{filePath}.absoluteFilePath();
+    auto it = m_filePath_stamp.constFind(absFilePath);
+    if (it == m_filePath_stamp.constEnd())
+    {
+        return false;
+    }
+    const auto &stamp = _stamp(filePath);
+    return stamp.size >= 0
+            && stamp.size == it.value().size
+            && stamp.lastModifiedMs == it.value().lastModifiedMs;
+}
+
+bool FillManifest::canRefill(
+        const FillManifest &current, const QStringList &filledPaths) const
+{
+    if (isEmpty() || m_runFingerprint != current.m_runFingerprint)
+    {
+        return false;
+    }
+    for (const auto &filledPath : filledPaths)
+    {
+        if (!isFilledUnchanged(filledPath))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+QSet<QString> FillManifest::changedSkus(const FillManifest &previous) const
+{
+    QSet<QString> skus;
+    for (auto it = m_sku_fingerprint.cbegin(); it != m_sku_fingerprint.cend(); ++it)
+    {
+        if (previous.m_sku_fingerprint.value(it.key()) != it.value())
+        {
+            skus.insert(it.key());
+        }
+    }
+    return skus;
+}
+
+FillManifest::FileStamp FillManifest::_stamp(const QString &filePath)
+{
+    FileStamp stamp;
+    QFileInfo fileInfo{filePath};
+    if (fileInfo.exists())
+    {
+        stamp.size = fileInfo.size();
+        stamp.lastModifiedMs = fileInfo.lastModified().toMSecsSinceEpoch();
+    }
+    return stamp;
+}
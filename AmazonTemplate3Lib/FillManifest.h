@@ -0,0 +1,48 @@
+#ifndef FILLMANIFEST_H
+#define FILLMANIFEST_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+// Fingerprints of the inputs of the last fill, saved as fillManifest.json in
+// the working directory once the FILLED templates are written. The run
+// fingerprint covers what all SKUs depend on (settings tables, keywords,
+// mandatory fields, templates) and each SKU has its own for its row, image
+// and custom instructions. When the run fingerprint is unchanged and the
+// FILLED templates were not modified since, a re-fill only sends the changed
+// SKUs to the fillers and reads the other values back from the FILLED files.
+class FillManifest
+{
+public:
+    static const QString FILE_NAME;
+    static constexpr int VERSION = 1;
+    static FillManifest load(const QString &filePath); // Empty if missing or unreadable
+    bool save(const QString &filePath) const;
+    bool isEmpty() const;
+    const QByteArray &runFingerprint() const;
+    void setRunFingerprint(const QByteArray &fingerprint);
+    QByteArray skuFingerprint(const QString &sku) const;
+    void setSkuFingerprint(const QString &sku, const QByteArray &fingerprint);
+    QByteArray fingerprint() const; // Run and SKU fingerprints together
+    void recordFilled(const QString &filePath); // Size and modification time once written
+    bool isFilledUnchanged(const QString &filePath) const;
+    // Called on the previous manifest with the one of the current inputs
+    bool canRefill(const FillManifest &current, const QStringList &filledPaths) const;
+    QSet<QString> changedSkus(const FillManifest &previous) const; // New SKUs included
+
+private:
+    struct FileStamp
+    {
+        qint64 size = -1;
+        qint64 lastModifiedMs = -1;
+    };
+    static FileStamp _stamp(const QString &filePath);
+    QByteArray m_runFingerprint;
+    QHash<QString, QByteArray> m_sku_fingerprint;
+    QHash<QString, FileStamp> m_filePath_stamp;
+};
+
+#endif // FILLMANIFEST_H
@@ -0,0 +1,116 @@
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QPainter>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QCoro/QCoroFuture>
+
+#include "ImagePreparer.h"
+
+const int ImagePreparer::LONG_EDGE_DEFAULT = 1536;
+const int ImagePreparer::QUALITY_DEFAULT = 85;
+
+ImagePreparer::ImagePreparer(
+        const QString &preparedDirPath, int longEdge, int quality)
+{
+    m_preparedDirPath = preparedDirPath;
+    m_longEdge = longEdge;
+    m_quality = quality;
+}
+
+QCoro::Task<QHash<QString, QString>> ImagePreparer::prepare(
+        const QStringList &imagePaths) const
+{
+    QHash<QString, QString> imagePath_preparedPath;
+    const QStringList imagePathsToPrepare{imagePaths};
+    if (imagePathsToPrepare.isEmpty())
+    {
+        co_return imagePath_preparedPath;
+    }
+    QDir{}.mkpath(m_preparedDirPath);
+    auto future = QtConcurrent::mapped(
+                imagePathsToPrepare
+                , [this](const QString &imagePath) -> QString {
+        return prepareImage(imagePath);
+    });
+    co_await future;
+    const auto &preparedPaths = future.results();
+    for (int i=0; i<imagePathsToPrepare.size(); ++i)
+    {
+        imagePath_preparedPath[imagePathsToPrepare[i]] = preparedPaths[i];
+    }
+    co_return imagePath_preparedPath;
+}
+
+QString ImagePreparer::prepareImage(const QString &imagePath) const
+{
+    QFile file{imagePath};
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return imagePath;
+    }
+    const QByteArray &imageBytes = file.readAll();
+    file.close();
+
+    QCryptographicHash hash{QCryptographicHash::Sha1};
+    hash.addData(imageBytes);
+    hash.addData(QByteArray::number(m_longEdge) + "_" + QByteArray::number(m_quality));
+    const QString &preparedPath = QDir{m_preparedDirPath}.absoluteFilePath(
+                QString::fromLatin1(hash.result().toHex()) + ".jpg");
+    if (QFileInfo::exists(preparedPath))
+    {
+        return preparedPath;
+    }
+
+    QImage image;
+    if (!image.loadFromData(imageBytes))
+    {
+        return imagePath;
+    }
+    if (qMax(image.width(), image.height()) > m_longEdge)
+    {
+        image = image.scaled(m_longEdge, m_longEdge, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    if (image.hasAlphaChannel())
+    {
+        QImage imageOpaque{image.size(), QImage::Format_RGB32};
+        imageOpaque.fill(Qt::white);
+        QPainter painter{&imageOpaque};
+        painter.drawImage(0, 0, image);
+        painter.end();
+        image = imageOpaque;
+    }
+    QByteArray preparedBytes;
+    QBuffer buffer{&preparedBytes};
+    buffer.open(QIODevice::WriteOnly);
+    if (!image.save(&buffer, "JPG", m_quality))
+    {
+        return imagePath;
+    }
+    buffer.close();
+    if (preparedBytes.size() >= imageBytes.size() && imageBytes.startsWith("\xFF\xD8"))
+    {
+        preparedBytes = imageBytes; // Already small, it is kept as it is
+    }
+
+    QSaveFile preparedFile{preparedPath};
+    if (!preparedFile.open(QIODevice::WriteOnly))
+    {
+        return imagePath;
+    }
+    preparedFile.write(preparedBytes);
+    if (!preparedFile.commit())
+    {
+        return imagePath;
+    }
+    return preparedPath;
+}
+
+const QString &ImagePreparer::preparedDirPath() const
+{
+    return m_preparedDirPath;
+}
@@ -0,0 +1,31 @@
+#ifndef IMAGEPREPARER_H
+#define IMAGEPREPARER_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QCoro/QCoroTask>
+
+// Prepares the images sent to the AI: they are downscaled so their long edge
+// is at most longEdge and encoded again as JPEG. The prepared images are
+// cached in preparedDirPath under a hash of the image content and settings
+// so each image is only encoded once. Encoding runs in the global thread pool.
+class ImagePreparer
+{
+public:
+    static const int LONG_EDGE_DEFAULT;
+    static const int QUALITY_DEFAULT;
+    ImagePreparer(const QString &preparedDirPath
+                  , int longEdge = LONG_EDGE_DEFAULT
+                  , int quality = QUALITY_DEFAULT);
+    QCoro::Task<QHash<QString, QString>> prepare(const QStringList &imagePaths) const; // image path => prepared path
+    QString prepareImage(const QString &imagePath) const; // Returns imagePath if it can't be prepared
+    const QString &preparedDirPath() const;
+
+private:
+    QString m_preparedDirPath;
+    int m_longEdge;
+    int m_quality;
+};
+
+#endif // IMAGEPREPARER_H
@@ -0,0 +1,137 @@
+#include <QSettings>
+
+#include "SelectConsensus.h"
+
+const int SelectConsensus::SAMPLES_MAX = 7;
+const int SelectConsensus::VERIFY_EVERY = 10;
+const double SelectConsensus::AGREEMENT_TRUSTED = 0.95;
+const double SelectConsensus::AGREEMENT_DISPUTED = 0.6;
+
+SelectConsensus::SelectConsensus(const QString &statsFilePath)
+{
+    m_statsFilePath = statsFilePath;
+    m_dirty = false;
+    QSettings settings{m_statsFilePath, QSettings::IniFormat};
+    const auto &fieldIds = settings.childGroups();
+    for (const auto &fieldId : fieldIds)
+    {
+        settings.beginGroup(fieldId);
+        auto &stats = m_fieldId_stats[fieldId];
+        stats.decisions = settings.value("decisions", 0).toInt();
+        stats.compared = settings.value("compared", 0).toInt();
+        stats.agreed = settings.value("agreed", 0).toInt();
+        settings.endGroup();
+    }
+}
+
+SelectConsensus::~SelectConsensus()
+{
+    save();
+}
+
+int SelectConsensus::samplesFirst(const QString &fieldId, int nPossibleValues) const
+{
+    QMutexLocker locker(&m_mutex);
+    const auto &stats = m_fieldId_stats.value(fieldId);
+    if (_isTrusted(stats, nPossibleValues))
+    {
+        return stats.decisions % VERIFY_EVERY == 0 ? 2 : 1;
+    }
+    if (_isDisputed(stats, nPossibleValues))
+    {
+        return 3;
+    }
+    return 2;
+}
+
+QString SelectConsensus::decide(
+        const QString &fieldId
+        , int nPossibleValues
+        , const QStringList &votes
+        , int nSamples) const
+{
+    if (votes.isEmpty())
+    {
+        return QString{};
+    }
+    QHash<QString, int> value_count;
+    QString leader;
+    for (const auto &vote : votes)
+    {
+        int count = ++value_count[vote];
+        if (count > value_count.value(leader))
+        {
+            leader = vote; // On a tie, the first value that reached the count
+        }
+    }
+    int countSecond = 0;
+    for (auto it = value_count.cbegin(); it != value_count.cend(); ++it)
+    {
+        if (it.key() != leader)
+        {
+            countSecond = qMax(countSecond, it.value());
+        }
+    }
+    QMutexLocker locker(&m_mutex);
+    bool trusted = _isTrusted(m_fieldId_stats.value(fieldId), nPossibleValues);
+    int leadNeeded = trusted ? 1 : 2;
+    if (value_count[leader] - countSecond >= leadNeeded || nSamples >= SAMPLES_MAX)
+    {
+        return leader;
+    }
+    return QString{};
+}
+
+void SelectConsensus::record(const QString &fieldId, const QStringList &votes)
+{
+    QMutexLocker locker(&m_mutex);
+    auto &stats = m_fieldId_stats[fieldId];
+    ++stats.decisions;
+    if (votes.size() >= 2)
+    {
+        ++stats.compared;
+        if (votes[0] == votes[1])
+        {
+            ++stats.agreed;
+        }
+    }
+    m_dirty = true;
+}
+
+void SelectConsensus::save()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_dirty)
+    {
+        return;
+    }
+    QSettings settings{m_statsFilePath, QSettings::IniFormat};
+    for (auto it = m_fieldId_stats.cbegin(); it != m_fieldId_stats.cend(); ++it)
+    {
+        settings.beginGroup(it.key());
+        settings.setValue("decisions", it.value().decisions);
+        settings.setValue("compared", it.value().compared);
+        settings.setValue("agreed", it.value().agreed);
+        settings.endGroup();
+    }
+    settings.sync();
+    m_dirty = false;
+}
+
+bool SelectConsensus::_isTrusted(const FieldStats &stats, int nPossibleValues) const
+{
+    return stats.compared >= _historyMin(nPossibleValues)
+            && stats.agreed >= AGREEMENT_TRUSTED * stats.compared;
+}
+
+bool SelectConsensus::_isDisputed(const FieldStats &stats, int nPossibleValues) const
+{
+    return stats.compared >= _historyMin(nPossibleValues)
+            && stats.agreed < AGREEMENT_DISPUTED * stats.compared;
+}
+
+int SelectConsensus::_historyMin(int nPossibleValues) const
+{
+    // Two replies agree by chance more often when there are few values
+    return nPossibleValues <= 2 ? 20 : 10;
+}
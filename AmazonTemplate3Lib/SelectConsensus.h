@@ -0,0 +1,47 @@
+#ifndef SELECTCONSENSUS_H
+#define SELECTCONSENSUS_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+// Decides how many AI replies are needed to select the value of a field.
+// Replies are drawn until a value leads the others by enough votes. The
+// share of selections where the two first replies agreed is kept per field
+// id across runs, so fields that always agree end up asked once while
+// ambiguous ones start with more replies.
+class SelectConsensus
+{
+public:
+    static const int SAMPLES_MAX;
+    static const int VERIFY_EVERY; // Trusted fields are still asked twice every n selections
+    static const double AGREEMENT_TRUSTED;
+    static const double AGREEMENT_DISPUTED;
+    explicit SelectConsensus(const QString &statsFilePath);
+    ~SelectConsensus();
+    int samplesFirst(const QString &fieldId, int nPossibleValues) const;
+    QString decide(const QString &fieldId
+                   , int nPossibleValues
+                   , const QStringList &votes
+                   , int nSamples) const; // Empty while more replies are needed
+    void record(const QString &fieldId, const QStringList &votes);
+    void save();
+
+private:
+    struct FieldStats
+    {
+        int decisions = 0;
+        int compared = 0;
+        int agreed = 0;
+    };
+    QString m_statsFilePath;
+    mutable QMutex m_mutex;
+    QHash<QString, FieldStats> m_fieldId_stats;
+    bool m_dirty;
+    bool _isTrusted(const FieldStats &stats, int nPossibleValues) const;
+    bool _isDisputed(const FieldStats &stats, int nPossibleValues) const;
+    int _historyMin(int nPossibleValues) const;
+};
+
+#endif // SELECTCONSENSUS_H
@@ -0,0 +1,326 @@
+#include "SkuFieldMatrix.h"
+
+const QString SkuFieldMatrix::EMPTY;
+
+SkuFieldMatrix::SkuFieldMatrix(const QStringList &fieldIds)
+{
+    for (const auto &fieldId : fieldIds)
+    {
+        if (!m_fieldId_column.contains(fieldId))
+        {
+            m_fieldId_column.insert(fieldId, m_fieldIds.size());
+            m_fieldIds << fieldId;
+        }
+    }
+}
+
+int SkuFieldMatrix::addRow(const QString &sku)
+{
+    auto it = m_sku_row.constFind(sku);
+    if (it != m_sku_row.constEnd())
+    {
+        return it.value(); // Values of a duplicate SKU are merged, the last one wins
+    }
+    int row = m_skus.size();
+    m_sku_row.insert(sku, row);
+    m_skus << sku;
+    m_cells.resize(m_cells.size() + m_fieldIds.size());
+    m_presenceBits.resize((m_cells.size() + 63) / 64, 0);
+    return row;
+}
+
+void SkuFieldMatrix::setValue(int row, int column, const QString &value)
+{
+    qsizetype index = _cellIndex(row, column);
+    m_cells[index] = value;
+    m_presenceBits[index / 64] |= quint64{1} << (index % 64);
+}
+
+int SkuFieldMatrix::rowCount() const
+{
+    return m_skus.size();
+}
+
+int SkuFieldMatrix::columnCount() const
+{
+    return m_fieldIds.size();
+}
+
+int SkuFieldMatrix::rowIndex(const QString &sku) const
+{
+    return m_sku_row.value(sku, -1);
+}
+
+int SkuFieldMatrix::columnIndex(const QString &fieldId) const
+{
+    return m_fieldId_column.value(fieldId, -1);
+}
+
+const QString &SkuFieldMatrix::sku(int row) const
+{
+    return m_skus[row];
+}
+
+const QString &SkuFieldMatrix::fieldId(int column) const
+{
+    return m_fieldIds[column];
+}
+
+bool SkuFieldMatrix::has(int row, int column) const
+{
+    if (row < 0 || column < 0)
+    {
+        return false;
+    }
+    qsizetype index = _cellIndex(row, column);
+    return (m_presenceBits[index / 64] >> (index % 64)) & 1;
+}
+
+const QString &SkuFieldMatrix::at(int row, int column) const
+{
+    if (!has(row, column))
+    {
+        return EMPTY;
+    }
+    return m_cells[_cellIndex(row, column)];
+}
+
+bool SkuFieldMatrix::contains(const QString &sku) const
+{
+    return m_sku_row.contains(sku);
+}
+
+SkuFieldMatrix::Row SkuFieldMatrix::operator[](const QString &sku) const
+{
+    return Row{this, rowIndex(sku)};
+}
+
+SkuFieldMatrix::Row SkuFieldMatrix::value(const QString &sku) const
+{
+    return Row{this, rowIndex(sku)};
+}
+
+qsizetype SkuFieldMatrix::size() const
+{
+    return m_skus.size();
+}
+
+bool SkuFieldMatrix::isEmpty() const
+{
+    return m_skus.isEmpty();
+}
+
+SkuFieldMatrix::const_iterator SkuFieldMatrix::cbegin() const
+{
+    return const_iterator{this, 0};
+}
+
+SkuFieldMatrix::const_iterator SkuFieldMatrix::cend() const
+{
+    return const_iterator{this, static_cast<int>(m_skus.size())};
+}
+
+SkuFieldMatrix::const_iterator SkuFieldMatrix::begin() const
+{
+    return cbegin();
+}
+
+SkuFieldMatrix::const_iterator SkuFieldMatrix::end() const
+{
+    return cend();
+}
+
+QHash<QString, QHash<QString, QString>> SkuFieldMatrix::toHash() const
+{
+    QHash<QString, QHash<QString, QString>> sku_fieldId_value;
+    for (int row=0; row<m_skus.size(); ++row)
+    {
+        auto &fieldId_value = sku_fieldId_value[m_skus[row]];
+        for (int column=0; column<m_fieldIds.size(); ++column)
+        {
+            if (has(row, column))
+            {
+                fieldId_value[m_fieldIds[column]] = m_cells[_cellIndex(row, column)];
+            }
+        }
+    }
+    return sku_fieldId_value;
+}
+
+SkuFieldMatrix SkuFieldMatrix::rows(const QSet<QString> &skus) const
+{
+    SkuFieldMatrix matrix{m_fieldIds};
+    for (int row=0; row<m_skus.size(); ++row)
+    {
+        if (skus.contains(m_skus[row]))
+        {
+            int rowMatrix = matrix.addRow(m_skus[row]);
+            for (int column=0; column<m_fieldIds.size(); ++column)
+            {
+                if (has(row, column))
+                {
+                    matrix.setValue(rowMatrix, column, m_cells[_cellIndex(row, column)]);
+                }
+            }
+        }
+    }
+    return matrix;
+}
+
+qsizetype SkuFieldMatrix::_cellIndex(int row, int column) const
+{
+    return qsizetype{row} * m_fieldIds.size() + column;
+}
+
+const QString &SkuFieldMatrix::const_iterator::key() const
+{
+    return m_matrix->m_skus[m_row];
+}
+
+SkuFieldMatrix::Row SkuFieldMatrix::const_iterator::value() const
+{
+    return Row{m_matrix, m_row};
+}
+
+SkuFieldMatrix::const_iterator &SkuFieldMatrix::const_iterator::operator++()
+{
+    ++m_row;
+    return *this;
+}
+
+bool SkuFieldMatrix::const_iterator::operator==(const const_iterator &other) const
+{
+    return m_matrix == other.m_matrix && m_row == other.m_row;
+}
+
+bool SkuFieldMatrix::const_iterator::operator!=(const const_iterator &other) const
+{
+    return !(*this == other);
+}
+
+SkuFieldMatrix::const_iterator::const_iterator(const SkuFieldMatrix *matrix, int row)
+    : m_matrix(matrix)
+    , m_row(row)
+{
+}
+
+SkuFieldMatrix::Row::Row(const SkuFieldMatrix *matrix, int row)
+    : m_matrix(matrix)
+    , m_row(row)
+{
+}
+
+const QString &SkuFieldMatrix::Row::sku() const
+{
+    if (m_row < 0)
+    {
+        return EMPTY;
+    }
+    return m_matrix->m_skus[m_row];
+}
+
+bool SkuFieldMatrix::Row::contains(const QString &fieldId) const
+{
+    return m_matrix->has(m_row, m_matrix->columnIndex(fieldId));
+}
+
+const QString &SkuFieldMatrix::Row::operator[](const QString &fieldId) const
+{
+    return m_matrix->at(m_row, m_matrix->columnIndex(fieldId));
+}
+
+QString SkuFieldMatrix::Row::value(
+        const QString &fieldId, const QString &defaultValue) const
+{
+    int column = m_matrix->columnIndex(fieldId);
+    if (!m_matrix->has(m_row, column))
+    {
+        return defaultValue;
+    }
+    return m_matrix->at(m_row, column);
+}
+
+qsizetype SkuFieldMatrix::Row::size() const
+{
+    qsizetype size = 0;
+    for (int column=0; column<m_matrix->columnCount(); ++column)
+    {
+        if (m_matrix->has(m_row, column))
+        {
+            ++size;
+        }
+    }
+    return size;
+}
+
+bool SkuFieldMatrix::Row::isEmpty() const
+{
+    return cbegin() == cend();
+}
+
+SkuFieldMatrix::Row::const_iterator SkuFieldMatrix::Row::cbegin() const
+{
+    const_iterator it{m_matrix, m_row, 0};
+    it._skipAbsent();
+    return it;
+}
+
+SkuFieldMatrix::Row::const_iterator SkuFieldMatrix::Row::cend() const
+{
+    return const_iterator{m_matrix, m_row, m_matrix->columnCount()};
+}
+
+SkuFieldMatrix::Row::const_iterator SkuFieldMatrix::Row::begin() const
+{
+    return cbegin();
+}
+
+SkuFieldMatrix::Row::const_iterator SkuFieldMatrix::Row::end() const
+{
+    return cend();
+}
+
+SkuFieldMatrix::Row::const_iterator::const_iterator(
+        const SkuFieldMatrix *matrix, int row, int column)
+    : m_matrix(matrix)
+    , m_row(row)
+    , m_column(column)
+{
+}
+
+void SkuFieldMatrix::Row::const_iterator::_skipAbsent()
+{
+    while (m_column < m_matrix->columnCount() && !m_matrix->has(m_row, m_column))
+    {
+        ++m_column;
+    }
+}
+
+const QString &SkuFieldMatrix::Row::const_iterator::key() const
+{
+    return m_matrix->m_fieldIds[m_column];
+}
+
+const QString &SkuFieldMatrix::Row::const_iterator::value() const
+{
+    return m_matrix->m_cells[m_matrix->_cellIndex(m_row, m_column)];
+}
+
+SkuFieldMatrix::Row::const_iterator &SkuFieldMatrix::Row::const_iterator::operator++()
+{
+    ++m_column;
+    _skipAbsent();
+    return *this;
+}
+
+bool SkuFieldMatrix::Row::const_iterator::operator==(const const_iterator &other) const
+{
+    return m_matrix == other.m_matrix
+            && m_row == other.m_row
+            && m_column == other.m_column;
+}
+
+bool SkuFieldMatrix::Row::const_iterator::operator!=(const const_iterator &other) const
+{
+    return !(*this == other);
+}
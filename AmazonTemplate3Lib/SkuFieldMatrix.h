@@ -0,0 +1,124 @@
+#ifndef SKUFIELDMATRIX_H
+#define SKUFIELDMATRIX_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+// Values read from a template, one row per SKU and one column per field id,
+// shared read-only by the fillers. The cells are stored in one dense array
+// with a presence bitmap: they share the strings of the template snapshot so
+// reading a value copies no string and no node is allocated per value. The
+// const API follows QHash<sku, QHash<fieldId, value>>, rows are iterated in
+// the order of the template.
+class SkuFieldMatrix
+{
+public:
+    class Row
+    {
+    public:
+        class const_iterator
+        {
+        public:
+            const QString &key() const;
+            const QString &value() const;
+            const_iterator &operator++();
+            bool operator==(const const_iterator &other) const;
+            bool operator!=(const const_iterator &other) const;
+
+        private:
+            friend class Row;
+            const_iterator(const SkuFieldMatrix *matrix, int row, int column);
+            void _skipAbsent();
+            const SkuFieldMatrix *m_matrix;
+            int m_row;
+            int m_column;
+        };
+        const QString &sku() const;
+        bool contains(const QString &fieldId) const;
+        const QString &operator[](const QString &fieldId) const;
+        QString value(const QString &fieldId, const QString &defaultValue = QString{}) const;
+        qsizetype size() const;
+        bool isEmpty() const;
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+        const_iterator begin() const;
+        const_iterator end() const;
+
+    private:
+        friend class SkuFieldMatrix;
+        Row(const SkuFieldMatrix *matrix, int row);
+        const SkuFieldMatrix *m_matrix;
+        int m_row;
+    };
+
+    class const_iterator
+    {
+    public:
+        const QString &key() const;
+        Row value() const;
+        const_iterator &operator++();
+        bool operator==(const const_iterator &other) const;
+        bool operator!=(const const_iterator &other) const;
+
+    private:
+        friend class SkuFieldMatrix;
+        const_iterator(const SkuFieldMatrix *matrix, int row);
+        const SkuFieldMatrix *m_matrix;
+        int m_row;
+    };
+
+    SkuFieldMatrix() = default;
+    explicit SkuFieldMatrix(const QStringList &fieldIds);
+    int addRow(const QString &sku); // Row of the SKU, added if new
+    void setValue(int row, int column, const QString &value);
+
+    int rowCount() const;
+    int columnCount() const;
+    int rowIndex(const QString &sku) const; // -1 if absent
+    int columnIndex(const QString &fieldId) const; // -1 if absent
+    const QString &sku(int row) const;
+    const QString &fieldId(int column) const;
+    bool has(int row, int column) const;
+    const QString &at(int row, int column) const;
+    template<typename Func>
+    void forEachInColumn(int column, Func func) const; // func(row, value) for each filled cell
+
+    bool contains(const QString &sku) const;
+    Row operator[](const QString &sku) const;
+    Row value(const QString &sku) const;
+    qsizetype size() const;
+    bool isEmpty() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    QHash<QString, QHash<QString, QString>> toHash() const;
+    SkuFieldMatrix rows(const QSet<QString> &skus) const; // Same columns, only these SKUs in the same order
+
+private:
+    QStringList m_fieldIds;
+    QHash<QString, int> m_fieldId_column;
+    QStringList m_skus;
+    QHash<QString, int> m_sku_row;
+    QList<QString> m_cells; // Index: row * columns + column
+    QList<quint64> m_presenceBits;
+    static const QString EMPTY;
+    qsizetype _cellIndex(int row, int column) const;
+};
+
+template<typename Func>
+void SkuFieldMatrix::forEachInColumn(int column, Func func) const
+{
+    for (int row=0; row<m_skus.size(); ++row)
+    {
+        if (has(row, column))
+        {
+            func(row, at(row, column));
+        }
+    }
+}
+
+#endif // SKUFIELDMATRIX_H
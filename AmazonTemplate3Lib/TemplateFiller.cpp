@@ -1,18 +1,30 @@
+#include <QCryptographicHash>
 #include <QFileInfo>
 #include <QRegularExpression>
 #include <QDirIterator>
 #include <QHash>
-#include <QMutex>
+
+#include <exception>
+#include <vector>
 
 #include "AttributesMandatoryAiTable.h"
 #include "AttributesMandatoryTable.h"
 
 #include "AiFailureTable.h"
+#include "AiReplyStore.h"
+#include "AiScheduler.h"
+#include "AiTelemetry.h"
 #include "AttributeEquivalentTable.h"
 #include "AttributeFlagsTable.h"
 #include "AttributePossibleMissingTable.h"
 #include "AttributeValueReplacedTable.h"
 #include "ExceptionTemplate.h"
+#include "SelectConsensus.h"
+#include "ImagePreparer.h"
+#include "Tracer.h"
+#include "TemplateSnapshot.h"
+#include "XlsxStreamReader.h"
+#include "XlsxTemplateWriter.h"
 #include "TemplateFiller.h"
 
 const QHash<QString, QSet<QString>> TemplateFiller::SHEETS_MANDATORY{
@@ -28,6 +40,33 @@ const QHash<QString, QSet<QString>> TemplateFiller::SHEETS_MANDATORY{
     , {"データ定義", {"必須"}}
 };
 
+const QStringList TemplateFiller::SHEETS_TEMPLATE{
+    "Template"
+    , "Vorlage"
+    , "Modèle"
+    , "Sjabloon"
+    , "Mall"
+    , "Szablon"
+    , "Plantilla"
+    , "Modello"
+    , "Şablon"
+    , "Gabarit"
+    , "テンプレート"
+};
+
+const QStringList TemplateFiller::SHEETS_VALID_VALUES{
+    "Valeurs valides"
+    , "Valid Values"
+    , "Valori validi"
+    , "Geldige waarden"
+    , "Gültige Werte"
+    , "Giltiga värden"
+    , "Valores válidos"
+    , "Poprawne wartości"
+    , "Geçerli Değerler"
+    , "推奨値"
+};
+
 const QSet<QString> TemplateFiller::VALUES_MANDATORY
     = []() -> QSet<QString>
 {
@@ -43,6 +82,38 @@ const QSet<QString> TemplateFiller::VALUES_MANDATORY
     return values;
 }();
 
+// The tables of a common directory are shared by the TemplateFiller alive at
+// the same time, as the collections filled concurrently by the command line,
+// so each of their files is only written from one model
+template<typename Table>
+static QSharedPointer<Table> sharedTable(const QString &commonSettingsDir)
+{
+    static QHash<QString, QWeakPointer<Table>> dirPath_table;
+    const QString &dirPath = QDir{commonSettingsDir}.absolutePath();
+    auto table = dirPath_table.value(dirPath).toStrongRef();
+    if (table.isNull())
+    {
+        table = QSharedPointer<Table>{new Table{commonSettingsDir}, &QObject::deleteLater};
+        dirPath_table[dirPath] = table;
+    }
+    return table;
+}
+
+// Same for the agreement stats of the AI selections, saved with absolute
+// counters so two instances on one file would lose each other's selections
+static QSharedPointer<SelectConsensus> sharedSelectConsensus(const QString &statsFilePath)
+{
+    static QHash<QString, QWeakPointer<SelectConsensus>> filePath_selectConsensus;
+    const QString &filePath = QFileInfo{statsFilePath}.absoluteFilePath();
+    auto selectConsensus = filePath_selectConsensus.value(filePath).toStrongRef();
+    if (selectConsensus.isNull())
+    {
+        selectConsensus = QSharedPointer<SelectConsensus>::create(filePath);
+        filePath_selectConsensus[filePath] = selectConsensus;
+    }
+    return selectConsensus;
+}
+
 TemplateFiller::TemplateFiller(
         const QString &workingDirCommon
         , const QString &templateFromPath
@@ -52,12 +123,9 @@ TemplateFiller::TemplateFiller(
 {
     m_age = AbstractFiller::Adult;
     m_gender = AbstractFiller::UndefinedGender;
+    m_incremental = false;
     m_mandatoryAttributesTable = nullptr;
     m_mandatoryAttributesAiTable = nullptr;
-    m_attributeEquivalentTable = nullptr;
-    m_attributeFlagsTable = nullptr;
-    m_attributePossibleMissingTable = nullptr;
-    m_attributeValueReplacedTable = nullptr;
     m_aiFailureTable = nullptr;
     setTemplates(workingDirCommon
                  , templateFromPath
@@ -81,9 +149,9 @@ void TemplateFiller::setTemplates(
 {
     qDebug() << "setTemplates start";
     m_skuPattern_customInstructions = skuPattern_customInstructions;
-    QXlsx::Document doc(templateFromPath);
+    const auto &snapshotFrom = _snapshot(templateFromPath);
     qDebug() << "Doc loaded";
-    const auto &productType = _get_productType(doc); // TODO Exception empty file + ma
+    const auto &productType = snapshotFrom->productType; // TODO Exception empty file + ma
     qDebug() << "Product type:" << productType;
     if (productType.isEmpty())
     {
@@ -105,15 +173,34 @@ void TemplateFiller::setTemplates(
     m_workingDirCommon = commonSettingsDir;
     m_workingDir = QFileInfo{m_templateFromPath}.dir();
     m_workingDirImage = m_workingDir.absoluteFilePath("images");
+    m_selectConsensus = sharedSelectConsensus(
+                m_workingDirCommon.absoluteFilePath("aiSelectConsensus.ini"));
+    {
+        auto settings = settingsCommon();
+        m_imagePreparer = QSharedPointer<ImagePreparer>::create(
+                    m_workingDirImage.absoluteFilePath(".prepared")
+                    , settings->value("imageLongEdge", ImagePreparer::LONG_EDGE_DEFAULT).toInt()
+                    , settings->value("imageQuality", ImagePreparer::QUALITY_DEFAULT).toInt());
+        settings->beginGroup("aiRateLimits");
+        const auto &models = settings->childGroups();
+        for (const auto &model : models)
+        {
+            AiScheduler::instance()->setLimits(
+                        model
+                        , settings->value(model + "/requestsPerMinute", 0).toInt()
+                        , settings->value(model + "/tokensPerMinute", 0).toInt()
+                        , settings->value(model + "/tokensPerRequest", AiScheduler::TOKENS_PER_REQUEST_DEFAULT).toInt());
+        }
+        settings->endGroup();
+    }
     _clearAttributeManagers();
     m_mandatoryAttributesAiTable = new AttributesMandatoryAiTable;
-    auto all_fieldId_index = _get_fieldId_index(doc);
+    auto all_fieldId_index = snapshotFrom->fieldId_index;
     for (const auto &templateToPath : m_templateToPaths)
     {
         if (templateToPath != m_templateFromPath)
         {
-            QXlsx::Document docTo(templateToPath);
-            const auto &fieldId_index_to = _get_fieldId_index(docTo);
+            const auto &fieldId_index_to = _snapshot(templateToPath)->fieldId_index;
             for (auto it = fieldId_index_to.cbegin(); it != fieldId_index_to.cend(); ++it)
             {
                 if (!all_fieldId_index.contains(it.key()))
@@ -130,22 +217,25 @@ void TemplateFiller::setTemplates(
     qDebug() << "Got mandatory fields.";
 
     qDebug() << "Allocating AttributePossibleMissingTable...";
-    m_attributePossibleMissingTable = new AttributePossibleMissingTable{commonSettingsDir};
+    m_attributePossibleMissingTable = sharedTable<AttributePossibleMissingTable>(commonSettingsDir);
     qDebug() << "Allocating AttributeValueReplacedTable...";
-    m_attributeValueReplacedTable = new AttributeValueReplacedTable{commonSettingsDir};
+    m_attributeValueReplacedTable = sharedTable<AttributeValueReplacedTable>(commonSettingsDir);
     qDebug() << "Allocating AttributesMandatoryTable...";
     m_mandatoryAttributesTable = new AttributesMandatoryTable{
             commonSettingsDir, productType, fieldIdMandatory, previousFieldIdMandatory, all_fieldId_index};
     qDebug() << "Allocating AttributeEquivalentTable...";
-    m_attributeEquivalentTable = new AttributeEquivalentTable{commonSettingsDir};
+    m_attributeEquivalentTable = sharedTable<AttributeEquivalentTable>(commonSettingsDir);
     qDebug() << "Allocating AttributeFlagsTable...";
-    m_attributeFlagsTable = new AttributeFlagsTable{commonSettingsDir};
+    m_attributeFlagsTable = sharedTable<AttributeFlagsTable>(commonSettingsDir);
     qDebug() << "Allocating AiFailureTable...";
     m_aiFailureTable = new AiFailureTable{};
     m_marketplaceFrom = _get_marketplaceFrom();
     qDebug() << "Recording attributes not recorded yet...";
-    m_attributeFlagsTable->recordAttributeNotRecordedYet(m_marketplaceFrom, fieldIdMandatory);
-    m_attributeFlagsTable->recordAttributeNotRecordedYet(m_marketplaceFrom, m_mandatoryAttributesTable->getMandatoryIds());
+    {
+        TableBatch batchFlags{m_attributeFlagsTable.data()}; // Also committed if the exception is raised
+        m_attributeFlagsTable->recordAttributeNotRecordedYet(m_marketplaceFrom, fieldIdMandatory);
+        m_attributeFlagsTable->recordAttributeNotRecordedYet(m_marketplaceFrom, m_mandatoryAttributesTable->getMandatoryIds());
+    }
     qDebug() << "Connecting mandatory attributes table...";
     m_connectionFlagsTable = m_mandatoryAttributesTable->connect(m_mandatoryAttributesTable,
                               &AttributesMandatoryTable::dataChanged,
@@ -172,24 +262,12 @@ void TemplateFiller::_clearAttributeManagers()
     if (m_attributeEquivalentTable != nullptr)
     {
         m_attributeEquivalentTable->disconnect(m_connectionFlagsTable);
-        m_attributeEquivalentTable->deleteLater();
-    }
-    m_attributeEquivalentTable = nullptr;
-    if (m_attributeFlagsTable != nullptr)
-    {
-        m_attributeFlagsTable->deleteLater();
-    }
-    m_attributeFlagsTable = nullptr;
-    if (m_attributePossibleMissingTable != nullptr)
-    {
-        m_attributePossibleMissingTable->deleteLater();
-    }
-    m_attributePossibleMissingTable = nullptr;
-    if (m_attributeValueReplacedTable != nullptr)
-    {
-        m_attributeValueReplacedTable->deleteLater();
     }
-    m_attributeValueReplacedTable = nullptr;
+    // Deleted later once no other TemplateFiller uses them
+    m_attributeEquivalentTable.reset();
+    m_attributeFlagsTable.reset();
+    m_attributePossibleMissingTable.reset();
+    m_attributeValueReplacedTable.reset();
     if (m_aiFailureTable != nullptr)
     {
         m_aiFailureTable->deleteLater();
@@ -212,9 +290,7 @@ QSet<QString> TemplateFiller::getAllFieldIds() const
     QSet<QString> allFieldIds;
     for (const auto &templatePath : _get_allTemplatePaths())
     {
-        QXlsx::Document doc{templatePath};
-        const auto &fieldId_index = _get_fieldId_index(doc);
-        const auto &fieldIds = fieldId_index.keys();
+        const auto &fieldIds = _snapshot(templatePath)->fieldId_index.keys();
         for (const auto &fieldId : fieldIds)
         {
             allFieldIds.insert(fieldId);
@@ -225,26 +301,22 @@ QSet<QString> TemplateFiller::getAllFieldIds() const
 
 void TemplateFiller::checkParentSkus()
 {
-    QXlsx::Document document(m_templateFromPath);
-    _selectTemplateSheet(document);
-    const auto &fieldId_index = _get_fieldId_index(document);
+    const auto &snapshot = _snapshot(m_templateFromPath);
+    const auto &fieldId_index = snapshot->fieldId_index;
     int indColSku = _getIndColSku(fieldId_index);
     int indColSkuParent = _getIndColSkuParent(fieldId_index);
     QSet<QString> parentsDone;
     QSet<QString> skus;
     QString lastParent;
-    const auto &dim = document.dimension();
-    int lastRow = dim.lastRow();
-    auto version = _getDocumentVersion(document);
-    int row = _getRowFieldId(version) + 1;
+    int lastRow = snapshot->lastRow;
+    int row = _getRowFieldId(snapshot->version) + 1;
     for (int i=row; i<lastRow; ++i)
     {
-        auto cellSku = document.cellAt(i+1, indColSku + 1);
-        if (!cellSku)
+        if (!snapshot->hasCell(i, indColSku))
         {
             break;
         }
-        QString sku{cellSku->value().toString()};
+        const QString &sku = snapshot->cellVal(i, indColSku);
         if (sku.startsWith("ABC"))
         {
             continue;
@@ -264,10 +336,9 @@ void TemplateFiller::checkParentSkus()
                 exception.raise();
             }
         }
-        auto cellSkuParent = document.cellAt(i+1, indColSkuParent + 1);
-        if (cellSkuParent)
+        if (snapshot->hasCell(i, indColSkuParent))
         {
-            QString skuParent{cellSkuParent->value().toString()};
+            const QString &skuParent = snapshot->cellVal(i, indColSkuParent);
             if (!lastParent.isEmpty()
                     && skuParent != lastParent
                     && parentsDone.contains(skuParent))
@@ -413,27 +484,23 @@ QHash<QString, QString> TemplateFiller::checkPreviewImages()
         const auto &baseName = imageFileInfo.baseName();
         existingImageBaseNames.insert(baseName);
     }
-    QXlsx::Document document(m_templateFromPath);
-    _selectTemplateSheet(document);
-    const auto &fieldId_index = _get_fieldId_index(document);
-    const auto &parentSku_skus = _get_parentSku_skus(document);
+    const auto &snapshot = _snapshot(m_templateFromPath);
+    const auto &fieldId_index = snapshot->fieldId_index;
+    const auto &parentSku_skus = _get_parentSku_skus(*snapshot);
     int indColSku = _getIndColSku(fieldId_index);
     int indColSkuParent = _getIndColSkuParent(fieldId_index);
     int indColColor = _getIndColColorName(fieldId_index);
     QHash<QString, QSet<QString>> parent_color;
-    const auto &dim = document.dimension();
-    int lastRow = dim.lastRow();
-    auto version = _getDocumentVersion(document);
-    int row = _getRowFieldId(version) + 1;
+    int lastRow = snapshot->lastRow;
+    int row = _getRowFieldId(snapshot->version) + 1;
     QSet<QString> missingImageBaseNames;
     for (int i=row; i<lastRow; ++i)
     {
-        auto cellSku = document.cellAt(i+1, indColSku + 1);
-        if (!cellSku)
+        if (!snapshot->hasCell(i, indColSku))
         {
             break;
         }
-        QString sku{cellSku->value().toString()};
+        const QString &sku = snapshot->cellVal(i, indColSku);
         if (sku.startsWith("ABC") || sku.isEmpty())
         {
             continue;
@@ -443,18 +510,8 @@ QHash<QString, QString> TemplateFiller::checkPreviewImages()
         {
             continue;
         }
-        auto cellSkuParent = document.cellAt(i+1, indColSkuParent + 1);
-        QString color;
-        QString skuParent;
-        if (cellSkuParent)
-        {
-            skuParent = cellSkuParent->value().toString();
-        }
-        auto cellColor = document.cellAt(i+1, indColColor + 1);
-        if (cellColor)
-        {
-            color = cellColor->value().toString();
-        }
+        const QString &skuParent = snapshot->cellVal(i, indColSkuParent);
+        const QString &color = snapshot->cellVal(i, indColColor);
         QString skuImageBaseName;
         if (skuParent.isEmpty())
         {
@@ -505,9 +562,7 @@ TemplateFiller::checkPossibleValues()
     QSet<QString> allFieldIds;
     for (const auto &filePath : filePaths)
     {
-        QXlsx::Document doc(filePath);
-        const auto &fieldId_possibleValues = _get_fieldId_possibleValues(doc);
-        const auto &curFieldIds = fieldId_possibleValues.keys();
+        const auto &curFieldIds = _snapshot(filePath)->fieldId_possibleValues.keys();
         for (const auto &fieldId : curFieldIds)
         {
             allFieldIds.insert(fieldId);
@@ -518,14 +573,15 @@ TemplateFiller::checkPossibleValues()
             marketplace_countryCode_langCode_productType_fieldId_possibleValues;
     allFieldIds.intersect(m_mandatoryAttributesTable->getMandatoryIds());
     bool addedMissing = false;
+    TableBatch batchMissing{m_attributePossibleMissingTable.data()}; // Also committed if the exception is raised
     for (const auto &filePath : filePaths)
     {
-        QXlsx::Document doc(filePath);
+        const auto &snapshot = _snapshot(filePath);
         const auto &countryCode = _get_countryCode(filePath);
         const auto &langCode = _get_langCode(filePath);
-        const auto &marketplace = _get_marketplace(doc);
-        const auto &productType = _get_productType(doc);
-        const auto &fieldId_possibleValues = _get_fieldId_possibleValues(doc);
+        const auto &marketplace = snapshot->marketplace;
+        const auto &productType = snapshot->productType;
+        const auto &fieldId_possibleValues = snapshot->fieldId_possibleValues;
         for (auto it = fieldId_possibleValues.begin();
              it != fieldId_possibleValues.end(); ++it)
         {
@@ -541,8 +597,7 @@ TemplateFiller::checkPossibleValues()
         }
         const auto &curFieldIdsPossibleList = fieldId_possibleValues.keys();
         QSet<QString> curFieldIdsPossible{curFieldIdsPossibleList.begin(), curFieldIdsPossibleList.end()};
-        const auto &fieldId_index = _get_fieldId_index(doc);
-        const auto &curFieldIdsList = fieldId_index.keys();
+        const auto &curFieldIdsList = snapshot->fieldId_index.keys();
         QSet<QString> curFieldIds{curFieldIdsList.begin(), curFieldIdsList.end()};
         QSet<QString> missingFieldIds = allFieldIds;
         missingFieldIds.intersect(curFieldIds);
@@ -603,9 +658,9 @@ void TemplateFiller::buildAttributes()
     for (const auto &templatePath : templatePaths)
     {
         TemplateInfo infos;
-        QXlsx::Document doc{templatePath};
-        infos.productType = _get_productType(doc);
-        infos.marketplace = _get_marketplace(doc);
+        const auto &snapshot = _snapshot(templatePath);
+        infos.productType = snapshot->productType;
+        infos.marketplace = snapshot->marketplace;
         infos.countryCode = _get_countryCode(templatePath);
         infos.langCode = _get_langCode(templatePath);
         templatePath_infos[templatePath] = infos;
@@ -652,8 +707,8 @@ void TemplateFiller::buildAttributes()
 void TemplateFiller::checkColumnsFilled()
 {
     //Q_ASSERT(m_marketplace_attributeId_attributeInfos.size() > 0); // Build attribute should have been called
-    QXlsx::Document doc{m_templateFromPath};
-    const auto &marketplace = _get_marketplace(doc);
+    const auto &snapshot = _snapshot(m_templateFromPath);
+    const auto &marketplace = snapshot->marketplace;
     const auto &fieldIds = m_mandatoryAttributesTable->getMandatoryIds();
     QSet<QString> fieldIdsNeededAll;
     QSet<QString> fieldIdsNeededChildren;
@@ -677,18 +732,16 @@ void TemplateFiller::checkColumnsFilled()
             fieldIdsNeededNoParent.insert(fieldId);
         }
     }
-    const auto &dim = doc.dimension();
-    int lastRow = dim.lastRow();
-    auto version = _getDocumentVersion(doc);
-    int row = _getRowFieldId(version) + 1;
-    const auto &fieldId_index = _get_fieldId_index(doc);
-    const auto &parentSku_skus = _get_parentSku_skus(doc);
+    int lastRow = snapshot->lastRow;
+    int row = _getRowFieldId(snapshot->version) + 1;
+    const auto &fieldId_index = snapshot->fieldId_index;
+    const auto &parentSku_skus = _get_parentSku_skus(*snapshot);
     int indColSku = _getIndColSku(fieldId_index);
     QHash<QString, QSet<QString>> fieldIdsWithMissingValue;
     QHash<QString, QSet<QString>> fieldIdsShouldNotHaveValue;
     for (int i=row; i<lastRow; ++i)
     {
-        const auto &sku = _get_cellVal(doc, i, indColSku);
+        const auto &sku = snapshot->cellVal(i, indColSku);
         if (sku.startsWith("ABC"))
         {
             continue;
@@ -704,7 +757,7 @@ void TemplateFiller::checkColumnsFilled()
             if (fieldId_index.contains(fieldId))
             {
                 int colIndex = fieldId_index[fieldId];
-                const auto &celVal = _get_cellVal(doc, i, colIndex);
+                const auto &celVal = snapshot->cellVal(i, colIndex);
                 if (celVal.isEmpty())
                 {
                     fieldIdsWithMissingValue[fieldId].insert(sku);
@@ -718,7 +771,7 @@ void TemplateFiller::checkColumnsFilled()
                 if (fieldId_index.contains(fieldId))
                 {
                     int colIndex = fieldId_index[fieldId];
-                    const auto &celVal = _get_cellVal(doc, i, colIndex);
+                    const auto &celVal = snapshot->cellVal(i, colIndex);
                     if (!celVal.isEmpty())
                     {
                         fieldIdsShouldNotHaveValue[fieldId].insert(sku);
@@ -759,23 +812,88 @@ void TemplateFiller::checkColumnsFilled()
 
 QCoro::Task<void> TemplateFiller::fillValues()
 {
+    TraceSpan spanFill{"fillValues"};
+    spanFill.setArg("template", m_templateFromPath);
+    AiTelemetry::Run telemetryRun{m_workingDir.absoluteFilePath(AiTelemetry::FILE_NAME)};
     m_aiFailureTable->clear();
-    buildAttributes();
-    m_sku_imagePreviewFilePath = checkPreviewImages();
-    co_await _readAgeGender();
-    _fillValuesSources();
-    m_sku_fieldId_fromValues = _get_sku_fieldId_fromValues(m_templateFromPath);
+    {
+        TraceSpan span{"buildAttributes"};
+        buildAttributes();
+    }
+    {
+        TraceSpan span{"checkPreviewImages"};
+        m_sku_imagePreviewFilePath = checkPreviewImages();
+        span.setCounter("rows", m_sku_imagePreviewFilePath.size());
+    }
+    {
+        TraceSpan span{"readAgeGender"};
+        co_await _readAgeGender();
+    }
+    {
+        TraceSpan span{"readSources"};
+        _fillValuesSources();
+        span.setCounter("templates", m_templateSourcePaths.size());
+    }
+    {
+        TraceSpan span{"readFromValues"};
+        m_sku_fieldId_fromValues = _get_sku_fieldId_fromValues(m_templateFromPath);
+        span.setCounter("rows", m_sku_fieldId_fromValues.size());
+    }
     const auto &mandatoryFieldIds = m_mandatoryAttributesTable->getMandatoryIds();
     QStringList sortedFieldIds{mandatoryFieldIds.begin(), mandatoryFieldIds.end()};
     sortedFieldIds.sort();
+    {
+        TraceSpan span{"routeFillers"};
+        const auto &attributeId_attributeInfos = m_marketplace_attributeId_attributeInfos[m_marketplaceFrom];
+        QList<const Attribute *> position_attribute;
+        for (const auto &fieldId : std::as_const(sortedFieldIds))
+        {
+            position_attribute << attributeId_attributeInfos.value(fieldId).data();
+        }
+        m_fillerDispatch = FillerDispatch{
+                this, m_marketplaceFrom, sortedFieldIds, position_attribute, AbstractFiller::ALL_FILLERS_SORTED};
+        qDebug().noquote() << m_fillerDispatch.dump();
+        span.setCounter("fields", sortedFieldIds.size());
+    }
 
-    QXlsx::Document document(m_templateFromPath);
-    const auto &parentSku_variation_skus = _get_parentSku_variation_skus(document);
-    const auto &marketplaceFrom = _get_marketplace(document);
-    const auto &productTypeFrom = _get_productType(document);
+    const auto &snapshotFrom = _snapshot(m_templateFromPath);
+    const auto &parentSku_variation_skus = _get_parentSku_variation_skus(*snapshotFrom);
+    const auto &productTypeFrom = snapshotFrom->productType;
     const auto &langCodeFrom = _get_langCode(m_templateFromPath);
     const auto &countryCodeFrom = _get_countryCode(m_templateFromPath);
 
+    QSet<QString> skusToFill;
+    {
+        TraceSpan span{"fingerprintInputs"};
+        m_fillManifest = _buildFillManifest(sortedFieldIds);
+        m_skusReused.clear();
+        if (m_incremental)
+        {
+            const auto &fillManifestPrevious = FillManifest::load(
+                        m_workingDir.absoluteFilePath(FillManifest::FILE_NAME));
+            QStringList filledPaths;
+            for (const auto &targetPath : std::as_const(m_templateToPaths))
+            {
+                filledPaths << _get_filledPath(targetPath);
+            }
+            if (fillManifestPrevious.canRefill(m_fillManifest, filledPaths))
+            {
+                skusToFill = _get_skusWithFamilies(
+                            m_fillManifest.changedSkus(fillManifestPrevious), parentSku_variation_skus);
+                for (auto it = m_sku_fieldId_fromValues.cbegin();
+                     it != m_sku_fieldId_fromValues.cend(); ++it)
+                {
+                    if (!skusToFill.contains(it.key()))
+                    {
+                        m_skusReused.insert(it.key());
+                    }
+                }
+            }
+        }
+        span.setCounter("rowsReused", m_skusReused.size());
+    }
+
+    TraceSpan spanDescriptions{"fillValuesForAi"};
     co_await AbstractFiller::fillValuesForAi(this
                                              , parentSku_variation_skus
                                              , productTypeFrom
@@ -787,73 +905,294 @@ QCoro::Task<void> TemplateFiller::fillValues()
                                              , m_sku_fieldId_fromValues
                                              , m_sku_attribute_valuesForAi);
     Q_ASSERT(m_sku_attribute_valuesForAi.begin().value().size() > 0);
+    AiReplyStore::instance()->flush();
+    spanDescriptions.setCounter("rows", m_sku_attribute_valuesForAi.size());
+
+    {
+        TraceSpan span{"resumeCheckpoint"};
+        QCryptographicHash hashInputs{QCryptographicHash::Sha1};
+        hashInputs.addData(m_fillManifest.fingerprint());
+        QStringList skusReused{m_skusReused.begin(), m_skusReused.end()};
+        skusReused.sort();
+        hashInputs.addData(skusReused.join("\n").toUtf8());
+        m_fillCheckpoint = FillCheckpoint{
+                m_workingDir.absoluteFilePath(FillCheckpoint::FILE_NAME), hashInputs.result()};
+        m_countryCode_langCode_sku_fieldId_toValues.clear();
+        m_langCode_sku_fieldId_toValues.clear();
+        if (m_fillCheckpoint.load(m_countryCode_langCode_sku_fieldId_toValues
+                                  , m_langCode_sku_fieldId_toValues))
+        {
+            qDebug() << "TemplateFiller resuming from checkpoint, fields done:" << m_fillCheckpoint.nDone();
+        }
+        // One snapshot of the values restored, the progress is appended to it
+        m_fillCheckpoint.save(m_countryCode_langCode_sku_fieldId_toValues, m_langCode_sku_fieldId_toValues);
+        span.setCounter("fieldsDone", m_fillCheckpoint.nDone());
+    }
+
+    QStringList targetPathsFirst;
+    {
+        TraceSpan span{"buildFillContext"};
+        m_fillContext = FillContext{};
+        m_fillContext.marketplaceFrom = snapshotFrom->marketplace;
+        m_fillContext.productTypeFrom = productTypeFrom;
+        m_fillContext.countryCodeFrom = countryCodeFrom;
+        m_fillContext.langCodeFrom = langCodeFrom;
+        m_fillContext.gender = m_gender;
+        m_fillContext.age = m_age;
+        m_fillContext.countryCode_langCode_keywords = m_countryCode_langCode_keywords;
+        m_fillContext.skuPattern_countryCode_langCode_keywords = m_skuPattern_countryCode_langCode_keywords;
+        m_fillContext.sku_attribute_valuesForAi = m_sku_attribute_valuesForAi;
+        if (m_skusReused.isEmpty())
+        {
+            m_fillContext.sku_fieldId_fromValues = m_sku_fieldId_fromValues;
+            m_fillContext.parentSku_variation_skus = parentSku_variation_skus;
+        }
+        else
+        {
+            // Changed SKUs come with their whole family so the fillers see
+            // the parent and siblings they read
+            m_fillContext.sku_fieldId_fromValues = m_sku_fieldId_fromValues.rows(skusToFill);
+            for (auto it = parentSku_variation_skus.cbegin();
+                 it != parentSku_variation_skus.cend(); ++it)
+            {
+                if (skusToFill.contains(it.key()))
+                {
+                    m_fillContext.parentSku_variation_skus.insert(it.key(), it.value());
+                }
+            }
+        }
+        m_fillContext.buildTopology();
+        for (const auto &entry : m_fillerDispatch.entries())
+        {
+            QStringList fieldIdsFrom;
+            for (int position : entry.positions)
+            {
+                fieldIdsFrom << sortedFieldIds[position];
+            }
+            entry.filler->prepare(this, fieldIdsFrom, m_fillContext);
+        }
+        m_countryCode_langCode_sku_fieldId_toValues[countryCodeFrom][langCodeFrom];
+        for (const auto &targetPath : m_templateToPaths)
+        {
+            const auto &countryCodeTo = _get_countryCode(targetPath);
+            const auto &langCodeTo = _get_langCode(targetPath);
+            // Created before filling so the references given to fillers stay valid
+            m_countryCode_langCode_sku_fieldId_toValues[countryCodeTo][langCodeTo];
+            m_langCode_sku_fieldId_toValues[langCodeTo];
+            if (targetPath == m_templateFromPath)
+            {
+                targetPathsFirst << targetPath;
+            }
+            else
+            {
+                m_fillContext.langCode_targetPaths[langCodeTo] << targetPath;
+            }
+        }
+        span.setCounter("rows", m_fillContext.skus.size());
+    }
+
+    // The from template is filled first as the other targets read its values.
+    // Then each language runs in its own coroutine so AI requests of different
+    // markets overlap. Targets of a same language share the values of
+    // m_langCode_sku_fieldId_toValues so they are filled one after the other.
+    co_await _fillTargets(targetPathsFirst, sortedFieldIds);
+
+    std::vector<QCoro::Task<void>> tasks;
+    const auto &langCode_targetPaths = m_fillContext.langCode_targetPaths;
+    for (auto it = langCode_targetPaths.cbegin(); it != langCode_targetPaths.cend(); ++it)
+    {
+        tasks.push_back(_fillTargets(it.value(), sortedFieldIds));
+    }
+    std::exception_ptr exceptionFirst;
+    for (auto &task : tasks)
+    {
+        try
+        {
+            co_await task;
+        }
+        catch (...)
+        {
+            if (!exceptionFirst)
+            {
+                exceptionFirst = std::current_exception();
+            }
+        }
+    }
+    if (exceptionFirst)
+    {
+        std::rethrow_exception(exceptionFirst);
+    }
+    AiReplyStore::instance()->flush();
+    m_selectConsensus->save();
+    if (!m_skusReused.isEmpty())
+    {
+        TraceSpan span{"readValuesFilled"};
+        _readValuesFilled();
+        span.setCounter("rows", m_skusReused.size());
+    }
+    {
+        TraceSpan span{"saveTemplates"};
+        _saveTemplates();
+        for (const auto &targetPath : std::as_const(m_templateToPaths))
+        {
+            m_fillManifest.recordFilled(_get_filledPath(targetPath));
+        }
+        m_fillManifest.save(m_workingDir.absoluteFilePath(FillManifest::FILE_NAME));
+    }
+    m_fillCheckpoint.remove();
+    Tracer::instance()->save();
+    co_return;
+}
 
-    for (const auto &targetPath : m_templateToPaths) // TODO check order and make sure from is made first for possible values
+QCoro::Task<void> TemplateFiller::_fillTargets(
+        QStringList targetPaths
+        , QStringList sortedFieldIds)
+{
+    if (m_fillContext.sku_fieldId_fromValues.isEmpty())
+    {
+        co_return; // All values read back from the FILLED templates
+    }
+    for (const auto &targetPath : targetPaths)
     {
-        QXlsx::Document docTo{targetPath};
+        if (m_fillCheckpoint.isTargetDone(targetPath))
+        {
+            continue; // Values restored from the checkpoint
+        }
         const auto &countryCodeTo = _get_countryCode(targetPath);
         const auto &langCodeTo = _get_langCode(targetPath);
-        const auto &marketplaceTo = _get_marketplace(docTo);
-        const auto &productTypeTo = _get_productType(document);
-        const auto &fieldId_index = _get_fieldId_index(docTo);
-
+        TraceSpan span{"fillTarget", langCodeTo};
+        span.setArg("target", targetPath);
+        co_await _fillTarget(targetPath, sortedFieldIds);
+        m_fillCheckpoint.setTargetDone(targetPath);
+        m_fillCheckpoint.appendProgress(targetPath, countryCodeTo, langCodeTo, {}, {}); // Values journaled per field
+    }
+}
+
+QCoro::Task<void> TemplateFiller::_fillTarget(
+        const QString &targetPath
+        , const QStringList &sortedFieldIds)
+{
+    const auto &marketplaceFrom = m_fillContext.marketplaceFrom;
+    const auto &snapshotTo = _snapshot(targetPath);
+    const auto &countryCodeTo = _get_countryCode(targetPath);
+    const auto &langCodeTo = _get_langCode(targetPath);
+    const auto &marketplaceTo = snapshotTo->marketplace;
+    const auto &productTypeTo = m_fillContext.productTypeFrom;
+    const auto &fieldId_index = snapshotTo->fieldId_index;
+    const auto &sku_fieldId_toValuesFrom = m_countryCode_langCode_sku_fieldId_toValues
+            [m_fillContext.countryCodeFrom][m_fillContext.langCodeFrom];
+    auto &sku_fieldId_toValueslangCommon = m_langCode_sku_fieldId_toValues[langCodeTo];
+    auto &sku_fieldId_toValues = m_countryCode_langCode_sku_fieldId_toValues[countryCodeTo][langCodeTo];
+
+    // Target ids are looked up once, the fillers loop on their positions
+    const auto &schema = m_attributeFlagsTable->schema();
+    const int indMarketplaceFrom = schema->marketplaceIndex(marketplaceFrom);
+    const int indMarketplaceTo = schema->marketplaceIndex(marketplaceTo);
+    QList<bool> position_inTarget(sortedFieldIds.size(), false);
+    QStringList position_fieldIdTo(sortedFieldIds.size());
+    for (int i=0; i<sortedFieldIds.size(); ++i)
+    {
+        const auto &fieldIdFrom = sortedFieldIds[i];
+        if (fieldId_index.contains(fieldIdFrom))
+        {
+            position_inTarget[i] = true;
+            if (marketplaceFrom == marketplaceTo)
+            {
+                position_fieldIdTo[i] = fieldIdFrom;
+            }
+            else
+            {
+                int row = schema->row(indMarketplaceFrom, schema->fieldIndex(fieldIdFrom));
+                if (row >= 0 && indMarketplaceTo >= 0)
+                {
+                    position_fieldIdTo[i] = schema->fieldId(row, indMarketplaceTo);
+                }
+            }
+        }
+    }
 
-        for (const auto &filler : AbstractFiller::ALL_FILLERS_SORTED)
+    for (const auto &entry : m_fillerDispatch.entries())
+    {
+        const auto &filler = entry.filler;
+        const auto &fillerName = FillerDispatch::fillerName(filler);
+        QHash<QString, const Attribute *> fieldIdFrom_attribute;
+        QList<int> positionsToFill;
+        for (int position : entry.positions)
         {
-            for (const auto &fieldIdFrom : sortedFieldIds)
+            if (position_inTarget[position]
+                    && !m_fillCheckpoint.isDone(targetPath, fillerName, sortedFieldIds[position]))
             {
-                const auto &attribute =  m_marketplace_attributeId_attributeInfos[marketplaceFrom][fieldIdFrom].data();
-                if (fieldId_index.contains(fieldIdFrom) && filler->canFill(this, attribute, marketplaceFrom, fieldIdFrom))
+                fieldIdFrom_attribute[sortedFieldIds[position]] = m_fillerDispatch.attribute(position);
+                positionsToFill << position;
+            }
+        }
+        if (positionsToFill.isEmpty())
+        {
+            continue;
+        }
+        TraceSpan spanFiller{"filler", langCodeTo};
+        spanFiller.setArg("filler", fillerName);
+        co_await filler->prefetch(
+                    this
+                    , m_fillContext
+                    , marketplaceTo
+                    , fieldIdFrom_attribute
+                    , productTypeTo
+                    , countryCodeTo
+                    , langCodeTo
+                    , sku_fieldId_toValues);
+        for (int position : std::as_const(positionsToFill))
+        {
+            const auto &fieldIdFrom = sortedFieldIds[position];
+            const auto &attribute = m_fillerDispatch.attribute(position);
+            const auto &fieldIdTo = position_fieldIdTo[position];
+            qDebug() << "TemplateFiller Loop. Filler:" << filler << countryCodeTo << langCodeTo << "Field:" << fieldIdFrom << "START";
+            TraceSpan spanField{"fillField", langCodeTo};
+            spanField.setArg("field", fieldIdFrom);
+            spanField.setArg("target", targetPath);
+            // Shared copies, so only the cells written by the filler are compared
+            const auto sku_fieldId_toValuesBefore = sku_fieldId_toValues;
+            const auto sku_fieldId_toValueslangCommonBefore = sku_fieldId_toValueslangCommon;
+            try
+            {
+                co_await filler->fill(
+                            this
+                            , m_fillContext
+                            , marketplaceTo
+                            , fieldIdFrom
+                            , fieldIdTo
+                            , attribute
+                            , productTypeTo
+                            , countryCodeTo
+                            , langCodeTo
+                            , sku_fieldId_toValuesFrom
+                            , sku_fieldId_toValueslangCommon
+                            , sku_fieldId_toValues
+                            );
+            }
+            catch (const ExceptionTemplate &e)
+            {
+                qDebug() << "TemplateFiller Loop. Filler:" << filler << "Field:" << fieldIdFrom << "EXCEPTION CAUGHT:" << e.error(); // Log it!
+                if (e.title() == "No possible values")
                 {
-                    const auto &fieldIdTo = m_attributeFlagsTable->getFieldId(
-                                marketplaceFrom, fieldIdFrom, marketplaceTo);
-                    qDebug() << "TemplateFiller Loop. Filler:" << filler << countryCodeTo << langCodeTo << "Field:" << fieldIdFrom << "START";
-                    try
-                    {
-                        co_await filler->fill(
-                                    this
-                                    , parentSku_variation_skus
-                                    , marketplaceFrom
-                                    , marketplaceTo
-                                    , fieldIdFrom
-                                    , fieldIdTo
-                                    , attribute
-                                    , productTypeFrom
-                                    , productTypeTo
-                                    , countryCodeFrom
-                                    , langCodeFrom
-                                    , countryCodeTo
-                                    , langCodeTo
-                                    , m_countryCode_langCode_keywords
-                                    , m_skuPattern_countryCode_langCode_keywords
-                                    , m_gender
-                                    , m_age
-                                    , m_sku_fieldId_fromValues
-                                    , m_sku_attribute_valuesForAi
-                                    , m_countryCode_langCode_sku_fieldId_toValues[countryCodeFrom][langCodeFrom]
-                                    , m_langCode_sku_fieldId_toValues[langCodeTo]
-                                    , m_countryCode_langCode_sku_fieldId_toValues[countryCodeTo][langCodeTo]
-                                    );
-                    }
-                    catch (const ExceptionTemplate &e)
-                    {
-                        qDebug() << "TemplateFiller Loop. Filler:" << filler << "Field:" << fieldIdFrom << "EXCEPTION CAUGHT:" << e.error(); // Log it!
-                        if (e.title() == "No possible values")
-                        {
-                            e.raise();
-                             // Critical error for this field, but maybe we can continue?
-                             // Re-throwing to stop process as implied by current logic.
-                             throw;
-                        }
-                        throw;
-                    }
-                    qDebug() << "TemplateFiller Loop. Filler:" << filler << "Field:" << fieldIdFrom << "END";
+                    e.raise();
+                     // Critical error for this field, but maybe we can continue?
+                     // Re-throwing to stop process as implied by current logic.
+                     throw;
                 }
+                throw;
             }
+            qDebug() << "TemplateFiller Loop. Filler:" << filler << "Field:" << fieldIdFrom << "END";
+            m_fillCheckpoint.setDone(targetPath, fillerName, fieldIdFrom);
+            m_fillCheckpoint.appendProgress(
+                        targetPath
+                        , countryCodeTo
+                        , langCodeTo
+                        , FillCheckpoint::changedValues(sku_fieldId_toValuesBefore, sku_fieldId_toValues)
+                        , FillCheckpoint::changedValues(sku_fieldId_toValueslangCommonBefore, sku_fieldId_toValueslangCommon));
         }
+        AiReplyStore::instance()->flush();
     }
-    _saveTemplates();
-    co_return;
 }
 
 void TemplateFiller::_fillValuesSources()
@@ -867,8 +1206,7 @@ void TemplateFiller::_fillValuesSources()
             const auto &countryCode = _get_countryCode(templateSourcePath);
             const auto &langCode = _get_langCode(templateSourcePath);
             QSet<QString> whiteListSourceFieldIds;
-            QXlsx::Document document(templateSourcePath);
-            const auto &marketplaceSource = _get_marketplace(document);
+            const auto &marketplaceSource = _snapshot(templateSourcePath)->marketplace;
             for (const auto &mandatoryFieldId : mandatoryFieldIds)
             {
                 if (m_attributeFlagsTable->hasFlag(marketplaceFrom, mandatoryFieldId, Attribute::ReadablePreviousTemplates))
@@ -887,26 +1225,18 @@ void TemplateFiller::_fillValuesSources()
 void TemplateFiller::_saveTemplates()
 {
     // 1. Get ordered SKUs from source template
-    QXlsx::Document docFrom(m_templateFromPath);
-    _selectTemplateSheet(docFrom);
-    const auto &fieldId_index_from = _get_fieldId_index(docFrom);
-    int indColSkuFrom = _getIndColSku(fieldId_index_from);
-    auto versionFrom = _getDocumentVersion(docFrom);
-    int rowDataFrom = _getRowFieldId(versionFrom) + 1;
-    const auto &dimFrom = docFrom.dimension();
-    int lastRowFrom = dimFrom.lastRow();
+    const auto &snapshotFrom = _snapshot(m_templateFromPath);
+    int indColSkuFrom = _getIndColSku(snapshotFrom->fieldId_index);
+    int rowDataFrom = _getRowFieldId(snapshotFrom->version) + 1;
+    int lastRowFrom = snapshotFrom->lastRow;
     
     QStringList orderedSkus;
     for (int i=rowDataFrom; i<lastRowFrom; ++i)
     {
-        auto cellSku = docFrom.cellAt(i+1, indColSkuFrom + 1);
-        if (cellSku)
+        const QString &sku = snapshotFrom->cellVal(i, indColSkuFrom);
+        if (!sku.isEmpty() && !sku.startsWith("ABC"))
         {
-            QString sku = cellSku->value().toString();
-            if (!sku.isEmpty() && !sku.startsWith("ABC"))
-            {
-                orderedSkus << sku;
-            }
+            orderedSkus << sku;
         }
     }
 
@@ -915,21 +1245,23 @@ void TemplateFiller::_saveTemplates()
     {
         const auto &countryCode = _get_countryCode(targetPath);
         const auto &langCode = _get_langCode(targetPath);
-        QXlsx::Document docTo{targetPath};
-        _selectTemplateSheet(docTo);
+        const auto &snapshotTo = _snapshot(targetPath);
+        XlsxTemplateWriter writerTo{targetPath};
+        writerTo.selectSheet(_templateSheetName(writerTo.sheetNames()));
         
-        const auto &fieldId_index = _get_fieldId_index(docTo);
+        const auto &fieldId_index = snapshotTo->fieldId_index;
         int indColSku = _getIndColSku(fieldId_index);
         
         // Find where to start writing (after existing data)
-        int writeRow = docTo.dimension().lastRow();
-        auto versionTo = _getDocumentVersion(docTo);
-        int rowHeader = _getRowFieldId(versionTo) + 1;
-        docTo.setRowHidden(rowHeader, false);
+        int writeRow = snapshotTo->lastRow;
+        int rowHeader = _getRowFieldId(snapshotTo->version) + 1;
+        writerTo.setRowHidden(rowHeader, false);
         
+        qint64 nCells = 0;
         for (const auto &sku : orderedSkus)
         {
-            docTo.write(writeRow + 1, indColSku + 1, sku); // Write SKU
+            writerTo.write(writeRow + 1, indColSku + 1, sku); // Write SKU
+            ++nCells;
             if (m_countryCode_langCode_sku_fieldId_toValues.contains(countryCode)
                     && m_countryCode_langCode_sku_fieldId_toValues[countryCode].contains(langCode)
                     && m_countryCode_langCode_sku_fieldId_toValues[countryCode][langCode].contains(sku))
@@ -942,19 +1274,182 @@ void TemplateFiller::_saveTemplates()
                     if (fieldId_index.contains(fieldId))
                     {
                         int col = fieldId_index[fieldId];
-                        docTo.write(writeRow + 1, col+1, it.value());
+                        writerTo.write(writeRow + 1, col+1, it.value());
+                        ++nCells;
                     }
                 }
             }
             ++writeRow;
         }
+        Tracer::instance()->count("rowsWritten", orderedSkus.size());
+        Tracer::instance()->count("cellsWritten", nCells);
 
-        QString toFillFilePathNew{targetPath};
-        toFillFilePathNew.replace("TOFILL", "FILLED");
+        const auto &toFillFilePathNew = _get_filledPath(targetPath);
         Q_ASSERT(toFillFilePathNew != targetPath);
         if (toFillFilePathNew != targetPath)
         {
-            docTo.saveAs(toFillFilePathNew);
+            if (!writerTo.saveAs(toFillFilePathNew))
+            {
+                ExceptionTemplate exception;
+                exception.setInfos(QObject::tr("Template not saved")
+                                   , QObject::tr("The template %1 couldn't be saved").arg(toFillFilePathNew));
+                exception.raise();
+            }
+        }
+    }
+}
+
+QString TemplateFiller::_get_filledPath(const QString &targetPath)
+{
+    QString filledPath{targetPath};
+    filledPath.replace("TOFILL", "FILLED");
+    return filledPath;
+}
+
+void TemplateFiller::setIncremental(bool incremental)
+{
+    m_incremental = incremental;
+}
+
+FillManifest TemplateFiller::_buildFillManifest(const QStringList &sortedFieldIds) const
+{
+    FillManifest fillManifest;
+    const auto addFile = [](QCryptographicHash &hash, const QString &filePath)
+    {
+        hash.addData(filePath.toUtf8());
+        QFile file{filePath};
+        if (file.open(QIODevice::ReadOnly))
+        {
+            hash.addData(&file);
+        }
+    };
+    const QStringList settingsFileNames{
+        "attributeFlags.csv"
+        , "attributeEquivalent.csv"
+        , "attributeReplacement.csv"
+        , "attributePossibleMissing.csv"
+        , "mandatoryFieldIds.ini"};
+    QCryptographicHash hashRun{QCryptographicHash::Sha1};
+    for (const auto &fileName : settingsFileNames)
+    {
+        addFile(hashRun, m_workingDirCommon.absoluteFilePath(fileName));
+    }
+    const auto &keywordsFileInfos = m_workingDir.entryInfoList(
+                QStringList{"keywor*.txt", "Keywor*.txt"}, QDir::Files, QDir::Name);
+    for (const auto &fileInfo : keywordsFileInfos)
+    {
+        addFile(hashRun, fileInfo.absoluteFilePath());
+    }
+    hashRun.addData(sortedFieldIds.join("\n").toUtf8());
+    hashRun.addData(QString("%1,%2").arg(int(m_gender)).arg(int(m_age)).toUtf8());
+    // The rows of the from template are fingerprinted by SKU, the other
+    // templates by their size and modification time
+    const auto &snapshotFrom = _snapshot(m_templateFromPath);
+    QStringList fieldIdsFrom{snapshotFrom->fieldId_index.keyBegin(), snapshotFrom->fieldId_index.keyEnd()};
+    fieldIdsFrom.sort();
+    hashRun.addData(fieldIdsFrom.join("\n").toUtf8());
+    hashRun.addData(snapshotFrom->productType.toUtf8());
+    for (const auto &templatePath : m_templateToPaths + m_templateSourcePaths)
+    {
+        if (templatePath != m_templateFromPath)
+        {
+            QFileInfo fileInfo{templatePath};
+            hashRun.addData(QString("%1,%2,%3").arg(
+                                fileInfo.absoluteFilePath()
+                                , QString::number(fileInfo.size())
+                                , QString::number(fileInfo.lastModified().toMSecsSinceEpoch())).toUtf8());
+        }
+    }
+    fillManifest.setRunFingerprint(hashRun.result());
+
+    QHash<QString, QByteArray> imagePath_hash;
+    for (auto it = m_sku_fieldId_fromValues.cbegin();
+         it != m_sku_fieldId_fromValues.cend(); ++it)
+    {
+        const auto &sku = it.key();
+        QCryptographicHash hashSku{QCryptographicHash::Sha1};
+        const auto &fieldId_value = it.value();
+        for (auto itCell = fieldId_value.cbegin(); itCell != fieldId_value.cend(); ++itCell)
+        {
+            hashSku.addData(QString{itCell.key() + "\t" + itCell.value() + "\n"}.toUtf8());
+        }
+        const auto &imagePath = m_sku_imagePreviewFilePath.value(sku);
+        if (!imagePath.isEmpty())
+        {
+            if (!imagePath_hash.contains(imagePath))
+            {
+                QCryptographicHash hashImage{QCryptographicHash::Sha1};
+                addFile(hashImage, imagePath);
+                imagePath_hash[imagePath] = hashImage.result();
+            }
+            hashSku.addData(imagePath_hash[imagePath]);
+        }
+        for (auto itPattern = m_skuPattern_customInstructions.cbegin();
+             itPattern != m_skuPattern_customInstructions.cend(); ++itPattern)
+        {
+            if (sku.contains(itPattern.key()))
+            {
+                hashSku.addData(QString{itPattern.key() + "\t" + itPattern.value() + "\n"}.toUtf8());
+            }
+        }
+        fillManifest.setSkuFingerprint(sku, hashSku.result());
+    }
+    return fillManifest;
+}
+
+QSet<QString> TemplateFiller::_get_skusWithFamilies(
+        const QSet<QString> &skus
+        , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus) const
+{
+    QSet<QString> skusWithFamilies{skus};
+    for (auto itParent = parentSku_variation_skus.cbegin();
+         itParent != parentSku_variation_skus.cend(); ++itParent)
+    {
+        QSet<QString> familySkus{itParent.key()};
+        for (auto itVar = itParent.value().cbegin();
+             itVar != itParent.value().cend(); ++itVar)
+        {
+            familySkus.unite(itVar.value());
+        }
+        if (familySkus.intersects(skus))
+        {
+            skusWithFamilies.unite(familySkus);
+        }
+    }
+    return skusWithFamilies;
+}
+
+void TemplateFiller::_readValuesFilled()
+{
+    for (const auto &targetPath : std::as_const(m_templateToPaths))
+    {
+        const auto &countryCode = _get_countryCode(targetPath);
+        const auto &langCode = _get_langCode(targetPath);
+        const auto &snapshotFilled = _snapshot(_get_filledPath(targetPath));
+        const auto &fieldId_index = snapshotFilled->fieldId_index;
+        int indColSku = _getIndColSku(fieldId_index);
+        int lastRow = snapshotFilled->lastRow;
+        QHash<QString, int> sku_row; // The rows written by the last fill come after the ones of TOFILL
+        for (int i=_getRowFieldId(snapshotFilled->version) + 1; i<lastRow; ++i)
+        {
+            const auto &sku = snapshotFilled->cellVal(i, indColSku);
+            if (m_skusReused.contains(sku))
+            {
+                sku_row[sku] = i;
+            }
+        }
+        auto &sku_fieldId_toValues = m_countryCode_langCode_sku_fieldId_toValues[countryCode][langCode];
+        for (auto itSku = sku_row.cbegin(); itSku != sku_row.cend(); ++itSku)
+        {
+            auto &fieldId_value = sku_fieldId_toValues[itSku.key()];
+            for (auto it = fieldId_index.cbegin(); it != fieldId_index.cend(); ++it)
+            {
+                const auto &value = snapshotFilled->cellVal(itSku.value(), it.value());
+                if (!value.isEmpty())
+                {
+                    fieldId_value[it.key()] = value;
+                }
+            }
         }
     }
 }
@@ -965,54 +1460,41 @@ const QHash<QString, QString> &TemplateFiller::sku_imagePreviewFilePath() const
 }
 
 void TemplateFiller::saveAiValue(
-        const QString &settingsFileName, const QHash<QString, QString> &id_values) const
+        const QString &settingsFileName
+        , const QHash<QString, QString> &id_values
+        , const QString &gptModel) const
 {
+    Q_ASSERT(settingsFileName.endsWith(".ini"));
     const QString &settingsFilePath = m_workingDir.absoluteFilePath(settingsFileName);
-    QSettings settings{settingsFilePath, QSettings::IniFormat};
-    for (auto it = id_values.begin();
-         it != id_values.end(); ++it)
-    {
-        settings.setValue(it.key(), it.value());
-    }
-    settings.sync();
+    AiReplyStore::instance()->setValues(settingsFilePath, id_values, gptModel);
 }
 
-void TemplateFiller::saveAiValue(const QString &settingsFileName, const QString &id, const QString &value) const
+void TemplateFiller::saveAiValue(
+        const QString &settingsFileName
+        , const QString &id
+        , const QString &value
+        , const QString &gptModel) const
 {
     Q_ASSERT(settingsFileName.endsWith(".ini"));
     const QString &settingsFilePath = m_workingDir.absoluteFilePath(settingsFileName);
-
-    static QMutex settingsWriteMutex;
-    QMutexLocker locker(&settingsWriteMutex);
-    QSettings settings{settingsFilePath, QSettings::IniFormat};
-    settings.setValue(id, value);
-    settings.sync();
+    AiReplyStore::instance()->setValue(settingsFilePath, id, value, gptModel);
 }
 
 bool TemplateFiller::hasAiValue(const QString &settingsFileName, const QString &id) const
 {
     Q_ASSERT(settingsFileName.endsWith(".ini"));
     const QString &settingsFilePath = m_workingDir.absoluteFilePath(settingsFileName);
-    QSettings settings{settingsFilePath, QSettings::IniFormat};
-    return settings.contains(id);
+    bool contains = AiReplyStore::instance()->contains(settingsFilePath, id);
+    Tracer::instance()->count(contains ? "aiCacheHits" : "aiCacheMisses");
+    AiTelemetry::instance()->recordCacheLookup(settingsFileName, contains);
+    return contains;
 }
 
 QString TemplateFiller::getAiReply(const QString &settingsFileName, const QString &id) const
 {
     Q_ASSERT(settingsFileName.endsWith(".ini"));
     const QString &settingsFilePath = m_workingDir.absoluteFilePath(settingsFileName);
-    QSettings settings{settingsFilePath, QSettings::IniFormat};
-    return settings.value(id).toString();
-}
-
-QString TemplateFiller::_get_cellVal(QXlsx::Document &doc, int row, int col) const
-{
-    auto cell = doc.cellAt(row+1, col + 1);
-    if (cell)
-    {
-         return cell->value().toString();
-    }
-    return QString{};
+    return AiReplyStore::instance()->value(settingsFilePath, id);
 }
 
 QStringList TemplateFiller::findPreviousTemplatePath() const
@@ -1025,20 +1507,15 @@ QStringList TemplateFiller::findPreviousTemplatePath() const
     {
         const QString &filePath = it.next();
         qDebug() << "TemplateFiller::findPreviousTemplatePath...reading: " << filePath;
-        QXlsx::Document doc{filePath};
-        _selectTemplateSheet(doc);
-
-        const auto &fieldId_index = _get_fieldId_index(doc);
-        int indColProductType = _getIndColProductType(fieldId_index);
+        const auto &snapshot = _snapshot(filePath);
+        int indColProductType = _getIndColProductType(snapshot->fieldId_index);
         
         // Read header? No, read first row after header.
-        auto version = _getDocumentVersion(doc);
-        int rowData = _getRowFieldId(version) + 1;
+        int rowData = _getRowFieldId(snapshot->version) + 1;
         
-        auto cellProductType = doc.cellAt(rowData + 2, indColProductType + 1); // +2 in case exemple row
-        if (cellProductType)
+        if (snapshot->hasCell(rowData + 1, indColProductType)) // +1 in case exemple row
         {
-            QString productType = cellProductType->value().toString();
+            const QString &productType = snapshot->cellVal(rowData + 1, indColProductType);
             if (productType.compare(type, Qt::CaseInsensitive) == 0)
             {
                 templatePaths << filePath;
@@ -1049,25 +1526,21 @@ QStringList TemplateFiller::findPreviousTemplatePath() const
     return templatePaths;
 }
 
-QString TemplateFiller::_get_productType(QXlsx::Document &doc) const
+QString TemplateFiller::_get_productType(const TemplateSnapshot &snapshot) const
 {
-    _selectTemplateSheet(doc);
-
-    const auto &fieldId_index = _get_fieldId_index(doc);
-    int indColProductType = _getIndColProductType(fieldId_index);
+    int indColProductType = _getIndColProductType(snapshot.fieldId_index);
 
     // Read header? No, read first row after header.
-    auto version = _getDocumentVersion(doc);
+    auto version = snapshot.version;
     int rowData = _getRowFieldId(version) + 1;
 
-    auto cellProductType = doc.cellAt(rowData + 2, indColProductType + 1); // +2 in case exemple row
-    if (cellProductType)
+    if (snapshot.hasCell(rowData + 1, indColProductType)) // +1 in case exemple row
     {
-        return cellProductType->value().toString();
+        return snapshot.cellVal(rowData + 1, indColProductType);
     }
     else
     {
-        const auto &fieldId_possibleValues = _get_fieldId_possibleValues(doc);
+        const auto &fieldId_possibleValues = snapshot.fieldId_possibleValues;
         QString fieldId;
         if (version == V01)
         {
@@ -1081,7 +1554,11 @@ QString TemplateFiller::_get_productType(QXlsx::Document &doc) const
         {
             Q_ASSERT(false);
         }
-        return *fieldId_possibleValues[fieldId].begin();
+        const auto &possibleValues = fieldId_possibleValues.value(fieldId);
+        if (!possibleValues.isEmpty())
+        {
+            return *possibleValues.begin();
+        }
     }
     return QString{};
 }
@@ -1089,8 +1566,140 @@ QString TemplateFiller::_get_productType(QXlsx::Document &doc) const
 
 QString TemplateFiller::_get_productType(const QString &filePath) const
 {
-    QXlsx::Document doc{filePath};
-    return _get_productType(doc);
+    return _snapshot(filePath)->productType;
+}
+
+QSharedPointer<const TemplateSnapshot> TemplateFiller::_snapshot(
+        const QString &filePath) const
+{
+    auto snapshot = TemplateSnapshotCache::instance()->get(filePath);
+    if (snapshot.isNull())
+    {
+        snapshot = _readSnapshot(filePath);
+        TemplateSnapshotCache::instance()->insert(snapshot);
+    }
+    else
+    {
+        Tracer::instance()->count("snapshotCacheHits");
+    }
+    return snapshot;
+}
+
+QSharedPointer<const TemplateSnapshot> TemplateFiller::_snapshotWithMandatory(
+        const QString &filePath) const
+{
+    auto snapshot = _snapshot(filePath);
+    if (!snapshot->mandatoryRead)
+    {
+        auto snapshotWithMandatory = QSharedPointer<TemplateSnapshot>::create(*snapshot);
+        XlsxStreamReader reader{filePath};
+        const auto &sheetName = _mandatorySheetName(reader.sheetNames());
+        snapshotWithMandatory->mandatoryRead = true;
+        snapshotWithMandatory->hasMandatorySheet = !sheetName.isEmpty();
+        if (snapshotWithMandatory->hasMandatorySheet)
+        {
+            // Only the columns of the field id, name, hints and mandatory flags are read
+            snapshotWithMandatory->fieldIdMandatory = _get_fieldIdMandatory(
+                        reader.readSheet(sheetName, nullptr, 10));
+        }
+        TemplateSnapshotCache::instance()->insert(snapshotWithMandatory);
+        snapshot = snapshotWithMandatory;
+    }
+    return snapshot;
+}
+
+QSharedPointer<const TemplateSnapshot> TemplateFiller::_readSnapshot(
+        const QString &filePath) const
+{
+    qDebug() << "TemplateFiller::_readSnapshot" << filePath;
+    TraceSpan span{"readTemplate"};
+    span.setArg("template", filePath);
+    auto snapshot = QSharedPointer<TemplateSnapshot>::create();
+    QFileInfo fileInfo{filePath};
+    snapshot->filePath = fileInfo.absoluteFilePath();
+    snapshot->lastModified = fileInfo.lastModified();
+    snapshot->fileSize = fileInfo.size();
+
+    XlsxStreamReader reader{filePath};
+    if (!reader.isValid())
+    {
+        ExceptionTemplate exception;
+        exception.setInfos(QObject::tr("Unreadable template")
+                           , QObject::tr("The following file couldn't be read as an excel file:") + " " + filePath);
+        exception.raise();
+    }
+    const auto &templateSheet = reader.readSheet(_templateSheetName(reader.sheetNames()));
+    snapshot->version = _getDocumentVersion(templateSheet);
+    snapshot->marketplace = _get_marketplace(snapshot->version);
+    snapshot->fieldId_index = _get_fieldId_index(templateSheet, snapshot->version);
+    snapshot->lastRow = templateSheet.lastRow;
+    snapshot->lastColumn = templateSheet.lastColumn;
+    snapshot->templateRows = templateSheet.rows;
+
+    const auto &validValuesSheetName = _validValuesSheetName(reader.sheetNames());
+    if (!validValuesSheetName.isEmpty())
+    {
+        snapshot->fieldId_possibleValues = _get_fieldId_possibleValues(
+                    templateSheet, snapshot->version, reader, validValuesSheetName);
+    }
+    snapshot->productType = _get_productType(*snapshot);
+    span.setCounter("rows", snapshot->lastRow);
+    return snapshot;
+}
+
+QMap<QString, QString> TemplateFiller::parseCustomInstructions(const QString &text)
+{
+    QMap<QString, QString> skuPattern_customInstructions;
+    const auto &customInstructions = text.trimmed();
+    if (!customInstructions.isEmpty())
+    {
+        const QStringList &lines = customInstructions.split("\n");
+        skuPattern_customInstructions[QString{}] = lines[0].trimmed();
+        if (!skuPattern_customInstructions[QString{}].endsWith("."))
+        {
+            skuPattern_customInstructions[QString{}] += ".";
+        }
+        QStringList lastSkus;
+        QStringList lastInstructions;
+        for (int i=1; i<lines.size(); ++i)
+        {
+            const auto &line = lines[i];
+            if (line.startsWith("["))
+            {
+                if (!lastSkus.isEmpty() && !lastInstructions.isEmpty())
+                {
+                    for (const auto &sku : lastSkus)
+                    {
+                        skuPattern_customInstructions[sku] = lastInstructions.join(" ");
+                    }
+                }
+                lastSkus.clear();
+                lastInstructions.clear();
+                const auto &lineSkus = lines[i].mid(1, line.size()-2);
+                const auto &skus = lineSkus.split(",");
+                for (const auto &sku : skus)
+                {
+                    lastSkus << sku.trimmed();
+                }
+            }
+            else if (!lastSkus.isEmpty())
+            {
+                lastInstructions << line.trimmed();
+                if (!lastInstructions.last().endsWith("."))
+                {
+                    lastInstructions.last() += ".";
+                }
+            }
+        }
+        if (!lastSkus.isEmpty() && !lastInstructions.isEmpty())
+        {
+            for (const auto &sku : lastSkus)
+            {
+                skuPattern_customInstructions[sku] = lastInstructions.join(" ");
+            }
+        }
+    }
+    return skuPattern_customInstructions;
 }
 
 QSharedPointer<QSettings> TemplateFiller::settingsProducts() const
@@ -1104,45 +1713,66 @@ AiFailureTable *TemplateFiller::aiFailureTable() const
     return m_aiFailureTable;
 }
 
+SelectConsensus *TemplateFiller::selectConsensus() const
+{
+    return m_selectConsensus.data();
+}
+
+ImagePreparer *TemplateFiller::imagePreparer() const
+{
+    return m_imagePreparer.data();
+}
+
+const FillerDispatch &TemplateFiller::fillerDispatch() const
+{
+    return m_fillerDispatch;
+}
+
 QSharedPointer<QSettings> TemplateFiller::settingsCommon() const
 {
     const auto &settingsPath = m_workingDirCommon.absoluteFilePath("settings.ini");
     return QSharedPointer<QSettings>::create(settingsPath, QSettings::IniFormat);
 }
 
-QHash<QString, QHash<QString, QString>> TemplateFiller::_get_sku_fieldId_fromValues(
+SkuFieldMatrix TemplateFiller::_get_sku_fieldId_fromValues(
         const QString &templatePath, const QSet<QString> &fieldIdsWhiteList) const
 {
-    QHash<QString, QHash<QString, QString>> sku_fieldId_values;
-    QXlsx::Document document(templatePath);
-    _selectTemplateSheet(document);
-    const auto &fieldId_index = _get_fieldId_index(document);
+    const auto &snapshot = _snapshot(templatePath);
+    const auto &fieldId_index = snapshot->fieldId_index;
+    QMap<int, QString> colIndex_fieldId; // Columns kept in the order of the template
+    for (auto it = fieldId_index.cbegin();
+         it != fieldId_index.cend(); ++it)
+    {
+        if (fieldIdsWhiteList.isEmpty() || fieldIdsWhiteList.contains(it.key()))
+        {
+            colIndex_fieldId.insert(it.value(), it.key());
+        }
+    }
+    const auto &colIndexes = colIndex_fieldId.keys();
+    SkuFieldMatrix sku_fieldId_values{colIndex_fieldId.values()};
     int indColSku = _getIndColSku(fieldId_index);
-    const auto &dim = document.dimension();
-    int lastRow = dim.lastRow();
-    auto version = _getDocumentVersion(document);
-    int row = _getRowFieldId(version) + 1;
+    int lastRow = snapshot->lastRow;
+    int row = _getRowFieldId(snapshot->version) + 1;
     for (int i=row; i<lastRow; ++i)
     {
-        const auto &sku = _get_cellVal(document, i, indColSku);
+        const auto &sku = snapshot->cellVal(i, indColSku);
         if (sku.startsWith("ABC"))
         {
             continue;
         }
         if (!sku.isEmpty())
         {
-            for (auto it = fieldId_index.cbegin();
-                 it != fieldId_index.cend(); ++it)
+            int rowMatrix = -1;
+            for (int j=0; j<colIndexes.size(); ++j)
             {
-                const auto &fieldId = it.key();
-                int colIndex = it.value();
-                const auto &value = _get_cellVal(document, i, colIndex);
+                const auto &value = snapshot->cellVal(i, colIndexes[j]);
                 if (!value.isEmpty())
                 {
-                    if (fieldIdsWhiteList.isEmpty() || fieldIdsWhiteList.contains(fieldId))
+                    if (rowMatrix < 0)
                     {
-                        sku_fieldId_values[sku][fieldId] = value;
+                        rowMatrix = sku_fieldId_values.addRow(sku);
                     }
+                    sku_fieldId_values.setValue(rowMatrix, j, value);
                 }
             }
         }
@@ -1153,11 +1783,10 @@ QHash<QString, QHash<QString, QString>> TemplateFiller::_get_sku_fieldId_fromVal
 QCoro::Task<TemplateFiller::AttributesToValidate> TemplateFiller::findAttributesMandatoryToValidateManually() const
 {
     TemplateFiller::AttributesToValidate attributesToValidateManually;
-    QXlsx::Document doc{m_templateFromPath};
-    const auto &productType = _get_productType(doc);
+    const auto &snapshot = _snapshot(m_templateFromPath);
+    const auto &productType = snapshot->productType;
     Q_ASSERT(!productType.isEmpty());
-    _selectTemplateSheet(doc);
-    const auto &fieldId_index = _get_fieldId_index(doc);
+    const auto &fieldId_index = snapshot->fieldId_index;
     const auto &fieldIdMandatory = _get_fieldIdMandatoryAll();
     // 1. AI Load
     co_await m_mandatoryAttributesAiTable->load(
@@ -1177,6 +1806,7 @@ QCoro::Task<TemplateFiller::AttributesToValidate> TemplateFiller::findAttributes
 void TemplateFiller::validateMandatory(
         const QSet<QString> &attributesMandatory, const QSet<QString> &attributesNotMandatory)
 {
+    TableBatch batchFlags{m_attributeFlagsTable.data()}; // The update also records the new mandatory ids
     m_mandatoryAttributesTable->update(attributesMandatory, attributesNotMandatory);
     m_attributeFlagsTable->recordAttributeNotRecordedYet(m_marketplaceFrom, attributesMandatory);
 }
@@ -1193,22 +1823,22 @@ AttributesMandatoryAiTable *TemplateFiller::mandatoryAttributesAiTable() const
 
 AttributeEquivalentTable *TemplateFiller::attributeEquivalentTable() const
 {
-    return m_attributeEquivalentTable;
+    return m_attributeEquivalentTable.data();
 }
 
 AttributeFlagsTable *TemplateFiller::attributeFlagsTable() const
 {
-    return m_attributeFlagsTable;
+    return m_attributeFlagsTable.data();
 }
 
 AttributePossibleMissingTable *TemplateFiller::attributePossibleMissingTable() const
 {
-    return m_attributePossibleMissingTable;
+    return m_attributePossibleMissingTable.data();
 }
 
 AttributeValueReplacedTable *TemplateFiller::attributeValueReplacedTable() const
 {
-    return m_attributeValueReplacedTable;
+    return m_attributeValueReplacedTable.data();
 }
 
 int TemplateFiller::_getIndCol(
@@ -1300,125 +1930,74 @@ QString TemplateFiller::_get_countryCode(const QString &templateFilePath) const
     return elements.last();
 }
 
-void TemplateFiller::_selectTemplateSheet(QXlsx::Document &doc) const
-{
-    const QStringList SHEETS_TEMPLATE{
-        "Template"
-        , "Vorlage"
-        , "Modèle"
-        , "Sjabloon"
-        , "Mall"
-        , "Szablon"
-        , "Plantilla"
-        , "Modello"
-        , "Şablon"
-        , "Gabarit"
-        , "テンプレート"
-    };
-    bool sheetSelected = false;
+QString TemplateFiller::_templateSheetName(const QStringList &sheetNames) const
+{
     for (const QString &sheetName : SHEETS_TEMPLATE)
     {
-        if (doc.selectSheet(sheetName))
+        if (sheetNames.contains(sheetName))
         {
-            sheetSelected = true;
-            break;
+            return sheetName;
         }
     }
 
-    Q_ASSERT(sheetSelected);
+    Q_ASSERT(false);
 
-    if (!sheetSelected)
+    if (sheetNames.size() >= 5)
     {
-        QStringList sheets = doc.sheetNames();
-        if (sheets.size() >= 5)
-        {
-            doc.selectSheet(sheets.at(4)); // 5th sheet
-        }
-        else
-        {
-            Q_ASSERT(false);
-            doc.selectSheet(sheets.first());
-        }
+        return sheetNames.at(4); // 5th sheet
     }
+    else if (!sheetNames.isEmpty())
+    {
+        return sheetNames.first();
+    }
+    return QString{};
 }
 
-void TemplateFiller::_selectMandatorySheet(QXlsx::Document &doc) const
+QString TemplateFiller::_mandatorySheetName(const QStringList &sheetNames) const
 {
-    bool sheetSelected = false;
     for (auto it = SHEETS_MANDATORY.begin();
          it != SHEETS_MANDATORY.end(); ++it)
     {
-        if (doc.selectSheet(it.key()))
+        if (sheetNames.contains(it.key()))
         {
-            sheetSelected = true;
-            break;
+            return it.key();
         }
     }
-    Q_ASSERT(sheetSelected);
-
-    if (!sheetSelected)
+    // Usually it means SHEETS_MANDATORY needs to be added a new value
+    if (sheetNames.size() >= 7)
     {
-        QStringList sheets = doc.sheetNames();
-        if (sheets.size() >= 7)
-        {
-            doc.selectSheet(sheets.at(6)); // 7th sheet
-        }
-        else
-        {
-            Q_ASSERT(false);
-            // Fallback: select the first sheet available.
-        }
+        qDebug() << "TemplateFiller::_mandatorySheetName unknown name, using the 7th sheet" << sheetNames.at(6);
+        return sheetNames.at(6);
     }
+    qDebug() << "TemplateFiller::_mandatorySheetName no mandatory sheet in" << sheetNames;
+    return QString{};
 }
 
-void TemplateFiller::_selectValidValuesSheet(QXlsx::Document &doc) const
+QString TemplateFiller::_validValuesSheetName(const QStringList &sheetNames) const
 {
-    const QStringList SHEETS_VALID_VALUES{
-        "Valeurs valides"
-        , "Valid Values"
-        , "Valori validi"
-        , "Geldige waarden"
-        , "Gültige Werte"
-        , "Giltiga värden"
-        , "Valores válidos"
-        , "Poprawne wartości"
-        , "Geçerli Değerler"
-        , "推奨値"
-    };
-
-    bool sheetSelected = false;
     for (const QString &sheetName : SHEETS_VALID_VALUES)
     {
-        if (doc.selectSheet(sheetName))
+        if (sheetNames.contains(sheetName))
         {
-            sheetSelected = true;
-            break;
+            return sheetName;
         }
     }
-    Q_ASSERT(sheetSelected);
-
-    if (!sheetSelected)
+    // Usually it means SHEETS_VALID_VALUES needs to be added a new value
+    if (sheetNames.size() >= 5)
     {
-        QStringList sheets = doc.sheetNames();
-        if (sheets.size() >= 5)
-        {
-            doc.selectSheet(sheets.at(3)); // 4th sheet
-        }
-        else
-        {
-            Q_ASSERT(false);
-        }
+        qDebug() << "TemplateFiller::_validValuesSheetName unknown name, using the 4th sheet" << sheetNames.at(3);
+        return sheetNames.at(3);
     }
+    qDebug() << "TemplateFiller::_validValuesSheetName no valid values sheet in" << sheetNames;
+    return QString{};
 }
 
 TemplateFiller::VersionAmz TemplateFiller::_getDocumentVersion(
-    QXlsx::Document &document) const
+    const XlsxSheetRows &templateSheet) const
 {
-    _selectTemplateSheet(document);
-    auto firstCell = document.cellAt(1, 1);
-    if (firstCell)
+    if (templateSheet.hasCell(0, 0))
     {
-        const QString version{firstCell->value().toString()};
+        const QString &version = templateSheet.cellVal(0, 0);
         if (version.startsWith("settings", Qt::CaseInsensitive))
         {
             return V02;
@@ -1450,26 +2029,20 @@ int TemplateFiller::_getRowFieldId(VersionAmz version) const
 }
 
 QHash<QString, int> TemplateFiller::_get_fieldId_index(
-    QXlsx::Document &doc) const
+    const XlsxSheetRows &templateSheet, VersionAmz version) const
 {
-    auto version = _getDocumentVersion(doc);
     int rowCell = _getRowFieldId(version);
-    const auto &dim = doc.dimension();
     QHash<QString, int> colId_index;
-    int lastColumn = dim.lastColumn();
+    int lastColumn = templateSheet.lastColumn;
     for (int i=0; i<lastColumn; ++i)
     {
-        auto cell = doc.cellAt(rowCell + 1, i + 1);
-        if (cell)
+        QString fieldId{templateSheet.cellVal(rowCell, i)};
+        if (!fieldId.isEmpty())
         {
-            QString fieldId{cell->value().toString()};
-            if (!fieldId.isEmpty())
+            _formatFieldId(fieldId);
+            if (!colId_index.contains(fieldId))
             {
-                _formatFieldId(fieldId);
-                if (!colId_index.contains(fieldId))
-                {
-                    colId_index[fieldId] = i;
-                }
+                colId_index[fieldId] = i;
             }
         }
     }
@@ -1478,14 +2051,11 @@ QHash<QString, int> TemplateFiller::_get_fieldId_index(
 
 QString TemplateFiller::_get_marketplaceFrom() const
 {
-    QXlsx::Document doc{m_templateFromPath};
-    return _get_marketplace(doc);
+    return _snapshot(m_templateFromPath)->marketplace;
 }
 
-QString TemplateFiller::_get_marketplace(QXlsx::Document &doc) const
+QString TemplateFiller::_get_marketplace(VersionAmz version) const
 {
-     _selectTemplateSheet(doc);
-    auto version = _getDocumentVersion(doc);
     if (version == V01)
     {
         return Attribute::AMAZON_V01;
@@ -1501,11 +2071,9 @@ QString TemplateFiller::_get_marketplace(QXlsx::Document &doc) const
     return QString{};
 }
 
-QSet<QString> TemplateFiller::_get_fieldIdMandatory(QXlsx::Document &doc) const
+QSet<QString> TemplateFiller::_get_fieldIdMandatory(const XlsxSheetRows &mandatorySheet) const
 {
     QSet<QString> fieldIds;
-    _selectMandatorySheet(doc);
-    auto dimMandatory = doc.dimension();
     const int colIndFieldId = 1;
     const int colIndFieldName = 2;
     const int colIndHint = 3;
@@ -1513,8 +2081,7 @@ QSet<QString> TemplateFiller::_get_fieldIdMandatory(QXlsx::Document &doc) const
     int colIndMandatory = 0;
     for (int j=0; j<10; ++j)
     {
-        auto cell = doc.cellAt(2, j + 1);
-        if (cell)
+        if (mandatorySheet.hasCell(1, j))
         {
             colIndMandatory = j;
         }
@@ -1523,18 +2090,17 @@ QSet<QString> TemplateFiller::_get_fieldIdMandatory(QXlsx::Document &doc) const
             break;
         }
     }
-    int lastRow = dimMandatory.lastRow();
+    int lastRow = mandatorySheet.lastRow;
     for (int i = 3; i<lastRow; ++i)
     {
-        auto cellFieldId = doc.cellAt(i+1, colIndFieldId + 1);
-        auto cellFieldName = doc.cellAt(i+1, colIndFieldName + 1);
-        auto cellMandatory = doc.cellAt(i+1, colIndMandatory + 1);
-        if (cellFieldId && cellFieldName && cellMandatory)
+        if (mandatorySheet.hasCell(i, colIndFieldId)
+                && mandatorySheet.hasCell(i, colIndFieldName)
+                && mandatorySheet.hasCell(i, colIndMandatory))
         {
-            QString fieldId{cellFieldId->value().toString()};
+            QString fieldId{mandatorySheet.cellVal(i, colIndFieldId)};
             _formatFieldId(fieldId);
-            QString mandatory{cellMandatory->value().toString()};
-            if (cellFieldName && cellMandatory && fieldId != mandatory)
+            const QString &mandatory = mandatorySheet.cellVal(i, colIndMandatory);
+            if (fieldId != mandatory)
             {
                 if (VALUES_MANDATORY.contains(mandatory))
                 {
@@ -1549,15 +2115,12 @@ QSet<QString> TemplateFiller::_get_fieldIdMandatory(QXlsx::Document &doc) const
 
 QSet<QString> TemplateFiller::_get_fieldIdMandatoryAll() const
 {
-    QXlsx::Document doc{m_templateFromPath};
-    auto fieldIdMandatory = _get_fieldIdMandatory(doc);
-    for (const auto &targetPath : m_templateToPaths)
-    {
-        QXlsx::Document docTo{targetPath};
-        const auto &fieldIdMandatoryTo = _get_fieldIdMandatory(doc);
-        fieldIdMandatory.unite(fieldIdMandatoryTo);
-    }
-    return fieldIdMandatory;
+    const auto &snapshot = _snapshotWithMandatory(m_templateFromPath);
+    Q_ASSERT(snapshot->hasMandatorySheet);
+    // The ids of the targets can be of another marketplace version, so only
+    // the from template is read as the former loop did (it read it again for
+    // each target)
+    return snapshot->fieldIdMandatory;
 }
 
 QSet<QString> TemplateFiller::_get_fieldIdMandatoryPrevious() const
@@ -1579,11 +2142,10 @@ QSet<QString> TemplateFiller::_get_fieldIdMandatoryPrevious() const
         // Ideally we might want to merge or pick best, but "previous" usually implies "last used".
         // The list might be sorted or not. existing logic 'findPreviousTemplatePath' returns list.
         // We'll proceed with the first one for now.
-        QXlsx::Document docPrev{previousTemplatePaths.first()};
-        if (docPrev.load())
+        const auto &snapshotPrev = _snapshotWithMandatory(previousTemplatePaths.first());
+        if (snapshotPrev->hasMandatorySheet)
         {
-             // We reuse _get_fieldIdMandatory logic
-             previousFieldIdMandatory = _get_fieldIdMandatory(docPrev);
+             previousFieldIdMandatory = snapshotPrev->fieldIdMandatory;
         }
     }
     settings->setValue(key, QVariant::fromValue(previousFieldIdMandatory));
@@ -1591,109 +2153,91 @@ QSet<QString> TemplateFiller::_get_fieldIdMandatoryPrevious() const
 }
 
 QHash<QString, QSet<QString>> TemplateFiller::_get_fieldId_possibleValues(
-        QXlsx::Document &doc) const
+        const XlsxSheetRows &templateSheet
+        , VersionAmz version
+        , XlsxStreamReader &reader
+        , const QString &validValuesSheetName) const
 {
     QHash<QString, QSet<QString>> fieldId_possibleValues;
     QHash<QString, QSet<QString>> fieldName_fieldId;
-    _selectTemplateSheet(doc);
-    auto version = _getDocumentVersion(doc);
     int rowFieldId = _getRowFieldId(version);
     int rowFieldName = rowFieldId - 1;
-    auto dimTemplate = doc.dimension();
-    for (int i = 0; i < dimTemplate.lastColumn(); ++i)
+    for (int i = 0; i < templateSheet.lastColumn; ++i)
     {
-        auto cellFieldName = doc.cellAt(rowFieldName + 1, i + 1);
-        auto cellFieldId = doc.cellAt(rowFieldId + 1, i + 1);
-        if (cellFieldId && cellFieldName)
+        if (templateSheet.hasCell(rowFieldId, i) && templateSheet.hasCell(rowFieldName, i))
         {
-            QString fieldId{cellFieldId->value().toString()};
+            QString fieldId{templateSheet.cellVal(rowFieldId, i)};
             _formatFieldId(fieldId);
-            QString fieldName{cellFieldName->value().toString()};
+            const QString &fieldName = templateSheet.cellVal(rowFieldName, i);
             if (!fieldName.isEmpty() && !fieldId.isEmpty())
             {
                 fieldName_fieldId[fieldName].insert(fieldId);
             }
         }
     }
-    _selectValidValuesSheet(doc);
-    const auto &dimValidValues = doc.dimension();
-    for (int i=1; i<dimValidValues.lastRow(); ++i)
+    // The rows are read as the sheet is parsed, none is kept
+    reader.readSheet(validValuesSheetName
+                     , [&fieldId_possibleValues, &fieldName_fieldId](int row, QStringList &values) -> bool
     {
-        auto cellFieldName = doc.cellAt(i+1, 2);
-        if (cellFieldName)
+        if (row < 1 || values.size() < 2 || values[1].isNull())
         {
-            QString fieldName{cellFieldName->value().toString()};
-            if (fieldName.contains(" - ["))
-            {
-                fieldName = fieldName.split(" - [")[0];
-            }
-            if (!fieldName.isEmpty())
+            return false;
+        }
+        QString fieldName{values[1]};
+        if (fieldName.contains(" - ["))
+        {
+            fieldName = fieldName.split(" - [")[0];
+        }
+        if (!fieldName.isEmpty())
+        {
+            Q_ASSERT(fieldName_fieldId.contains(fieldName));
+            if (fieldName_fieldId.contains(fieldName))
             {
-                Q_ASSERT(fieldName_fieldId.contains(fieldName));
-                if (fieldName_fieldId.contains(fieldName))
+                const auto &fieldIds = fieldName_fieldId[fieldName];
+                for (const auto &fieldId : fieldIds)
                 {
-                    const auto &fieldIds = fieldName_fieldId[fieldName];
-                    for (const auto &fieldId : fieldIds)
+                    for (int j=2; j<values.size(); ++j)
                     {
-                        for (int j=2; i<dimValidValues.lastColumn(); ++j)
+                        const QString &value = values[j];
+                        if (value.isEmpty())
                         {
-                            auto cellValue = doc.cellAt(i+1, j+1);
-                            QString value;
-                            if (cellValue)
-                            {
-                                value = cellValue->value().toString();
-                                if (!value.isEmpty())
-                                {
-                                    fieldId_possibleValues[fieldId] << value;
-                                }
-                            }
-                            if (value.isEmpty())
-                            {
-                                break;
-                            }
+                            break;
                         }
+                        fieldId_possibleValues[fieldId] << value;
                     }
                 }
             }
         }
-    }
+        return false;
+    });
     return fieldId_possibleValues;
 }
 
 QHash<QString, QSet<QString>> TemplateFiller::_get_parentSku_skus(
-        QXlsx::Document &doc) const
+        const TemplateSnapshot &snapshot) const
 {
     QHash<QString, QSet<QString>> parentSku_skus;
-    const auto &fieldId_index = _get_fieldId_index(doc);
+    const auto &fieldId_index = snapshot.fieldId_index;
     int indColSku = _getIndColSku(fieldId_index);
     int indColSkuParent = _getIndColSkuParent(fieldId_index);
 
-    const auto &dim = doc.dimension();
-    int lastRow = dim.lastRow();
-    auto version = _getDocumentVersion(doc);
-    int row = _getRowFieldId(version) + 1;
+    int lastRow = snapshot.lastRow;
+    int row = _getRowFieldId(snapshot.version) + 1;
 
     for (int i=row; i<lastRow; ++i)
     {
-        auto cellSku = doc.cellAt(i+1, indColSku + 1);
-        if (!cellSku)
+        if (!snapshot.hasCell(i, indColSku))
         {
             break;
         }
 
-        QString sku{cellSku->value().toString()};
+        const QString &sku = snapshot.cellVal(i, indColSku);
         if (sku.startsWith("ABC") || sku.isEmpty())
         {
             continue;
         }
 
-        auto cellSkuParent = doc.cellAt(i+1, indColSkuParent + 1);
-        if (!cellSkuParent)
-        {
-            continue;
-        }
-
-        QString skuParent{cellSkuParent->value().toString()};
+        const QString &skuParent = snapshot.cellVal(i, indColSkuParent);
         if (skuParent.isEmpty())
         {
             continue;
@@ -1704,22 +2248,21 @@ QHash<QString, QSet<QString>> TemplateFiller::_get_parentSku_skus(
     return parentSku_skus;
 }
 
-QHash<QString, QHash<QString, QSet<QString>>> TemplateFiller::_get_parentSku_variation_skus(QXlsx::Document &doc) const
+QHash<QString, QHash<QString, QSet<QString>>> TemplateFiller::_get_parentSku_variation_skus(
+        const TemplateSnapshot &snapshot) const
 {
     QHash<QString, QHash<QString, QSet<QString>>> parentSku_variation_skus;
-    const auto &fieldId_index = _get_fieldId_index(doc);
+    const auto &fieldId_index = snapshot.fieldId_index;
     int indColSku = _getIndColSku(fieldId_index);
     int indColSkuParent = _getIndColSkuParent(fieldId_index);
     int indColColor = _getIndColColorName(fieldId_index);
 
-    const auto &dim = doc.dimension();
-    int lastRow = dim.lastRow();
-    auto version = _getDocumentVersion(doc);
-    int row = _getRowFieldId(version) + 1;
+    int lastRow = snapshot.lastRow;
+    int row = _getRowFieldId(snapshot.version) + 1;
 
     for (int i=row; i<lastRow; ++i)
     {
-        const auto &sku = _get_cellVal(doc, i, indColSku);
+        const auto &sku = snapshot.cellVal(i, indColSku);
         if (sku.isEmpty())
         {
             break;
@@ -1729,13 +2272,13 @@ QHash<QString, QHash<QString, QSet<QString>>> TemplateFiller::_get_parentSku_var
             continue;
         }
 
-        const auto &skuParent = _get_cellVal(doc, i, indColSkuParent);
+        const auto &skuParent = snapshot.cellVal(i, indColSkuParent);
         if (skuParent.isEmpty())
         {
             continue;
         }
 
-        const auto &color = _get_cellVal(doc, i, indColColor);
+        const auto &color = snapshot.cellVal(i, indColColor);
 
         parentSku_variation_skus[skuParent][color].insert(sku);
     }
@@ -1837,9 +2380,8 @@ void TemplateFiller::_checkGender(const QString &gender)
 
 QCoro::Task<void> TemplateFiller::_readAgeGender()
 {
-    QXlsx::Document doc(m_templateFromPath);
-    _selectTemplateSheet(doc);
-    const auto &fieldId_index = _get_fieldId_index(doc);
+    const auto &snapshot = _snapshot(m_templateFromPath);
+    const auto &fieldId_index = snapshot->fieldId_index;
     int indColAge = _getIndColAge(fieldId_index);
     int indColGender = _getIndColGender(fieldId_index);
 
@@ -1899,14 +2441,13 @@ QCoro::Task<void> TemplateFiller::_readAgeGender()
         if (found) break;
     }
 
-    auto version = _getDocumentVersion(doc);
-    int rowData = _getRowFieldId(version) + 1;
+    int rowData = _getRowFieldId(snapshot->version) + 1;
 
 
     // Check Age - 3 conditions
     if (ageAttribute)
     {
-        const QString &age = _get_cellVal(doc, rowData + 2, indColAge); // +2 in case exemple row and Parent in first row
+        const QString &age = snapshot->cellVal(rowData + 2, indColAge); // +2 in case exemple row and Parent in first row
         if (m_attributeEquivalentTable->getEquivalentAgeAdult().isEmpty())
         {
             co_await m_attributeEquivalentTable->askAiEquivalentValues(
@@ -1925,7 +2466,7 @@ QCoro::Task<void> TemplateFiller::_readAgeGender()
         _checkAge(age);
         if (m_age == AbstractFiller::UndefinedAge && !age.isEmpty())
         {
-            const auto &productType = _get_productType(doc);
+            const auto &productType = snapshot->productType;
             const auto &possibleValues = ageAttribute->possibleValues(
                         m_marketplaceFrom, m_countryCodeFrom, m_langCodeFrom, productType);
             co_await m_attributeEquivalentTable->askAiEquivalentValues(
@@ -1941,7 +2482,7 @@ QCoro::Task<void> TemplateFiller::_readAgeGender()
     // Check Gender - 3 conditions
     if (genderAttribute)
     {
-        const QString &gender = _get_cellVal(doc, rowData + 2, indColGender); // +2 in case exemple row and Parent in first row
+        const QString &gender = snapshot->cellVal(rowData + 2, indColGender); // +2 in case exemple row and Parent in first row
         if (m_attributeEquivalentTable->getEquivalentGenderMen().isEmpty()) {
              co_await m_attributeEquivalentTable->askAiEquivalentValues(
                  genderFieldIdFound, "Male", genderAttribute.data());
@@ -1958,7 +2499,7 @@ QCoro::Task<void> TemplateFiller::_readAgeGender()
 
         if (m_gender == AbstractFiller::UndefinedGender && !gender.isEmpty())
         {
-            const auto &productType = _get_productType(doc);
+            const auto &productType = snapshot->productType;
             const auto &possibleValues = genderAttribute->possibleValues(
                         m_marketplaceFrom, m_countryCodeFrom, m_langCodeFrom, productType);
             co_await m_attributeEquivalentTable->askAiEquivalentValues(
@@ -7,11 +7,15 @@
 #include <QSettings>
 #include <QSharedPointer>
 
-#include <xlsxdocument.h>
 #include <QCoro/QCoroTask>
 
 #include "Attribute.h"
+#include "FillCheckpoint.h"
+#include "FillManifest.h"
+#include "SkuFieldMatrix.h"
 #include "fillers/AbstractFiller.h"
+#include "fillers/FillContext.h"
+#include "fillers/FillerDispatch.h"
 
 class AttributesMandatoryAiTable;
 class AttributesMandatoryTable;
@@ -20,18 +24,27 @@ class AttributeFlagsTable;
 class AttributePossibleMissingTable;
 class AttributeValueReplacedTable;
 class AiFailureTable;
+class SelectConsensus;
+class ImagePreparer;
+struct TemplateSnapshot;
+struct XlsxSheetRows;
+class XlsxStreamReader;
 
 class TemplateFiller
 {
+    friend class TemplateFillerBenchmark; // Times private steps
 public:
     static const QSet<QString> VALUES_MANDATORY;
     static const QHash<QString, QSet<QString>> SHEETS_MANDATORY;
+    static const QStringList SHEETS_TEMPLATE;
+    static const QStringList SHEETS_VALID_VALUES;
     TemplateFiller(const QString &workingDirCommon
                    , const QString &templateFromPath
                    , const QStringList &templateToPaths
                    , const QStringList &templateSourcePaths
                    , const QMap<QString, QString> &skuPattern_customInstruction);
     ~TemplateFiller();
+    static QMap<QString, QString> parseCustomInstructions(const QString &text); // First line for all skus, then [SKU1,SKU2] blocks
     struct AttributesToValidate{
         QSet<QString> addedAi;
         QSet<QString> removedAi;
@@ -51,6 +64,7 @@ public:
     QHash<QString, QHash<QString, QHash<QString, QHash<QString, QHash<QString, QSet<QString>>>>>> checkPossibleValues();
     void buildAttributes();
     void checkColumnsFilled();
+    void setIncremental(bool incremental); // Only refill the SKUs whose inputs changed since the last fill
     QCoro::Task<void> fillValues();
 
      // Return all field with values or ask AI after reading field ids
@@ -81,26 +95,36 @@ public:
     QSet<QString> getAllFieldIds() const;
 
     const QHash<QString, QString> &sku_imagePreviewFilePath() const;
-    void saveAiValue(const QString &settingsFileName, const QString &id, const QString &value) const;
-    void saveAiValue(const QString &settingsFileName, const QHash<QString, QString> &id_values) const;
+    void saveAiValue(const QString &settingsFileName
+                     , const QString &id
+                     , const QString &value
+                     , const QString &gptModel = QString{}) const;
+    void saveAiValue(const QString &settingsFileName
+                     , const QHash<QString, QString> &id_values
+                     , const QString &gptModel = QString{}) const;
     bool hasAiValue(const QString &settingsFileName, const QString &id) const;
     QString getAiReply(const QString &settingsFileName, const QString &id) const;
     QSharedPointer<QSettings> settingsCommon() const; // Settings of current working directory
     QSharedPointer<QSettings> settingsProducts() const; // Settings of current working directory
 
     AiFailureTable *aiFailureTable() const;
+    SelectConsensus *selectConsensus() const;
+    ImagePreparer *imagePreparer() const;
+    const FillerDispatch &fillerDispatch() const; // Routing of the last fillValues()
 
 private:
     QHash<QString, QHash<QString, QString>> m_countryCode_langCode_keywords;
     QHash<QString, QHash<QString, QHash<QString, QString>>> m_skuPattern_countryCode_langCode_keywords;
     AttributesMandatoryTable *m_mandatoryAttributesTable;
     AttributesMandatoryAiTable *m_mandatoryAttributesAiTable;
-    AttributeEquivalentTable *m_attributeEquivalentTable;
-    AttributeFlagsTable *m_attributeFlagsTable;
+    QSharedPointer<AttributeEquivalentTable> m_attributeEquivalentTable; // Shared by common dir
+    QSharedPointer<AttributeFlagsTable> m_attributeFlagsTable;
     QMetaObject::Connection m_connectionFlagsTable;
-    AttributePossibleMissingTable *m_attributePossibleMissingTable;
-    AttributeValueReplacedTable *m_attributeValueReplacedTable;
+    QSharedPointer<AttributePossibleMissingTable> m_attributePossibleMissingTable;
+    QSharedPointer<AttributeValueReplacedTable> m_attributeValueReplacedTable;
     AiFailureTable *m_aiFailureTable;
+    QSharedPointer<SelectConsensus> m_selectConsensus; // Shared by common dir
+    QSharedPointer<ImagePreparer> m_imagePreparer;
     void _clearAttributeManagers();
     QString m_productType;
     AbstractFiller::Age m_age;
@@ -113,28 +137,31 @@ private:
     QStringList m_templateToPaths;
     QStringList m_templateSourcePaths;
     QStringList _get_allTemplatePaths() const;
-    QString _get_cellVal(QXlsx::Document &doc, int row, int col) const;
     QString m_langCodeFrom;
     QString m_countryCodeFrom;
     QString _get_countryCode(const QString &templateFilePath) const;
     QString _get_langCode(const QString &templateFilePath) const;
     QString _getLangCodeFromText(const QString &langInfos) const;
-    void _selectTemplateSheet(QXlsx::Document &doc) const;
-    void _selectValidValuesSheet(QXlsx::Document &doc) const;
-    void _selectMandatorySheet(QXlsx::Document &doc) const;
+    QString _templateSheetName(const QStringList &sheetNames) const;
+    QString _validValuesSheetName(const QStringList &sheetNames) const;
+    QString _mandatorySheetName(const QStringList &sheetNames) const;
     QHash<QString, QSet<QString> > _readKeywords();
     QHash<QString, QSet<QString> > _readKeywords(const QStringList &filePaths);
-    TemplateFiller::VersionAmz _getDocumentVersion(QXlsx::Document &document) const;
+    TemplateFiller::VersionAmz _getDocumentVersion(const XlsxSheetRows &templateSheet) const;
     int _getRowFieldId(VersionAmz version) const;
-    QHash<QString, int> _get_fieldId_index(QXlsx::Document &doc) const;
+    QHash<QString, int> _get_fieldId_index(const XlsxSheetRows &templateSheet, VersionAmz version) const;
     QString _get_marketplaceFrom() const;
-    QString _get_marketplace(QXlsx::Document &doc) const;
-    QSet<QString> _get_fieldIdMandatory(QXlsx::Document &doc) const;
+    QString _get_marketplace(VersionAmz version) const;
+    QSet<QString> _get_fieldIdMandatory(const XlsxSheetRows &mandatorySheet) const;
     QSet<QString> _get_fieldIdMandatoryAll() const;
     QSet<QString> _get_fieldIdMandatoryPrevious() const;
-    QHash<QString, QSet<QString>> _get_fieldId_possibleValues(QXlsx::Document &doc) const;
-    QHash<QString, QSet<QString>> _get_parentSku_skus(QXlsx::Document &doc) const;
-    QHash<QString, QHash<QString, QSet<QString>>> _get_parentSku_variation_skus(QXlsx::Document &doc) const;
+    QHash<QString, QSet<QString>> _get_fieldId_possibleValues(
+            const XlsxSheetRows &templateSheet
+            , VersionAmz version
+            , XlsxStreamReader &reader
+            , const QString &validValuesSheetName) const;
+    QHash<QString, QSet<QString>> _get_parentSku_skus(const TemplateSnapshot &snapshot) const;
+    QHash<QString, QHash<QString, QSet<QString>>> _get_parentSku_variation_skus(const TemplateSnapshot &snapshot) const;
     void _formatFieldId(QString &fieldId) const;
     int _getIndCol(const QHash<QString, int> &fieldId_index
                    , const QStringList &possibleValues) const;
@@ -147,19 +174,40 @@ private:
     QCoro::Task<void> _readAgeGender();
     void _checkGender(const QString &gender);
     void _checkAge(const QString &age);
-    QString _get_productType(QXlsx::Document &doc) const;
+    QString _get_productType(const TemplateSnapshot &snapshot) const;
     QString _get_productType(const QString &filePath) const;
+    QSharedPointer<const TemplateSnapshot> _snapshot(const QString &filePath) const;
+    QSharedPointer<const TemplateSnapshot> _snapshotWithMandatory(const QString &filePath) const;
+    QSharedPointer<const TemplateSnapshot> _readSnapshot(const QString &filePath) const;
     QHash<QString, QHash<QString, QSharedPointer<Attribute>>> m_marketplace_attributeId_attributeInfos;
-    QHash<QString, QHash<QString, QString>> _get_sku_fieldId_fromValues(
+    SkuFieldMatrix _get_sku_fieldId_fromValues(
             const QString &templatePath
             , const QSet<QString> &fieldIdsWhiteList = QSet<QString>{}) const;
 
     QHash<QString, QMap<QString, QString>> m_sku_attribute_valuesForAi;
-    QHash<QString, QHash<QString, QString>> m_sku_fieldId_fromValues;
-    QHash<QString, QHash<QString, QHash<QString, QHash<QString, QString>>>> m_countryCode_langCode_sku_fieldId_sourceValues;
+    SkuFieldMatrix m_sku_fieldId_fromValues;
+    QHash<QString, QHash<QString, SkuFieldMatrix>> m_countryCode_langCode_sku_fieldId_sourceValues;
     QHash<QString, QHash<QString, QHash<QString, QString>>> m_langCode_sku_fieldId_toValues;
     QHash<QString, QHash<QString, QHash<QString, QHash<QString, QString>>>> m_countryCode_langCode_sku_fieldId_toValues;
+    FillerDispatch m_fillerDispatch;
+    FillContext m_fillContext;
+    bool m_incremental;
+    FillManifest m_fillManifest; // Inputs of the current fill
+    QSet<QString> m_skusReused; // Values read back from the FILLED templates
+    FillCheckpoint m_fillCheckpoint;
+    FillManifest _buildFillManifest(const QStringList &sortedFieldIds) const;
+    QSet<QString> _get_skusWithFamilies(
+            const QSet<QString> &skus
+            , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus) const;
+    void _readValuesFilled();
+    static QString _get_filledPath(const QString &targetPath);
     void _fillValuesSources();
+    QCoro::Task<void> _fillTargets(
+            QStringList targetPaths
+            , QStringList sortedFieldIds);
+    QCoro::Task<void> _fillTarget(
+            const QString &targetPath
+            , const QStringList &sortedFieldIds);
     void _saveTemplates();
     QHash<QString, QString> m_sku_imagePreviewFilePath;
     QMap<QString, QString> m_skuPattern_customInstructions;
@@ -0,0 +1,73 @@
+#include <QFileInfo>
+
+#include "TemplateSnapshot.h"
+
+QString TemplateSnapshot::cellVal(int row, int col) const
+{
+    if (row >= 0 && row < templateRows.size())
+    {
+        const auto &values = templateRows[row];
+        if (col >= 0 && col < values.size())
+        {
+            return values[col];
+        }
+    }
+    return QString{};
+}
+
+bool TemplateSnapshot::hasCell(int row, int col) const
+{
+    if (row >= 0 && row < templateRows.size())
+    {
+        const auto &values = templateRows[row];
+        if (col >= 0 && col < values.size())
+        {
+            return !values[col].isNull();
+        }
+    }
+    return false;
+}
+
+TemplateSnapshotCache *TemplateSnapshotCache::instance()
+{
+    static TemplateSnapshotCache instance;
+    return &instance;
+}
+
+QSharedPointer<const TemplateSnapshot> TemplateSnapshotCache::get(
+        const QString &filePath) const
+{
+    QFileInfo fileInfo{filePath};
+    const auto &absoluteFilePath = fileInfo.absoluteFilePath();
+    QMutexLocker locker(&m_mutex);
+    auto it = m_filePath_snapshot.constFind(absoluteFilePath);
+    if (it != m_filePath_snapshot.constEnd())
+    {
+        const auto &snapshot = it.value();
+        if (snapshot->lastModified == fileInfo.lastModified()
+                && snapshot->fileSize == fileInfo.size())
+        {
+            return snapshot;
+        }
+    }
+    return QSharedPointer<const TemplateSnapshot>{};
+}
+
+void TemplateSnapshotCache::insert(
+        const QSharedPointer<const TemplateSnapshot> &snapshot)
+{
+    QMutexLocker locker(&m_mutex);
+    m_filePath_snapshot[snapshot->filePath] = snapshot;
+}
+
+void TemplateSnapshotCache::remove(const QString &filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    m_filePath_snapshot.remove(QFileInfo{filePath}.absoluteFilePath());
+}
+
+void TemplateSnapshotCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_filePath_snapshot.clear();
+}
@@ -0,0 +1,55 @@
+#ifndef TEMPLATESNAPSHOT_H
+#define TEMPLATESNAPSHOT_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+#include "TemplateFiller.h"
+
+// Everything TemplateFiller reads from an XLSX template, parsed once.
+// Snapshots are immutable and shared: copy the pointer, never the workbook.
+struct TemplateSnapshot
+{
+    QString filePath;
+    QDateTime lastModified;
+    qint64 fileSize = 0;
+    TemplateFiller::VersionAmz version = TemplateFiller::V01;
+    QString marketplace;
+    QString productType;
+    int lastRow = 0;
+    int lastColumn = 0;
+    QHash<QString, int> fieldId_index;
+    QList<QStringList> templateRows; // Template sheet, 0-based, null QString when no cell
+    QHash<QString, QSet<QString>> fieldId_possibleValues;
+    bool mandatoryRead = false; // The mandatory sheet is only read when asked for
+    bool hasMandatorySheet = false;
+    QSet<QString> fieldIdMandatory;
+
+    QString cellVal(int row, int col) const;
+    bool hasCell(int row, int col) const;
+};
+
+// Process-wide cache of TemplateSnapshot keyed by file path. An entry is only
+// returned while the file modification time and size are the ones parsed.
+class TemplateSnapshotCache
+{
+public:
+    static TemplateSnapshotCache *instance();
+    QSharedPointer<const TemplateSnapshot> get(const QString &filePath) const;
+    void insert(const QSharedPointer<const TemplateSnapshot> &snapshot);
+    void remove(const QString &filePath);
+    void clear();
+
+private:
+    TemplateSnapshotCache() = default;
+    mutable QMutex m_mutex;
+    QHash<QString, QSharedPointer<const TemplateSnapshot>> m_filePath_snapshot;
+};
+
+#endif // TEMPLATESNAPSHOT_H
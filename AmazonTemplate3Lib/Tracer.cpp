@@ -0,0 +1,234 @@
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QThread>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "Tracer.h"
+
+Tracer *Tracer::instance()
+{
+    static Tracer instance;
+    return &instance;
+}
+
+Tracer::Tracer()
+{
+    m_timer.start();
+    const QString &filePath = qEnvironmentVariable("AMZ_TRACE");
+    if (!filePath.isEmpty())
+    {
+        start(filePath);
+    }
+}
+
+void Tracer::start(const QString &filePath)
+{
+    QMutexLocker locker{&m_mutex};
+    m_filePath = filePath;
+    m_enabled.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::count(const char *counterName, qint64 n)
+{
+    if (isEnabled())
+    {
+        QMutexLocker locker{&m_mutex};
+        m_counter_value[QString::fromLatin1(counterName)] += n;
+    }
+}
+
+bool Tracer::save() const
+{
+    if (!isEnabled())
+    {
+        return false;
+    }
+    QMutexLocker locker{&m_mutex};
+    QJsonArray traceEvents;
+    qint64 pid = QCoreApplication::applicationPid();
+    for (auto it = m_track_tid.cbegin(); it != m_track_tid.cend(); ++it)
+    {
+        traceEvents.append(QJsonObject{
+                               {"name", "thread_name"}
+                               , {"ph", "M"}
+                               , {"pid", pid}
+                               , {"tid", it.value()}
+                               , {"args", QJsonObject{{"name", it.key()}}}});
+    }
+    for (const auto &event : m_events)
+    {
+        QJsonObject eventObject{
+            {"name", QString::fromUtf8(event.name)}
+            , {"cat", QString::fromUtf8(event.category)}
+            , {"ph", QString{QChar::fromLatin1(event.phase)}}
+            , {"ts", event.timestamp}
+            , {"pid", pid}
+            , {"tid", event.tid}};
+        if (event.phase == 'X')
+        {
+            eventObject["dur"] = event.duration;
+        }
+        else
+        {
+            eventObject["id"] = event.id;
+        }
+        if (!event.args.isEmpty())
+        {
+            eventObject["args"] = event.args;
+        }
+        traceEvents.append(eventObject);
+    }
+    QSaveFile file{m_filePath};
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    file.write(QJsonDocument{QJsonObject{
+                   {"traceEvents", traceEvents}
+                   , {"displayTimeUnit", "ms"}}}.toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+void Tracer::clear()
+{
+    QMutexLocker locker{&m_mutex};
+    m_events.clear();
+    m_counter_value.clear();
+}
+
+qint64 Tracer::peakRssKb()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return qint64(counters.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#ifdef Q_OS_MACOS
+        return usage.ru_maxrss / 1024; // Bytes on macOS
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+    return 0;
+#endif
+}
+
+qint64 Tracer::_now() const
+{
+    return m_timer.nsecsElapsed() / 1000;
+}
+
+qint64 Tracer::_tid(const QString &track)
+{
+    if (track.isEmpty())
+    {
+        return qint64(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+    }
+    QMutexLocker locker{&m_mutex};
+    auto it = m_track_tid.find(track);
+    if (it == m_track_tid.end())
+    {
+        it = m_track_tid.insert(track, m_track_tid.size() + 1);
+    }
+    return it.value();
+}
+
+QHash<QString, qint64> Tracer::_counters() const
+{
+    QMutexLocker locker{&m_mutex};
+    return m_counter_value;
+}
+
+void Tracer::_addEvent(Event &&event)
+{
+    QMutexLocker locker{&m_mutex};
+    m_events << std::move(event);
+}
+
+void Tracer::_addStep(const QString &name, qint64 begin)
+{
+    qint64 end = _now();
+    qint64 tid = _tid(QStringLiteral("AI steps"));
+    QMutexLocker locker{&m_mutex};
+    qint64 id = ++m_nextId;
+    Event eventBegin;
+    eventBegin.name = name.toUtf8();
+    eventBegin.category = "ai";
+    eventBegin.phase = 'b';
+    eventBegin.timestamp = begin;
+    eventBegin.id = id;
+    eventBegin.tid = tid;
+    Event eventEnd{eventBegin};
+    eventEnd.phase = 'e';
+    eventEnd.timestamp = end;
+    m_events << std::move(eventBegin) << std::move(eventEnd);
+}
+
+TraceSpan::TraceSpan(const char *name, const QString &track)
+    : m_enabled(Tracer::instance()->isEnabled())
+    , m_name(name)
+{
+    if (m_enabled)
+    {
+        auto tracer = Tracer::instance();
+        m_tid = tracer->_tid(track);
+        m_counter_valueBegin = tracer->_counters();
+        m_begin = tracer->_now();
+    }
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (m_enabled)
+    {
+        auto tracer = Tracer::instance();
+        Tracer::Event event;
+        event.name = m_name;
+        event.category = "fill";
+        event.timestamp = m_begin;
+        event.duration = tracer->_now() - m_begin;
+        event.tid = m_tid;
+        const auto &counter_value = tracer->_counters();
+        for (auto it = counter_value.cbegin(); it != counter_value.cend(); ++it)
+        {
+            qint64 diff = it.value() - m_counter_valueBegin.value(it.key());
+            if (diff != 0)
+            {
+                m_args[it.key()] = diff;
+            }
+        }
+        m_args["peakRssKb"] = Tracer::peakRssKb();
+        event.args = m_args;
+        tracer->_addEvent(std::move(event));
+    }
+}
+
+void TraceSpan::setArg(const char *key, const QString &value)
+{
+    if (m_enabled)
+    {
+        m_args[QString::fromLatin1(key)] = value;
+    }
+}
+
+void TraceSpan::setCounter(const char *key, qint64 value)
+{
+    if (m_enabled)
+    {
+        m_args[QString::fromLatin1(key)] = value;
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <utility>
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+
+// Records the stages of a run as Chrome trace events, the JSON written by
+// save() opens in Perfetto (ui.perfetto.dev) or chrome://tracing. Tracing
+// is off unless start() is called or the AMZ_TRACE environment variable is
+// set to the file path to write. When off, a TraceSpan only reads a flag.
+class Tracer
+{
+public:
+    static Tracer *instance();
+    void start(const QString &filePath);
+    bool isEnabled() const;
+    void count(const char *counterName, qint64 n = 1); // Reported by the spans as the difference between their end and start
+    bool save() const; // Writes the trace file if tracing is enabled
+    void clear();
+    static qint64 peakRssKb();
+
+    // Traces the AI steps from now to when their reply is applied
+    template<typename Step>
+    void traceSteps(const QList<QSharedPointer<Step>> &steps);
+
+private:
+    friend class TraceSpan;
+    struct Event
+    {
+        QByteArray name;
+        QByteArray category;
+        char phase = 'X';
+        qint64 timestamp = 0;
+        qint64 duration = 0;
+        qint64 id = 0;
+        qint64 tid = 0;
+        QJsonObject args;
+    };
+    Tracer();
+    std::atomic<bool> m_enabled{false};
+    QElapsedTimer m_timer;
+    QString m_filePath;
+    mutable QMutex m_mutex;
+    QList<Event> m_events;
+    QHash<QString, qint64> m_track_tid;
+    QHash<QString, qint64> m_counter_value;
+    qint64 m_nextId = 0;
+    qint64 _now() const;
+    qint64 _tid(const QString &track);
+    QHash<QString, qint64> _counters() const;
+    void _addEvent(Event &&event);
+    void _addStep(const QString &name, qint64 begin);
+};
+
+// Scoped span: the time between construction and destruction is a trace
+// event. Spans of coroutines running concurrently on the same thread are
+// given their own track so they don't overlap.
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char *name, const QString &track = QString{});
+    ~TraceSpan();
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+    void setArg(const char *key, const QString &value);
+    void setCounter(const char *key, qint64 value);
+
+private:
+    bool m_enabled;
+    const char *m_name;
+    qint64 m_tid = 0;
+    qint64 m_begin = 0;
+    QHash<QString, qint64> m_counter_valueBegin;
+    QJsonObject m_args;
+};
+
+inline bool Tracer::isEnabled() const
+{
+    return m_enabled.load(std::memory_order_relaxed);
+}
+
+template<typename Step>
+void Tracer::traceSteps(const QList<QSharedPointer<Step>> &steps)
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+    for (const auto &step : steps)
+    {
+        if (step->apply)
+        {
+            qint64 begin = _now();
+            auto apply = std::move(step->apply);
+            step->apply = [this, apply, name = step->name, begin](auto &&...args)
+            {
+                apply(std::forward<decltype(args)>(args)...);
+                _addStep(name, begin);
+            };
+        }
+    }
+}
+
+#endif // TRACER_H
@@ -0,0 +1,381 @@
+#include <QBuffer>
+#include <QVariant>
+#include <QXmlStreamReader>
+
+#include <xlsxzipreader_p.h>
+
+#include "ZipEntryDevice.h"
+
+#include "XlsxStreamReader.h"
+
+static const QString NAMESPACE_RELATIONSHIPS{
+    "http://schemas.openxmlformats.org/officeDocument/2006/relationships"};
+
+QString XlsxSheetRows::cellVal(int row, int col) const
+{
+    if (row >= 0 && row < rows.size())
+    {
+        const auto &values = rows[row];
+        if (col >= 0 && col < values.size())
+        {
+            return values[col];
+        }
+    }
+    return QString{};
+}
+
+bool XlsxSheetRows::hasCell(int row, int col) const
+{
+    if (row >= 0 && row < rows.size())
+    {
+        const auto &values = rows[row];
+        if (col >= 0 && col < values.size())
+        {
+            return !values[col].isNull();
+        }
+    }
+    return false;
+}
+
+XlsxStreamReader::XlsxStreamReader(const QString &filePath)
+    : m_filePath(filePath)
+    , m_zipReader(new QXlsx::ZipReader{filePath})
+{
+    m_sharedStringsRead = false;
+    if (isValid())
+    {
+        _readWorkbook();
+    }
+}
+
+XlsxStreamReader::~XlsxStreamReader()
+{
+}
+
+bool XlsxStreamReader::isValid() const
+{
+    return m_zipReader->exists()
+            && m_zipReader->filePaths().contains("xl/workbook.xml");
+}
+
+const QStringList &XlsxStreamReader::sheetNames() const
+{
+    return m_sheetNames;
+}
+
+QStringList XlsxStreamReader::entryPaths() const
+{
+    return m_zipReader->filePaths();
+}
+
+QByteArray XlsxStreamReader::entryData(const QString &entryPath) const
+{
+    return m_zipReader->fileData(entryPath);
+}
+
+QString XlsxStreamReader::sheetEntryPath(const QString &sheetName) const
+{
+    return m_sheetName_entryPath.value(sheetName);
+}
+
+std::unique_ptr<QIODevice> XlsxStreamReader::_openEntry(const QString &entryPath) const
+{
+    std::unique_ptr<QIODevice> device{new ZipEntryDevice{m_filePath, entryPath}};
+    if (!device->open(QIODevice::ReadOnly))
+    {
+        // Zip64 or another compression: the entry is decompressed at once
+        auto buffer = new QBuffer;
+        buffer->setData(m_zipReader->fileData(entryPath));
+        buffer->open(QIODevice::ReadOnly);
+        device.reset(buffer);
+    }
+    return device;
+}
+
+QString XlsxStreamReader::_toEntryPath(const QString &target)
+{
+    if (target.startsWith("/"))
+    {
+        return target.mid(1);
+    }
+    return "xl/" + target;
+}
+
+void XlsxStreamReader::_readWorkbook()
+{
+    QHash<QString, QString> relId_target;
+    {
+        QXmlStreamReader xml{m_zipReader->fileData("xl/_rels/workbook.xml.rels")};
+        while (!xml.atEnd())
+        {
+            if (xml.readNext() == QXmlStreamReader::StartElement
+                    && xml.name() == QLatin1String("Relationship"))
+            {
+                const auto &attributes = xml.attributes();
+                const QString &target = attributes.value("Target").toString();
+                relId_target[attributes.value("Id").toString()] = target;
+                if (attributes.value("Type").endsWith(QLatin1String("/sharedStrings")))
+                {
+                    m_sharedStringsEntryPath = _toEntryPath(target);
+                }
+            }
+        }
+    }
+    QXmlStreamReader xml{m_zipReader->fileData("xl/workbook.xml")};
+    while (!xml.atEnd())
+    {
+        if (xml.readNext() == QXmlStreamReader::StartElement
+                && xml.name() == QLatin1String("sheet"))
+        {
+            const auto &attributes = xml.attributes();
+            const QString &sheetName = attributes.value("name").toString();
+            const QString &relId = attributes.value(NAMESPACE_RELATIONSHIPS, "id").toString();
+            m_sheetNames << sheetName;
+            if (relId_target.contains(relId))
+            {
+                m_sheetName_entryPath[sheetName] = _toEntryPath(relId_target[relId]);
+            }
+        }
+    }
+}
+
+void XlsxStreamReader::_readSharedStrings()
+{
+    m_sharedStringsRead = true;
+    if (m_sharedStringsEntryPath.isEmpty())
+    {
+        return;
+    }
+    auto device = _openEntry(m_sharedStringsEntryPath);
+    QXmlStreamReader xml{device.get()};
+    while (!xml.atEnd())
+    {
+        if (xml.readNext() == QXmlStreamReader::StartElement)
+        {
+            if (xml.name() == QLatin1String("sst"))
+            {
+                const auto &attributes = xml.attributes();
+                const auto &uniqueCount = attributes.value("uniqueCount");
+                if (!uniqueCount.isEmpty())
+                {
+                    m_sharedStrings.reserve(uniqueCount.toInt());
+                }
+            }
+            else if (xml.name() == QLatin1String("si"))
+            {
+                m_sharedStrings << _readText(xml);
+            }
+        }
+    }
+}
+
+QString XlsxStreamReader::_readText(QXmlStreamReader &xml)
+{
+    // <si>, <is> or <r>: concatenates the runs, ignoring phonetic hints
+    QString text;
+    while (xml.readNextStartElement())
+    {
+        if (xml.name() == QLatin1String("t"))
+        {
+            text += xml.readElementText();
+        }
+        else if (xml.name() == QLatin1String("r"))
+        {
+            text += _readText(xml);
+        }
+        else
+        {
+            xml.skipCurrentElement();
+        }
+    }
+    return text;
+}
+
+XlsxSheetRows XlsxStreamReader::readSheet(
+        const QString &sheetName
+        , const RowHandler &rowHandler
+        , int nColumnsMax)
+{
+    XlsxSheetRows sheet;
+    const auto &entryPath = sheetEntryPath(sheetName);
+    if (entryPath.isEmpty())
+    {
+        return sheet;
+    }
+    if (!m_sharedStringsRead)
+    {
+        _readSharedStrings();
+    }
+    int row = -1;
+    int col = -1;
+    int lastRowDimension = 0;
+    int lastColumnDimension = 0;
+    int rowValues = -1;
+    QStringList values; // Cells of the row being read
+    auto keepRow = [&sheet, &rowHandler, &rowValues, &values]()
+    {
+        if (rowValues >= 0 && !values.isEmpty()
+                && (!rowHandler || rowHandler(rowValues, values)))
+        {
+            while (sheet.rows.size() <= rowValues)
+            {
+                sheet.rows << QStringList{};
+            }
+            sheet.rows[rowValues] = std::move(values);
+        }
+        values = QStringList{};
+        rowValues = -1;
+    };
+    auto device = _openEntry(entryPath);
+    QXmlStreamReader xml{device.get()};
+    while (!xml.atEnd())
+    {
+        if (xml.readNext() != QXmlStreamReader::StartElement)
+        {
+            continue;
+        }
+        if (xml.name() == QLatin1String("dimension"))
+        {
+            // Same as QXlsx which takes the dimension written in the file
+            const auto &attributes = xml.attributes();
+            const auto &ref = attributes.value("ref");
+            const auto &lastRef = ref.mid(ref.indexOf(':') + 1);
+            lastRowDimension = rowIndex(lastRef) + 1;
+            lastColumnDimension = columnIndex(lastRef) + 1;
+        }
+        else if (xml.name() == QLatin1String("row"))
+        {
+            const auto &attributes = xml.attributes();
+            const auto &rowRef = attributes.value("r");
+            row = rowRef.isEmpty() ? row + 1 : rowRef.toInt() - 1;
+            col = -1;
+        }
+        else if (xml.name() == QLatin1String("c"))
+        {
+            const auto &attributes = xml.attributes();
+            const auto &cellRef = attributes.value("r");
+            if (cellRef.isEmpty())
+            {
+                ++col;
+            }
+            else
+            {
+                col = columnIndex(cellRef);
+                row = rowIndex(cellRef);
+            }
+            const QString &type = attributes.value("t").toString();
+            QString rawValue;
+            QString value;
+            while (xml.readNextStartElement())
+            {
+                if (xml.name() == QLatin1String("v"))
+                {
+                    rawValue = xml.readElementText();
+                }
+                else if (xml.name() == QLatin1String("is"))
+                {
+                    value = _readText(xml);
+                }
+                else
+                {
+                    xml.skipCurrentElement();
+                }
+            }
+            if (row < 0 || col < 0)
+            {
+                continue;
+            }
+            sheet.lastRow = qMax(sheet.lastRow, row + 1);
+            sheet.lastColumn = qMax(sheet.lastColumn, col + 1);
+            if (nColumnsMax >= 0 && col >= nColumnsMax)
+            {
+                continue;
+            }
+            if (type == "s")
+            {
+                value = m_sharedStrings.value(rawValue.toInt());
+            }
+            else if (type == "b")
+            {
+                value = QVariant{rawValue.toInt() != 0}.toString();
+            }
+            else if (type == "str" || type == "e" || type == "d")
+            {
+                value = rawValue;
+            }
+            else if (type != "inlineStr" && !rawValue.isEmpty())
+            {
+                value = QVariant{rawValue.toDouble()}.toString(); // Same conversion as QXlsx
+            }
+            if (value.isNull())
+            {
+                value = QStringLiteral(""); // Keeps existing cells distinct from missing ones
+            }
+            if (row != rowValues)
+            {
+                keepRow();
+                rowValues = row;
+                if (row < sheet.rows.size())
+                {
+                    values = sheet.rows[row]; // Cells of a row written in several parts
+                }
+            }
+            while (values.size() < col)
+            {
+                values << QString{};
+            }
+            if (values.size() == col)
+            {
+                values << value;
+            }
+            else
+            {
+                values[col] = value;
+            }
+        }
+    }
+    keepRow();
+    sheet.lastRow = qMax(sheet.lastRow, lastRowDimension);
+    sheet.lastColumn = qMax(sheet.lastColumn, lastColumnDimension);
+    return sheet;
+}
+
+int XlsxStreamReader::columnIndex(QStringView cellRef)
+{
+    int col = 0;
+    for (const auto &character : cellRef)
+    {
+        if (character.unicode() >= u'A' && character.unicode() <= u'Z')
+        {
+            col = col * 26 + (character.unicode() - u'A' + 1);
+        }
+        else
+        {
+            break;
+        }
+    }
+    return col - 1;
+}
+
+int XlsxStreamReader::rowIndex(QStringView cellRef)
+{
+    int i = 0;
+    while (i < cellRef.size() && cellRef[i].unicode() >= u'A' && cellRef[i].unicode() <= u'Z')
+    {
+        ++i;
+    }
+    return cellRef.mid(i).toInt() - 1;
+}
+
+QString XlsxStreamReader::columnName(int columnIndex)
+{
+    QString name;
+    int col = columnIndex + 1;
+    while (col > 0)
+    {
+        int remainder = (col - 1) % 26;
+        name.prepend(QChar('A' + remainder));
+        col = (col - 1) / 26;
+    }
+    return name;
+}
@@ -0,0 +1,70 @@
+#ifndef XLSXSTREAMREADER_H
+#define XLSXSTREAMREADER_H
+
+#include <functional>
+#include <memory>
+
+#include <QHash>
+#include <QList>
+#include <QScopedPointer>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+
+class QIODevice;
+class QXmlStreamReader;
+
+namespace QXlsx {
+class ZipReader;
+}
+
+struct XlsxSheetRows
+{
+    QList<QStringList> rows; // 0-based, null QString when no cell
+    int lastRow = 0;
+    int lastColumn = 0;
+
+    QString cellVal(int row, int col) const;
+    bool hasCell(int row, int col) const;
+};
+
+// Forward only reader of XLSX worksheets with a pull parser. Only the workbook
+// index, the shared strings and the sheets asked for are decompressed, one at a time.
+// A sheet is inflated while it is parsed, so only the rows kept are in memory.
+class XlsxStreamReader
+{
+public:
+    // Called with each row of the sheet, returns false so the row isn't kept
+    using RowHandler = std::function<bool(int row, QStringList &values)>;
+    explicit XlsxStreamReader(const QString &filePath);
+    ~XlsxStreamReader();
+    bool isValid() const;
+    const QStringList &sheetNames() const;
+    QStringList entryPaths() const;
+    QByteArray entryData(const QString &entryPath) const;
+    QString sheetEntryPath(const QString &sheetName) const;
+    // Cells of the columns after nColumnsMax are not kept, -1 keeps them all
+    XlsxSheetRows readSheet(const QString &sheetName
+                            , const RowHandler &rowHandler = nullptr
+                            , int nColumnsMax = -1);
+
+    static int columnIndex(QStringView cellRef); // "AB12" => 27
+    static int rowIndex(QStringView cellRef); // "AB12" => 11
+    static QString columnName(int columnIndex); // 27 => "AB"
+
+private:
+    QString m_filePath;
+    QScopedPointer<QXlsx::ZipReader> m_zipReader;
+    QStringList m_sheetNames;
+    QHash<QString, QString> m_sheetName_entryPath;
+    QString m_sharedStringsEntryPath;
+    QStringList m_sharedStrings;
+    bool m_sharedStringsRead;
+    std::unique_ptr<QIODevice> _openEntry(const QString &entryPath) const;
+    void _readWorkbook();
+    void _readSharedStrings();
+    static QString _readText(QXmlStreamReader &xml);
+    static QString _toEntryPath(const QString &target);
+};
+
+#endif // XLSXSTREAMREADER_H
@@ -0,0 +1,334 @@
+#include <QRegularExpression>
+
+#include <xlsxzipwriter_p.h>
+
+#include "XlsxTemplateWriter.h"
+
+XlsxTemplateWriter::XlsxTemplateWriter(const QString &filePath)
+    : m_reader(filePath)
+{
+}
+
+const QStringList &XlsxTemplateWriter::sheetNames() const
+{
+    return m_reader.sheetNames();
+}
+
+bool XlsxTemplateWriter::selectSheet(const QString &sheetName)
+{
+    m_sheetEntryPath = m_reader.sheetEntryPath(sheetName);
+    m_rowsVisible.clear();
+    m_row_col_value.clear();
+    return !m_sheetEntryPath.isEmpty();
+}
+
+void XlsxTemplateWriter::setRowHidden(int row, bool hidden)
+{
+    if (hidden)
+    {
+        m_rowsVisible.remove(row);
+    }
+    else
+    {
+        m_rowsVisible.insert(row);
+    }
+}
+
+void XlsxTemplateWriter::write(int row, int col, const QString &value)
+{
+    m_row_col_value[row][col] = value;
+}
+
+bool XlsxTemplateWriter::saveAs(const QString &filePath)
+{
+    if (m_sheetEntryPath.isEmpty())
+    {
+        return false;
+    }
+    const auto &patchedSheet = _patchSheet(m_reader.entryData(m_sheetEntryPath));
+    if (patchedSheet.isEmpty())
+    {
+        return false;
+    }
+    QXlsx::ZipWriter zipWriter{filePath};
+    const auto &entryPaths = m_reader.entryPaths();
+    for (const auto &entryPath : entryPaths)
+    {
+        if (entryPath.endsWith("/"))
+        {
+            continue;
+        }
+        if (entryPath == m_sheetEntryPath)
+        {
+            zipWriter.addFile(entryPath, patchedSheet);
+        }
+        else
+        {
+            zipWriter.addFile(entryPath, m_reader.entryData(entryPath));
+        }
+    }
+    zipWriter.close();
+    return !zipWriter.error();
+}
+
+QByteArray XlsxTemplateWriter::_patchSheet(const QByteArray &sheetXml) const
+{
+    static const QRegularExpression regExpRowRef{R"(\sr="(\d+)")"};
+    int posSheetData = sheetXml.indexOf("<sheetData");
+    if (posSheetData < 0)
+    {
+        return QByteArray{};
+    }
+    int posSheetDataTagEnd = sheetXml.indexOf('>', posSheetData);
+    QByteArray sheetData;
+    int posAfterSheetData = 0;
+    if (sheetXml[posSheetDataTagEnd - 1] == '/')
+    {
+        posAfterSheetData = posSheetDataTagEnd + 1;
+    }
+    else
+    {
+        const QByteArray sheetDataEnd{"</sheetData>"};
+        int posSheetDataEnd = sheetXml.indexOf(sheetDataEnd, posSheetDataTagEnd);
+        sheetData = sheetXml.mid(posSheetDataTagEnd + 1, posSheetDataEnd - posSheetDataTagEnd - 1);
+        posAfterSheetData = posSheetDataEnd + sheetDataEnd.size();
+    }
+
+    QByteArray patched;
+    patched.reserve(sheetXml.size() + m_row_col_value.size() * 1024);
+    patched += sheetXml.left(posSheetData);
+    patched += "<sheetData>";
+    auto itRow = m_row_col_value.cbegin();
+    int pos = 0;
+    int lastRowRead = 0;
+    while (true)
+    {
+        int posRow = sheetData.indexOf("<row", pos);
+        if (posRow < 0)
+        {
+            break;
+        }
+        int posTagEnd = sheetData.indexOf('>', posRow);
+        bool selfClosing = sheetData[posTagEnd - 1] == '/';
+        int posRowEnd = selfClosing ? posTagEnd + 1 : sheetData.indexOf("</row>", posTagEnd) + 6;
+        const QByteArray &rowXml = sheetData.mid(posRow, posRowEnd - posRow);
+        const auto &match = regExpRowRef.match(
+                    QString::fromUtf8(sheetData.mid(posRow, posTagEnd - posRow + 1)));
+        int row = match.hasMatch() ? match.captured(1).toInt() : lastRowRead + 1;
+        lastRowRead = row;
+
+        patched += sheetData.mid(pos, posRow - pos);
+        for (; itRow != m_row_col_value.cend() && itRow.key() < row; ++itRow)
+        {
+            patched += _rowXml(itRow.key(), itRow.value());
+        }
+        if (itRow != m_row_col_value.cend() && itRow.key() == row)
+        {
+            patched += _mergeRowXml(rowXml, row, itRow.value());
+            ++itRow;
+        }
+        else if (m_rowsVisible.contains(row))
+        {
+            patched += _setRowVisible(rowXml);
+        }
+        else
+        {
+            patched += rowXml;
+        }
+        pos = posRowEnd;
+    }
+    patched += sheetData.mid(pos);
+    for (; itRow != m_row_col_value.cend(); ++itRow)
+    {
+        patched += _rowXml(itRow.key(), itRow.value());
+    }
+    patched += "</sheetData>";
+    patched += sheetXml.mid(posAfterSheetData);
+    return _patchDimension(patched);
+}
+
+QByteArray XlsxTemplateWriter::_rowXml(
+        int row, const QMap<int, QString> &col_value) const
+{
+    QByteArray xml{"<row r=\"" + QByteArray::number(row) + "\">"};
+    for (auto it = col_value.cbegin(); it != col_value.cend(); ++it)
+    {
+        xml += _cellXml(row, it.key(), it.value());
+    }
+    xml += "</row>";
+    return xml;
+}
+
+QByteArray XlsxTemplateWriter::_mergeRowXml(
+        const QByteArray &rowXml, int row, const QMap<int, QString> &col_value) const
+{
+    static const QRegularExpression regExpCellRef{R"(\sr="([A-Z]+)\d+")"};
+    static const QRegularExpression regExpCellStyle{R"(\ss="(\d+)")"};
+    static const QRegularExpression regExpSpans{R"(\sspans="[^"]*")"};
+    int posTagEnd = rowXml.indexOf('>');
+    bool selfClosing = rowXml[posTagEnd - 1] == '/';
+    QByteArray startTag{_setRowVisible(rowXml.left(posTagEnd + 1))};
+    if (selfClosing)
+    {
+        startTag.remove(startTag.lastIndexOf('/'), 1);
+    }
+    // The existing cells are kept unless written, then all are sorted by column.
+    // A written cell keeps the style of the cell it replaces.
+    QMap<int, QByteArray> col_cellXml;
+    QMap<int, QByteArray> col_style;
+    int posRowContentEnd = selfClosing ? posTagEnd + 1 : rowXml.lastIndexOf("</row>");
+    int pos = posTagEnd + 1;
+    int lastCol = 0;
+    while (pos < posRowContentEnd)
+    {
+        int posCell = rowXml.indexOf("<c", pos);
+        if (posCell < 0 || posCell >= posRowContentEnd)
+        {
+            break;
+        }
+        char charAfter = rowXml[posCell + 2];
+        if (charAfter != ' ' && charAfter != '>' && charAfter != '/')
+        {
+            pos = posCell + 2;
+            continue;
+        }
+        int posCellTagEnd = rowXml.indexOf('>', posCell);
+        int posCellEnd = rowXml[posCellTagEnd - 1] == '/'
+                ? posCellTagEnd + 1 : rowXml.indexOf("</c>", posCellTagEnd) + 4;
+        const QString &cellStartTag = QString::fromUtf8(rowXml.mid(posCell, posCellTagEnd - posCell + 1));
+        const auto &match = regExpCellRef.match(cellStartTag);
+        int col = match.hasMatch()
+                ? XlsxStreamReader::columnIndex(match.captured(1) + "1") + 1 : lastCol + 1;
+        lastCol = col;
+        if (!col_value.contains(col))
+        {
+            col_cellXml[col] = rowXml.mid(posCell, posCellEnd - posCell);
+        }
+        else
+        {
+            const auto &matchStyle = regExpCellStyle.match(cellStartTag);
+            if (matchStyle.hasMatch())
+            {
+                col_style[col] = matchStyle.captured(1).toLatin1();
+            }
+        }
+        pos = posCellEnd;
+    }
+    for (auto it = col_value.cbegin(); it != col_value.cend(); ++it)
+    {
+        const auto &cellXml = _cellXml(row, it.key(), it.value(), col_style.value(it.key()));
+        if (!cellXml.isEmpty())
+        {
+            col_cellXml[it.key()] = cellXml;
+        }
+    }
+    // spans is only a hint of the columns used, it must still cover them
+    QString startTagString{QString::fromUtf8(startTag)};
+    if (startTagString.contains(regExpSpans))
+    {
+        startTagString.replace(
+                    regExpSpans
+                    , col_cellXml.isEmpty() ? QString{} : QString{" spans=\"%1:%2\""}.arg(
+                                                  QString::number(col_cellXml.firstKey())
+                                                  , QString::number(col_cellXml.lastKey())));
+        startTag = startTagString.toUtf8();
+    }
+    QByteArray xml{startTag};
+    for (auto it = col_cellXml.cbegin(); it != col_cellXml.cend(); ++it)
+    {
+        xml += it.value();
+    }
+    if (!selfClosing)
+    {
+        xml += rowXml.mid(pos, posRowContentEnd - pos); // extLst after the cells
+    }
+    xml += "</row>";
+    return xml;
+}
+
+QByteArray XlsxTemplateWriter::_cellXml(
+        int row, int col, const QString &value, const QByteArray &style) const
+{
+    if (value.isEmpty() && style.isEmpty())
+    {
+        return QByteArray{};
+    }
+    QByteArray xml{"<c r=\""};
+    xml += XlsxStreamReader::columnName(col - 1).toLatin1();
+    xml += QByteArray::number(row);
+    xml += "\"";
+    if (!style.isEmpty())
+    {
+        xml += " s=\"" + style + "\"";
+    }
+    if (value.isEmpty())
+    {
+        xml += "/>"; // Emptied but still formatted
+        return xml;
+    }
+    xml += " t=\"inlineStr\"><is><t xml:space=\"preserve\">";
+    xml += _escape(value);
+    xml += "</t></is></c>";
+    return xml;
+}
+
+QByteArray XlsxTemplateWriter::_setRowVisible(const QByteArray &rowXml) const
+{
+    static const QRegularExpression regExpHidden{R"(\s+hidden="(1|true)")"};
+    int posTagEnd = rowXml.indexOf('>');
+    QString startTag{QString::fromUtf8(rowXml.left(posTagEnd + 1))};
+    startTag.remove(regExpHidden);
+    return startTag.toUtf8() + rowXml.mid(posTagEnd + 1);
+}
+
+QByteArray XlsxTemplateWriter::_patchDimension(const QByteArray &sheetXml) const
+{
+    static const QRegularExpression regExpDimension{
+        R"(<dimension ref="([A-Z]+[0-9]+)(?::([A-Z]+[0-9]+))?")"};
+    int posDimension = sheetXml.indexOf("<dimension ");
+    if (posDimension < 0 || m_row_col_value.isEmpty())
+    {
+        return sheetXml;
+    }
+    int posTagEnd = sheetXml.indexOf('>', posDimension);
+    const QString tag{QString::fromUtf8(sheetXml.mid(posDimension, posTagEnd - posDimension + 1))};
+    const auto &match = regExpDimension.match(tag);
+    if (!match.hasMatch())
+    {
+        return sheetXml;
+    }
+    const QString &firstRef = match.captured(1);
+    const QString &lastRef = match.captured(2).isEmpty() ? firstRef : match.captured(2);
+    int lastRow = qMax(XlsxStreamReader::rowIndex(lastRef) + 1, m_row_col_value.lastKey());
+    int lastColumn = XlsxStreamReader::columnIndex(lastRef) + 1;
+    for (auto it = m_row_col_value.cbegin(); it != m_row_col_value.cend(); ++it)
+    {
+        if (!it.value().isEmpty())
+        {
+            lastColumn = qMax(lastColumn, it.value().lastKey());
+        }
+    }
+    const QString &newTag = "<dimension ref=\"" + firstRef + ":"
+            + XlsxStreamReader::columnName(lastColumn - 1) + QString::number(lastRow) + "\""
+            + tag.mid(match.capturedEnd(0));
+    QByteArray patched{sheetXml.left(posDimension)};
+    patched += newTag.toUtf8();
+    patched += sheetXml.mid(posTagEnd + 1);
+    return patched;
+}
+
+QByteArray XlsxTemplateWriter::_escape(const QString &value)
+{
+    QString cleaned;
+    cleaned.reserve(value.size());
+    for (const auto &character : value)
+    {
+        // Control characters are not allowed in XML 1.0
+        if (character.unicode() >= 0x20
+                || character == '\t' || character == '\n' || character == '\r')
+        {
+            cleaned += character;
+        }
+    }
+    return cleaned.toHtmlEscaped().toUtf8();
+}
@@ -0,0 +1,41 @@
+#ifndef XLSXTEMPLATEWRITER_H
+#define XLSXTEMPLATEWRITER_H
+
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "XlsxStreamReader.h"
+
+// Writes cells in one sheet of a copy of an XLSX file. Only the XML part of
+// the selected sheet is patched, other zip entries are copied as they are so
+// styles, data validations and macros are kept. Rows and columns are 1-based
+// as in QXlsx::Document. Written cells are inline strings: a new row is added
+// as a <row> element and the cells of an existing row are merged in it, the
+// written columns replacing the cells already there but keeping their style.
+class XlsxTemplateWriter
+{
+public:
+    explicit XlsxTemplateWriter(const QString &filePath);
+    const QStringList &sheetNames() const;
+    bool selectSheet(const QString &sheetName);
+    void setRowHidden(int row, bool hidden);
+    void write(int row, int col, const QString &value);
+    bool saveAs(const QString &filePath);
+
+private:
+    XlsxStreamReader m_reader;
+    QString m_sheetEntryPath;
+    QSet<int> m_rowsVisible;
+    QMap<int, QMap<int, QString>> m_row_col_value;
+    QByteArray _patchSheet(const QByteArray &sheetXml) const;
+    QByteArray _rowXml(int row, const QMap<int, QString> &col_value) const;
+    QByteArray _mergeRowXml(const QByteArray &rowXml, int row, const QMap<int, QString> &col_value) const;
+    QByteArray _cellXml(int row, int col, const QString &value, const QByteArray &style = QByteArray{}) const;
+    QByteArray _setRowVisible(const QByteArray &rowXml) const;
+    QByteArray _patchDimension(const QByteArray &sheetXml) const;
+    static QByteArray _escape(const QString &value);
+};
+
+#endif // XLSXTEMPLATEWRITER_H
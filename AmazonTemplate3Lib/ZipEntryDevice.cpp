@@ -0,0 +1,244 @@
+#include <limits>
+
+#include <QtEndian>
+
+#include <zlib.h>
+
+#include "ZipEntryDevice.h"
+
+const qint64 ZipEntryDevice::CHUNK_SIZE = 64 * 1024;
+
+static const quint32 SIGNATURE_END_OF_CENTRAL_DIR = 0x06054b50;
+static const quint32 SIGNATURE_CENTRAL_DIR = 0x02014b50;
+static const quint32 SIGNATURE_LOCAL_HEADER = 0x04034b50;
+static const int SIZE_END_OF_CENTRAL_DIR = 22;
+static const int SIZE_CENTRAL_DIR = 46;
+static const int SIZE_LOCAL_HEADER = 30;
+static const int COMMENT_SIZE_MAX = 0xFFFF;
+static const quint32 ZIP64_SIZE = 0xFFFFFFFF;
+static const int METHOD_STORED = 0;
+static const int METHOD_DEFLATED = 8;
+
+static quint16 readUInt16(const char *data)
+{
+    return qFromLittleEndian<quint16>(data);
+}
+
+static quint32 readUInt32(const char *data)
+{
+    return qFromLittleEndian<quint32>(data);
+}
+
+ZipEntryDevice::ZipEntryDevice(
+        const QString &zipFilePath, const QString &entryPath, QObject *parent)
+    : QIODevice(parent)
+    , m_zipFile(zipFilePath)
+    , m_entryPath(entryPath)
+    , m_zStream(new z_stream_s{})
+{
+    m_compressionMethod = -1;
+    m_compressedLeft = 0;
+    m_uncompressedLeft = 0;
+    m_zStreamInit = false;
+}
+
+ZipEntryDevice::~ZipEntryDevice()
+{
+    close();
+}
+
+bool ZipEntryDevice::open(OpenMode mode)
+{
+    if ((mode & QIODevice::WriteOnly) || !m_zipFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    if (!_seekEntryData())
+    {
+        m_zipFile.close();
+        return false;
+    }
+    if (m_compressionMethod == METHOD_DEFLATED)
+    {
+        *m_zStream = z_stream_s{};
+        if (inflateInit2(m_zStream.data(), -MAX_WBITS) != Z_OK) // Raw deflate as in zip files
+        {
+            m_zipFile.close();
+            return false;
+        }
+        m_zStreamInit = true;
+    }
+    return QIODevice::open(mode | QIODevice::Unbuffered);
+}
+
+void ZipEntryDevice::close()
+{
+    if (m_zStreamInit)
+    {
+        inflateEnd(m_zStream.data());
+        m_zStreamInit = false;
+    }
+    m_zipFile.close();
+    m_compressedChunk.clear();
+    QIODevice::close();
+}
+
+bool ZipEntryDevice::isSequential() const
+{
+    return true;
+}
+
+qint64 ZipEntryDevice::bytesAvailable() const
+{
+    return m_uncompressedLeft + QIODevice::bytesAvailable();
+}
+
+bool ZipEntryDevice::_seekEntryData()
+{
+    // The end of central directory record is followed by a comment of up to 64 KB
+    const qint64 fileSize = m_zipFile.size();
+    const qint64 tailSize = qMin(fileSize, qint64(SIZE_END_OF_CENTRAL_DIR + COMMENT_SIZE_MAX));
+    if (tailSize < SIZE_END_OF_CENTRAL_DIR || !m_zipFile.seek(fileSize - tailSize))
+    {
+        return false;
+    }
+    const QByteArray &tail = m_zipFile.read(tailSize);
+    int posEnd = -1;
+    for (int i = tail.size() - SIZE_END_OF_CENTRAL_DIR; i >= 0; --i)
+    {
+        if (readUInt32(tail.constData() + i) == SIGNATURE_END_OF_CENTRAL_DIR)
+        {
+            posEnd = i;
+            break;
+        }
+    }
+    if (posEnd < 0)
+    {
+        return false;
+    }
+    const char *end = tail.constData() + posEnd;
+    const quint32 centralDirSize = readUInt32(end + 12);
+    const quint32 centralDirOffset = readUInt32(end + 16);
+    if (centralDirOffset == ZIP64_SIZE || !m_zipFile.seek(centralDirOffset))
+    {
+        return false;
+    }
+    const QByteArray &centralDir = m_zipFile.read(centralDirSize);
+    const QByteArray &entryPath = m_entryPath.toUtf8();
+    qint64 localHeaderOffset = -1;
+    int pos = 0;
+    while (pos + SIZE_CENTRAL_DIR <= centralDir.size())
+    {
+        const char *header = centralDir.constData() + pos;
+        if (readUInt32(header) != SIGNATURE_CENTRAL_DIR)
+        {
+            return false;
+        }
+        const quint16 nameSize = readUInt16(header + 28);
+        const quint16 extraSize = readUInt16(header + 30);
+        const quint16 commentSize = readUInt16(header + 32);
+        if (pos + SIZE_CENTRAL_DIR + nameSize > centralDir.size())
+        {
+            return false;
+        }
+        if (QByteArray::fromRawData(header + SIZE_CENTRAL_DIR, nameSize) == entryPath)
+        {
+            const quint16 flags = readUInt16(header + 8);
+            m_compressionMethod = readUInt16(header + 10);
+            const quint32 compressedSize = readUInt32(header + 20);
+            const quint32 uncompressedSize = readUInt32(header + 24);
+            if ((flags & 0x1) != 0 // Encrypted
+                    || (m_compressionMethod != METHOD_STORED && m_compressionMethod != METHOD_DEFLATED)
+                    || compressedSize == ZIP64_SIZE
+                    || uncompressedSize == ZIP64_SIZE)
+            {
+                return false;
+            }
+            m_compressedLeft = compressedSize;
+            m_uncompressedLeft = uncompressedSize;
+            localHeaderOffset = readUInt32(header + 42);
+            break;
+        }
+        pos += SIZE_CENTRAL_DIR + nameSize + extraSize + commentSize;
+    }
+    if (localHeaderOffset < 0 || !m_zipFile.seek(localHeaderOffset))
+    {
+        return false;
+    }
+    // The local header has its own extra field, the sizes are in the central one
+    const QByteArray &localHeader = m_zipFile.read(SIZE_LOCAL_HEADER);
+    if (localHeader.size() != SIZE_LOCAL_HEADER
+            || readUInt32(localHeader.constData()) != SIGNATURE_LOCAL_HEADER)
+    {
+        return false;
+    }
+    const qint64 dataOffset = localHeaderOffset + SIZE_LOCAL_HEADER
+            + readUInt16(localHeader.constData() + 26)
+            + readUInt16(localHeader.constData() + 28);
+    return m_zipFile.seek(dataOffset);
+}
+
+qint64 ZipEntryDevice::readData(char *data, qint64 maxSize)
+{
+    if (maxSize <= 0 || m_uncompressedLeft == 0)
+    {
+        return 0;
+    }
+    if (m_compressionMethod == METHOD_STORED)
+    {
+        const qint64 nRead = m_zipFile.read(data, qMin(maxSize, m_compressedLeft));
+        if (nRead < 0)
+        {
+            setErrorString(m_zipFile.errorString());
+            return -1;
+        }
+        m_compressedLeft -= nRead;
+        m_uncompressedLeft -= nRead;
+        return nRead;
+    }
+    auto zStream = m_zStream.data();
+    zStream->next_out = reinterpret_cast<Bytef *>(data);
+    zStream->avail_out = static_cast<uInt>(qMin(maxSize, qint64(std::numeric_limits<uInt>::max())));
+    const uInt availOutBefore = zStream->avail_out;
+    while (zStream->avail_out == availOutBefore)
+    {
+        if (zStream->avail_in == 0)
+        {
+            if (m_compressedLeft == 0)
+            {
+                break;
+            }
+            m_compressedChunk = m_zipFile.read(qMin(CHUNK_SIZE, m_compressedLeft));
+            if (m_compressedChunk.isEmpty())
+            {
+                setErrorString(tr("Truncated zip entry %1").arg(m_entryPath));
+                return -1;
+            }
+            m_compressedLeft -= m_compressedChunk.size();
+            zStream->next_in = reinterpret_cast<Bytef *>(m_compressedChunk.data());
+            zStream->avail_in = static_cast<uInt>(m_compressedChunk.size());
+        }
+        const int result = inflate(zStream, Z_NO_FLUSH);
+        if (result == Z_STREAM_END)
+        {
+            break;
+        }
+        if (result != Z_OK && (result != Z_BUF_ERROR || zStream->avail_in != 0))
+        {
+            setErrorString(tr("Corrupted zip entry %1").arg(m_entryPath));
+            return -1;
+        }
+    }
+    const qint64 nInflated = availOutBefore - zStream->avail_out;
+    m_uncompressedLeft = qMax(qint64(0), m_uncompressedLeft - nInflated);
+    if (nInflated == 0)
+    {
+        m_uncompressedLeft = 0; // The stream ended before the size of the entry
+    }
+    return nInflated;
+}
+
+qint64 ZipEntryDevice::writeData(const char *, qint64)
+{
+    return -1;
+}
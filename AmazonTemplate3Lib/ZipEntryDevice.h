@@ -0,0 +1,44 @@
+#ifndef ZIPENTRYDEVICE_H
+#define ZIPENTRYDEVICE_H
+
+#include <QFile>
+#include <QIODevice>
+#include <QScopedPointer>
+
+struct z_stream_s;
+
+// Sequential read-only device over one entry of a zip file. The entry is
+// inflated in small chunks as it is read, so a pull parser reading from the
+// device never holds the whole decompressed entry in memory. Only stored and
+// deflated entries without zip64 or encryption are supported, open() fails
+// on the others so the caller can fall back to a full decompression.
+class ZipEntryDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    ZipEntryDevice(const QString &zipFilePath, const QString &entryPath, QObject *parent = nullptr);
+    ~ZipEntryDevice() override;
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override;
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    static const qint64 CHUNK_SIZE;
+    QFile m_zipFile;
+    QString m_entryPath;
+    int m_compressionMethod;
+    qint64 m_compressedLeft;
+    qint64 m_uncompressedLeft;
+    QByteArray m_compressedChunk;
+    QScopedPointer<z_stream_s> m_zStream;
+    bool m_zStreamInit;
+    bool _seekEntryData();
+};
+
+#endif // ZIPENTRYDEVICE_H
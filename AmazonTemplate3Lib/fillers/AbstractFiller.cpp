@@ -16,9 +16,13 @@
 #include "FillerText.h"
 #include "FillerTitle.h"
 #include "ExceptionTemplate.h"
+#include "ImagePreparer.h"
 
 
 #include "AbstractFiller.h"
+#include "AiScheduler.h"
+#include "AiTelemetry.h"
+#include "Tracer.h"
 
 const QList<const AbstractFiller *> AbstractFiller::ALL_FILLERS_SORTED
 = []() -> QList<const AbstractFiller *>
@@ -52,7 +56,7 @@ QCoro::Task<void> AbstractFiller::fillValuesForAi(
         , Gender gender
         , Age age
         , const QMap<QString, QString> &skuPattern_customInstructions
-        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
+        , const SkuFieldMatrix &sku_fieldId_fromValues
         , QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi)
 {
     const QString settingsFileName{"aiImageDescriptions.ini"};
@@ -185,9 +189,21 @@ QCoro::Task<void> AbstractFiller::fillValuesForAi(
         imagePath_attributesForAi[imagePath] += ": ";
         imagePath_attributesForAi[imagePath] += attributesForAi.join(", "); // TODO cedric, not well retrieved / filled
     }
-    QList<QSharedPointer<OpenAi2::StepMultipleAsk>> steps;
+    QStringList imagePathsToDescribe;
     const auto &imagePaths = imagePath_attributesForAi.keys();
     for (const auto &imagePath : imagePaths)
+    {
+        if (!imagePath_aiReply.contains(imagePath))
+        {
+            imagePathsToDescribe << imagePath;
+        }
+    }
+    // Smaller images are sent so the upload doesn't take most of the time
+    const auto &imagePath_preparedPath
+            = co_await templateFiller->imagePreparer()->prepare(imagePathsToDescribe);
+
+    QList<QSharedPointer<OpenAi2::StepMultipleAsk>> steps;
+    for (const auto &imagePath : imagePaths)
     {
         if (!imagePath_aiReply.contains(imagePath))
         {
@@ -196,7 +212,7 @@ QCoro::Task<void> AbstractFiller::fillValuesForAi(
             step->id = imagePath; // Unique ID for caching/tracking
             step->gptModel = "gpt-5.2";
             step->neededReplies = 1;
-            step->imagePaths = QStringList{imagePath};
+            step->imagePaths = QStringList{imagePath_preparedPath.value(imagePath, imagePath)};
             step->maxRetries = 5;
 
             step->getPrompt = [imagePath, imagePath_attributesForAi](int nAttempts) -> QString{
@@ -241,7 +257,9 @@ QCoro::Task<void> AbstractFiller::fillValuesForAi(
         {
             qDebug() << "--\nAbstractFiller::fillValuesForAi:" << step->getPrompt(0);
         }
-        co_await OpenAi2::instance()->askGptMultipleTimeCoro(steps, "gpt-5.2");
+        Tracer::instance()->traceSteps(steps);
+        AiTelemetry::instance()->instrument(steps, "AbstractFiller", "description");
+        co_await AiScheduler::instance()->ask(steps, "gpt-5.2", AiScheduler::High);
     }
 
     for (auto it = sku_imagePreviewFilePath.begin();
@@ -278,6 +296,24 @@ QCoro::Task<void> AbstractFiller::fillValuesForAi(
     co_return;
 }
 
+void AbstractFiller::prepare(
+        const TemplateFiller *, const QStringList &, FillContext &) const
+{
+}
+
+QCoro::Task<void> AbstractFiller::prefetch(
+        TemplateFiller *
+        , const FillContext &
+        , const QString &
+        , const QHash<QString, const Attribute *> &
+        , const QString &
+        , const QString &
+        , const QString &
+        , const QHash<QString, QHash<QString, QString>> &) const
+{
+    co_return;
+}
+
 void AbstractFiller::recordAllMarketplace(
         const TemplateFiller *templateFiller
         , const QString &marketplace
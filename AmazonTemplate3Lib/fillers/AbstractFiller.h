@@ -2,12 +2,16 @@
 #define ABSTRACTFILLER_H
 
 #include <QString>
+#include <QStringList>
 
 #include <QCoroTask>
 
+#include "SkuFieldMatrix.h"
+
 class Attribute;
 
 class TemplateFiller;
+struct FillContext;
 
 class AbstractFiller
 {
@@ -34,7 +38,7 @@ public:
             , Gender gender
             , Age age
             , const QMap<QString, QString> &skuPattern_customInstructions
-            , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
+            , const SkuFieldMatrix &sku_fieldId_fromValues
             , QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
             );
     static void recordAllMarketplace(
@@ -44,34 +48,44 @@ public:
             , QHash<QString, QString> &fieldId_values
             , const QString &value);
 
+    // Name of the filler in the dispatch dump and in the fill checkpoints, so
+    // it must not change when the code is built with another compiler
+    virtual QString name() const = 0;
     virtual bool canFill(const TemplateFiller *templateFiller
                          , const Attribute *attribute
                          , const QString &marketplaceFrom
                          , const QString &fieldIdFrom) const = 0;
+    // Called once per run with the fields routed to the filler, before any
+    // target is filled, so the indexes it derives from the from values are
+    // built once in the context
+    virtual void prepare(const TemplateFiller *templateFiller
+                         , const QStringList &fieldIdsFrom
+                         , FillContext &context) const;
     virtual QCoro::Task<void> fill(
             TemplateFiller *templateFiller
-            , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-            , const QString &marketplaceFrom
+            , const FillContext &context
             , const QString &marketplaceTo
             , const QString &fieldIdFrom
             , const QString &fieldIdTo
             , const Attribute *attribute
-            , const QString &productTypeFrom
             , const QString &productTypeTo
-            , const QString &countryCodeFrom
-            , const QString &langCodeFrom
             , const QString &countryCodeTo
             , const QString &langCodeTo
-            , const QHash<QString, QHash<QString, QString>> &countryCode_langCode_keywords
-            , const QHash<QString, QHash<QString, QHash<QString, QString>>> &skuPattern_countryCode_langCode_keywords
-            , Gender gender
-            , Age age
-            , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
-            , const QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
             , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesFrom
             , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommon
             , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues
             ) const = 0;
+    // Called once per target before fill() is called for each field of
+    // fieldIdFrom_attribute, so AI can be asked for several fields at once
+    virtual QCoro::Task<void> prefetch(
+            TemplateFiller *templateFiller
+            , const FillContext &context
+            , const QString &marketplaceTo
+            , const QHash<QString, const Attribute *> &fieldIdFrom_attribute
+            , const QString &productTypeTo
+            , const QString &countryCodeTo
+            , const QString &langCodeTo
+            , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues) const;
 protected:
     QString getValueId(
             const QString &marketplaceTo
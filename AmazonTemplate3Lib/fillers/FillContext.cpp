@@ -0,0 +1,28 @@
+#include "FillContext.h"
+
+void FillContext::buildTopology()
+{
+    skus.clear();
+    skus.reserve(sku_fieldId_fromValues.rowCount());
+    for (int i=0; i<sku_fieldId_fromValues.rowCount(); ++i)
+    {
+        skus << sku_fieldId_fromValues.sku(i);
+    }
+    sku_parentSku.clear();
+    sku_variation.clear();
+    for (auto itParent = parentSku_variation_skus.cbegin();
+         itParent != parentSku_variation_skus.cend(); ++itParent)
+    {
+        const auto &skuParent = itParent.key();
+        for (auto itVar = itParent.value().cbegin();
+             itVar != itParent.value().cend(); ++itVar)
+        {
+            const auto &variation = itVar.key();
+            for (const auto &sku : itVar.value())
+            {
+                sku_parentSku[sku] = skuParent;
+                sku_variation[sku] = variation;
+            }
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef FILLCONTEXT_H
+#define FILLCONTEXT_H
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "SkuFieldMatrix.h"
+
+#include "AbstractFiller.h"
+
+// State of a fill run shared by all the fillers and targets. It is built
+// once by TemplateFiller::fillValues() then only read, the fillers getting
+// it by const reference instead of rebuilding the same indexes at each
+// fill() call. The containers are implicitly shared with TemplateFiller.
+struct FillContext
+{
+    QString marketplaceFrom;
+    QString productTypeFrom;
+    QString countryCodeFrom;
+    QString langCodeFrom;
+    QMap<QString, QStringList> langCode_targetPaths; // Targets other than the from template
+    AbstractFiller::Gender gender = AbstractFiller::UndefinedGender;
+    AbstractFiller::Age age = AbstractFiller::UndefinedAge;
+    QHash<QString, QHash<QString, QString>> countryCode_langCode_keywords;
+    QHash<QString, QHash<QString, QHash<QString, QString>>> skuPattern_countryCode_langCode_keywords;
+    SkuFieldMatrix sku_fieldId_fromValues;
+    QHash<QString, QMap<QString, QString>> sku_attribute_valuesForAi;
+
+    QStringList skus; // Order of the from template
+    QHash<QString, QHash<QString, QSet<QString>>> parentSku_variation_skus;
+    QHash<QString, QString> sku_parentSku;
+    QHash<QString, QString> sku_variation;
+
+    // Filled by AbstractFiller::prepare()
+    QHash<QString, QHash<QString, QSet<QString>>> fieldIdFrom_titleFrom_skus;
+
+    void buildTopology(); // skus, sku_parentSku and sku_variation
+};
+
+#endif // FILLCONTEXT_H
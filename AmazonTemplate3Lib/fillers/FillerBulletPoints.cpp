@@ -8,7 +8,9 @@
 #include "FillerBulletPoints.h"
 #include "AiFailureTable.h"
 #include "AttributeFlagsTable.h"
-#include "FillerSelectable.h"
+#include "AiScheduler.h"
+#include "AiTelemetry.h"
+#include "Tracer.h"
 
 const QStringList FillerBulletPoints::BULLET_POINT_PATTERNS{
     "bullet_point%1", "bullet_point#%1.value"};
@@ -28,6 +30,11 @@ const QSet<QString> FillerBulletPoints::BULLET_POINT_IDS
         return bulletPointIds;
 }();
 
+QString FillerBulletPoints::name() const
+{
+    return "FillerBulletPoints";
+}
+
 bool FillerBulletPoints::canFill(
         const TemplateFiller *templateFiller
         , const Attribute *attribute
@@ -140,31 +147,21 @@ static QSharedPointer<OpenAi2::StepMultipleAsk> createBulletPointsStep(
 
 QCoro::Task<void> FillerBulletPoints::fill(
         TemplateFiller *templateFiller
-        , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-        , const QString &marketplaceFrom
+        , const FillContext &context
         , const QString &marketplaceTo
         , const QString &fieldIdFrom
         , const QString &fieldIdTo
         , const Attribute *attribute
-        , const QString &productTypeFrom
         , const QString &productTypeTo
-        , const QString &countryCodeFrom
-        , const QString &langCodeFrom
         , const QString &countryCodeTo
         , const QString &langCodeTo
-        , const QHash<QString, QHash<QString, QString>> &countryCode_langCode_keywords
-        , const QHash<QString, QHash<QString, QHash<QString, QString>>> &skuPattern_countryCode_langCode_keywords
-        , Gender gender
-        , Age age
-        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
-        , const QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
         , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesFrom
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommon
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues) const
 {
     QStringList bulletPointsFrom{5};
-    for (auto it = sku_fieldId_fromValues.cbegin();
-         it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin();
+         it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
         for (int i=1; i<=5; ++i)
@@ -173,11 +170,11 @@ QCoro::Task<void> FillerBulletPoints::fill(
             for (const auto &pattern : BULLET_POINT_PATTERNS)
             {
                 curFieldId = pattern.arg(i);
-                if (sku_fieldId_fromValues[sku].contains(curFieldId)
-                        && !sku_fieldId_fromValues[sku][curFieldId].isEmpty())
+                if (context.sku_fieldId_fromValues[sku].contains(curFieldId)
+                        && !context.sku_fieldId_fromValues[sku][curFieldId].isEmpty())
                 {
                     bulletPointsFrom[i-1]
-                            = sku_fieldId_fromValues[sku][curFieldId];
+                            = context.sku_fieldId_fromValues[sku][curFieldId];
                 }
             }
         }
@@ -190,12 +187,9 @@ QCoro::Task<void> FillerBulletPoints::fill(
     QSet<QString> launchedValueIds;
 
     auto attributeFlagsTable = templateFiller->attributeFlagsTable();
-    bool childSameValue = attributeFlagsTable->hasFlag(marketplaceFrom, fieldIdFrom, Attribute::ChildSameValue);
-    bool allSameValue = attributeFlagsTable->hasFlag(marketplaceFrom, fieldIdFrom, Attribute::SameValue);
+    bool childSameValue = attributeFlagsTable->hasFlag(context.marketplaceFrom, fieldIdFrom, Attribute::ChildSameValue);
+    bool allSameValue = attributeFlagsTable->hasFlag(context.marketplaceFrom, fieldIdFrom, Attribute::SameValue);
 
-    QHash<QString, QString> sku_parentSku;
-    QHash<QString, QString> sku_variation;
-    FillerSelectable::fillVariationsParents(parentSku_variation_skus, sku_parentSku, sku_variation);
 
     auto getVariationForValueId = [&](const QString &sku, bool isParent) -> QString
     {
@@ -203,23 +197,23 @@ QCoro::Task<void> FillerBulletPoints::fill(
         {
             if (allSameValue)
             {
-                return *parentSku_variation_skus[sku].begin().value().begin(); // We take the first child sku
+                return *context.parentSku_variation_skus[sku].begin().value().begin(); // We take the first child sku
             }
         }
         else
         {
-            return sku_variation[sku];
+            return context.sku_variation[sku];
         }
         return QString();
     };
 
     QHash<QString, QString> valueId_gptReply;
 
-    for (auto it = sku_fieldId_fromValues.cbegin();
-         it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin();
+         it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
-        bool isParent = parentSku_variation_skus.contains(sku);
+        bool isParent = context.parentSku_variation_skus.contains(sku);
         QString variationForValueId = getVariationForValueId(sku, isParent);
         const QString &valueId = getValueId(
                     marketplaceTo
@@ -227,7 +221,7 @@ QCoro::Task<void> FillerBulletPoints::fill(
                     , langCodeTo
                     , allSameValue
                     , childSameValue
-                    , isParent ? sku : sku_parentSku[sku]
+                    , isParent ? sku : context.sku_parentSku[sku]
                     , variationForValueId
                     , BULLET_POINT_PATTERN_MAIN
                     );
@@ -245,15 +239,15 @@ QCoro::Task<void> FillerBulletPoints::fill(
                 curFieldId = pattern.arg(i);
                 
                 // If we have a value from "from" values, propagate it (legacy logic preserved essentially)
-                if (sku_fieldId_fromValues[sku].contains(curFieldId)
-                        && !sku_fieldId_fromValues[sku][curFieldId].isEmpty())
+                if (context.sku_fieldId_fromValues[sku].contains(curFieldId)
+                        && !context.sku_fieldId_fromValues[sku][curFieldId].isEmpty())
                 {
                     recordAllMarketplace(
                                 templateFiller
                                 , marketplaceTo
                                 , curFieldId
                                 , sku_fieldId_toValueslangCommon[sku]
-                                , sku_fieldId_fromValues[sku][curFieldId]);
+                                , context.sku_fieldId_fromValues[sku][curFieldId]);
                     found = true;
                 }
                 
@@ -333,19 +327,19 @@ QCoro::Task<void> FillerBulletPoints::fill(
             if (!found)
             {
                 launchedValueIds.insert(valueId);
-                const auto &valuesForAi = sku_attribute_valuesForAi[sku];
+                const auto &valuesForAi = context.sku_attribute_valuesForAi[sku];
 
                 auto task = [=, &valueId_gptReply]() -> QCoro::Task<void> {
 
                     // Create step
                     // Note: we pass bulletPoints which contains partial existing bullets if any
-                    auto step = createBulletPointsStep(valueId, langCodeTo, productTypeFrom, valuesForAi, bulletPoints);
+                    auto step = createBulletPointsStep(valueId, langCodeTo, context.productTypeFrom, valuesForAi, bulletPoints);
                      
                     step->apply = [valueId, &valueId_gptReply](const QString &reply) {
                         valueId_gptReply[valueId] = reply;
                     };
 
-                    step->onLastError = [valueId, templateFiller, marketplaceTo, countryCodeTo, countryCodeFrom](const QString &reply, QNetworkReply::NetworkError networkError, const QString &lastWhy) -> bool
+                    step->onLastError = [valueId, templateFiller, marketplaceTo, countryCodeTo, countryCodeFrom = context.countryCodeFrom](const QString &reply, QNetworkReply::NetworkError networkError, const QString &lastWhy) -> bool
                     {
                         QString errorMsg = QString("NetworkError: %1 | valueId:%2 | Reply: %3 | Error: %4")
                                 .arg(QString::number(networkError), valueId, reply, lastWhy);
@@ -363,7 +357,9 @@ QCoro::Task<void> FillerBulletPoints::fill(
                     steps.append(step);
                     qDebug() << "--\nFillerBulletPoints::fill new task:" << step->getPrompt(0);
                     
-                    co_await OpenAi2::instance()->askGptMultipleTimeCoro(steps, "gpt-5.2");
+                    Tracer::instance()->traceSteps(steps);
+                    AiTelemetry::instance()->instrument(steps, "FillerBulletPoints", fieldIdTo);
+                    co_await AiScheduler::instance()->ask(steps, "gpt-5.2", AiScheduler::Low);
                 };
                 tasks << QSharedPointer<QCoro::Task<void>>::create(task());
             }
@@ -401,12 +397,12 @@ QCoro::Task<void> FillerBulletPoints::fill(
         valueId_bulletPoints[it.key()] = parseJsonToBullets(it.value());
     }
 
-    for (auto it = sku_fieldId_fromValues.cbegin();
-         it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin();
+         it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
         
-        bool isParent = parentSku_variation_skus.contains(sku);
+        bool isParent = context.parentSku_variation_skus.contains(sku);
         QString variationForValueId = getVariationForValueId(sku, isParent);
         const QString &valueId = getValueId(
                     marketplaceTo
@@ -414,7 +410,7 @@ QCoro::Task<void> FillerBulletPoints::fill(
                     , langCodeTo
                     , allSameValue
                     , childSameValue
-                    , isParent ? sku : sku_parentSku[sku]
+                    , isParent ? sku : context.sku_parentSku[sku]
                     , variationForValueId
                     , BULLET_POINT_PATTERN_MAIN
                     );
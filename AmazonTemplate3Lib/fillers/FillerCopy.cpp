@@ -4,6 +4,11 @@
 
 #include "FillerCopy.h"
 
+QString FillerCopy::name() const
+{
+    return "FillerCopy";
+}
+
 bool FillerCopy::canFill(
         const TemplateFiller *templateFiller
         , const Attribute *attribute
@@ -20,30 +25,20 @@ bool FillerCopy::canFill(
 
 QCoro::Task<void> FillerCopy::fill(
         TemplateFiller *templateFiller
-        , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-        , const QString &marketplaceFrom
+        , const FillContext &context
         , const QString &marketplaceTo
         , const QString &fieldIdFrom
         , const QString &fieldIdTo
         , const Attribute *attribute
-        , const QString &productTypeFrom
         , const QString &productTypeTo
-        , const QString &countryCodeFrom
-        , const QString &langCodeFrom
         , const QString &countryCodeTo
         , const QString &langCodeTo
-        , const QHash<QString, QHash<QString, QString>> &countryCode_langCode_keywords
-        , const QHash<QString, QHash<QString, QHash<QString, QString>>> &skuPattern_countryCode_langCode_keywords
-        , Gender gender
-        , Age age
-        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
-        , const QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
-        , const QHash<QString, QHash<QString, QString> > &sku_fieldId_toValuesFrom
+        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesFrom
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommon
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues) const
 {
-    for (auto it = sku_fieldId_fromValues.cbegin();
-         it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin();
+         it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
         const auto &fieldId_fromValues = it.value();
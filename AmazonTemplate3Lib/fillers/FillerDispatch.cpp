@@ -0,0 +1,69 @@
+#include "AbstractFiller.h"
+
+#include "FillerDispatch.h"
+
+FillerDispatch::FillerDispatch(
+        const TemplateFiller *templateFiller
+        , const QString &marketplaceFrom
+        , const QStringList &sortedFieldIds
+        , const QList<const Attribute *> &position_attribute
+        , const QList<const AbstractFiller *> &fillersSorted)
+    : m_sortedFieldIds(sortedFieldIds)
+    , m_position_attribute(position_attribute)
+    , m_position_filler(sortedFieldIds.size(), nullptr)
+{
+    for (const auto &filler : fillersSorted)
+    {
+        Entry entry{filler, QList<int>{}};
+        for (int i=0; i<sortedFieldIds.size(); ++i)
+        {
+            if (m_position_filler[i] == nullptr
+                    && filler->canFill(templateFiller, position_attribute[i], marketplaceFrom, sortedFieldIds[i]))
+            {
+                m_position_filler[i] = filler;
+                entry.positions << i;
+            }
+        }
+        if (!entry.positions.isEmpty())
+        {
+            m_entries << entry;
+        }
+    }
+}
+
+const QList<FillerDispatch::Entry> &FillerDispatch::entries() const
+{
+    return m_entries;
+}
+
+const QStringList &FillerDispatch::sortedFieldIds() const
+{
+    return m_sortedFieldIds;
+}
+
+const Attribute *FillerDispatch::attribute(int position) const
+{
+    return m_position_attribute[position];
+}
+
+const AbstractFiller *FillerDispatch::filler(int position) const
+{
+    return m_position_filler[position];
+}
+
+QString FillerDispatch::dump() const
+{
+    QString dump{"Filler dispatch:\n"};
+    for (int i=0; i<m_sortedFieldIds.size(); ++i)
+    {
+        dump += QString("  %1 -> %2\n").arg(
+                    m_sortedFieldIds[i]
+                    , m_position_filler[i] == nullptr ? QString{"NONE"} : fillerName(m_position_filler[i]));
+    }
+    return dump;
+}
+
+QString FillerDispatch::fillerName(const AbstractFiller *filler)
+{
+    return filler->name();
+}
@@ -0,0 +1,46 @@
+#ifndef FILLERDISPATCH_H
+#define FILLERDISPATCH_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+class AbstractFiller;
+class Attribute;
+class TemplateFiller;
+
+// Fillers of the mandatory fields resolved once per run. The routing only
+// depends on the from marketplace, the field id and its flags so canFill is
+// asked once per filler and field instead of once per target. Each field
+// goes to the first filler of fillersSorted (AbstractFiller::ALL_FILLERS_SORTED
+// for a fill) that can fill it. Entries follow fillersSorted, each one with
+// the positions of its fields in the sorted field ids.
+class FillerDispatch
+{
+public:
+    struct Entry
+    {
+        const AbstractFiller *filler;
+        QList<int> positions;
+    };
+    FillerDispatch() = default;
+    FillerDispatch(const TemplateFiller *templateFiller
+                   , const QString &marketplaceFrom
+                   , const QStringList &sortedFieldIds
+                   , const QList<const Attribute *> &position_attribute
+                   , const QList<const AbstractFiller *> &fillersSorted);
+    const QList<Entry> &entries() const;
+    const QStringList &sortedFieldIds() const;
+    const Attribute *attribute(int position) const;
+    const AbstractFiller *filler(int position) const; // nullptr if none can fill it
+    QString dump() const; // One line per field with its filler
+    static QString fillerName(const AbstractFiller *filler);
+
+private:
+    QStringList m_sortedFieldIds;
+    QList<const Attribute *> m_position_attribute;
+    QList<Entry> m_entries;
+    QList<const AbstractFiller *> m_position_filler;
+};
+
+#endif // FILLERDISPATCH_H
@@ -1,6 +1,13 @@
+#include "FillContext.h"
+
 #include "FillerKeywords.h"
 
 
+QString FillerKeywords::name() const
+{
+    return "FillerKeywords";
+}
+
 bool FillerKeywords::canFill(
         const TemplateFiller *templateFiller
         , const Attribute *attribute
@@ -12,30 +19,20 @@ bool FillerKeywords::canFill(
 
 QCoro::Task<void> FillerKeywords::fill(
         TemplateFiller *templateFiller
-        , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-        , const QString &marketplaceFrom
+        , const FillContext &context
         , const QString &marketplaceTo
         , const QString &fieldIdFrom
         , const QString &fieldIdTo
         , const Attribute *attribute
-        , const QString &productTypeFrom
         , const QString &productTypeTo
-        , const QString &countryCodeFrom
-        , const QString &langCodeFrom
         , const QString &countryCodeTo
         , const QString &langCodeTo
-        , const QHash<QString, QHash<QString, QString>> &countryCode_langCode_keywords
-        , const QHash<QString, QHash<QString, QHash<QString, QString>>> &skuPattern_countryCode_langCode_keywords
-        , Gender gender
-        , Age age
-        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
-        , const QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
         , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesFrom
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommon
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues) const
 {
-    for (auto it = sku_fieldId_fromValues.cbegin();
-         it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin();
+         it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
         const auto &fieldId_fromValues = it.value();
@@ -43,13 +40,13 @@ QCoro::Task<void> FillerKeywords::fill(
         {
             QString keywordsForSku;
             bool found = false;
-            QStringList patterns = skuPattern_countryCode_langCode_keywords.keys();
+            QStringList patterns = context.skuPattern_countryCode_langCode_keywords.keys();
             patterns.sort();
             for (const auto &pattern : patterns)
             {
                  if (sku.contains(pattern, Qt::CaseInsensitive))
                  {
-                     const auto &countryCode_langCode_keywords_local = skuPattern_countryCode_langCode_keywords[pattern];
+                     const auto &countryCode_langCode_keywords_local = context.skuPattern_countryCode_langCode_keywords[pattern];
                      if (countryCode_langCode_keywords_local.contains(countryCodeTo)
                              && countryCode_langCode_keywords_local[countryCodeTo].contains(langCodeTo))
                      {
@@ -61,10 +58,10 @@ QCoro::Task<void> FillerKeywords::fill(
             }
             if (!found)
             {
-                 if (countryCode_langCode_keywords.contains(countryCodeTo)
-                         && countryCode_langCode_keywords[countryCodeTo].contains(langCodeTo))
+                 if (context.countryCode_langCode_keywords.contains(countryCodeTo)
+                         && context.countryCode_langCode_keywords[countryCodeTo].contains(langCodeTo))
                  {
-                     keywordsForSku = countryCode_langCode_keywords[countryCodeTo][langCodeTo];
+                     keywordsForSku = context.countryCode_langCode_keywords[countryCodeTo][langCodeTo];
                  }
             }
             if (!keywordsForSku.isEmpty())
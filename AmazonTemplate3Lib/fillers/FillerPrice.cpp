@@ -1,5 +1,12 @@
+#include "FillContext.h"
+
 #include "FillerPrice.h"
 
+QString FillerPrice::name() const
+{
+    return "FillerPrice";
+}
+
 bool FillerPrice::canFill(const TemplateFiller *, const Attribute *attribute, const QString &marketplaceFrom, const QString &fieldIdFrom) const
 {
     Q_UNUSED(marketplaceFrom)
@@ -8,24 +15,14 @@ bool FillerPrice::canFill(const TemplateFiller *, const Attribute *attribute, co
 
 QCoro::Task<void> FillerPrice::fill(
         TemplateFiller *templateFiller
-        , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-        , const QString &marketplaceFrom
+        , const FillContext &context
         , const QString &marketplaceTo
         , const QString &fieldIdFrom
         , const QString &fieldIdTo
         , const Attribute *attribute
-        , const QString &productTypeFrom
         , const QString &productTypeTo
-        , const QString &countryCodeFrom
-        , const QString &langCodeFrom
         , const QString &countryCodeTo
         , const QString &langCodeTo
-        , const QHash<QString, QHash<QString, QString>> &countryCode_langCode_keywords
-        , const QHash<QString, QHash<QString, QHash<QString, QString>>> &skuPattern_countryCode_langCode_keywords
-        , Gender gender
-        , Age age
-        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
-        , const QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
         , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesFrom
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommon
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues) const
@@ -52,11 +49,11 @@ QCoro::Task<void> FillerPrice::fill(
             {"AE", "AED"},
         };
         const auto &currency = country_currency[countryCodeTo];
-        for (auto it = sku_fieldId_fromValues.cbegin();
-             it != sku_fieldId_fromValues.cend(); ++it)
+        for (auto it = context.sku_fieldId_fromValues.cbegin();
+             it != context.sku_fieldId_fromValues.cend(); ++it)
         {
             const auto &sku = it.key();
-            if (!parentSku_variation_skus.contains(sku))
+            if (!context.parentSku_variation_skus.contains(sku))
             {
                 sku_fieldId_toValues[sku][fieldIdTo] = currency;
             }
@@ -83,14 +80,14 @@ QCoro::Task<void> FillerPrice::fill(
             , {"AU", 1.7775}
             , {"AE", 4.2333}     // via USD peg: 1.1527 * 3.6725
         };
-        Q_ASSERT(country_rate.contains(countryCodeFrom));
+        Q_ASSERT(country_rate.contains(context.countryCodeFrom));
         Q_ASSERT(country_rate.contains(countryCodeTo));
         QString fieldIdFromCorrected{fieldIdFrom};
         if (fieldIdFrom.contains("list_price")) // Difference between list_price#1.value and list_price#1.value_with_tax
         {
             bool doneOnce = false;
-            for (auto itSku = sku_fieldId_fromValues.cbegin();
-                 itSku != sku_fieldId_fromValues.cend() && !doneOnce; ++itSku)
+            for (auto itSku = context.sku_fieldId_fromValues.cbegin();
+                 itSku != context.sku_fieldId_fromValues.cend() && !doneOnce; ++itSku)
             {
                 const auto &fieldId_fromValues = itSku.value();
                 for (auto it = fieldId_fromValues.cbegin();
@@ -107,8 +104,8 @@ QCoro::Task<void> FillerPrice::fill(
             }
 
         }
-        for (auto it = sku_fieldId_fromValues.cbegin();
-             it != sku_fieldId_fromValues.cend(); ++it)
+        for (auto it = context.sku_fieldId_fromValues.cbegin();
+             it != context.sku_fieldId_fromValues.cend(); ++it)
         {
             const auto &sku = it.key();
             if (it.value().contains(fieldIdFromCorrected))
@@ -121,7 +118,7 @@ QCoro::Task<void> FillerPrice::fill(
                     double priceFrom = priceStringFrom.toDouble(&isDouble);
                     if (isDouble)
                     {
-                        double newPrice = priceFrom / country_rate[countryCodeFrom] * country_rate[countryCodeTo];
+                        double newPrice = priceFrom / country_rate[context.countryCodeFrom] * country_rate[countryCodeTo];
                         QString stringNewPrice = QString::number(newPrice, 'f', 2);
                         if (stringNewPrice.contains("."))
                         {
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <QMap>
 #include <QSet>
+#include <QCryptographicHash>
 #include <QJsonDocument>
 #include <QJsonObject>
 
@@ -17,27 +18,44 @@
 #include "FillerSize.h"
 #include "FillerSelectable.h"
 #include "AiFailureTable.h"
+#include "SelectConsensus.h"
+#include "AiScheduler.h"
+#include "AiTelemetry.h"
+#include "Tracer.h"
 
 
 
 FillerSelectable::EditCallback FillerSelectable::EDIT_MISSING_CALLBACK = nullptr;
+const int FillerSelectable::BATCH_QUESTIONS_MAX = 20;
+const int FillerSelectable::BATCH_POSSIBLE_VALUES_MAX = 50;
+static const QString SELECT_GPT_MODEL{"gpt-5.2"};
 
 void FillerSelectable::recordEditCallback(EditCallback callback)
 {
     EDIT_MISSING_CALLBACK = callback;
 }
 
+QString FillerSelectable::name() const
+{
+    return "FillerSelectable";
+}
+
 bool FillerSelectable::canFill(
         const TemplateFiller *templateFiller
         , const Attribute *attribute
         , const QString &marketplaceFrom
         , const QString &fieldIdFrom) const
 {
-    QList<const AbstractFiller *> otherFillers;
-    const FillerPrice fillerPrice;
-    otherFillers << &fillerPrice;
-    const FillerSize fillerSize;
-    otherFillers << &fillerSize;
+    static const QList<const AbstractFiller *> otherFillers
+            = []() -> QList<const AbstractFiller *>
+    {
+        QList<const AbstractFiller *> otherFillers;
+        static const FillerPrice fillerPrice;
+        otherFillers << &fillerPrice;
+        static const FillerSize fillerSize;
+        otherFillers << &fillerSize;
+        return otherFillers;
+    }();
     for (const auto &filler : otherFillers)
     {
         if (filler->canFill(templateFiller,
@@ -53,24 +71,14 @@ bool FillerSelectable::canFill(
 
 QCoro::Task<void> FillerSelectable::fill(
         TemplateFiller *templateFiller
-        , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-        , const QString &marketplaceFrom
+        , const FillContext &context
         , const QString &marketplaceTo
         , const QString &fieldIdFrom
         , const QString &fieldIdTo
         , const Attribute *attribute
-        , const QString &productTypeFrom
         , const QString &productTypeTo
-        , const QString &countryCodeFrom
-        , const QString &langCodeFrom
         , const QString &countryCodeTo
         , const QString &langCodeTo
-        , const QHash<QString, QHash<QString, QString>> &countryCode_langCode_keywords
-        , const QHash<QString, QHash<QString, QHash<QString, QString>>> &skuPattern_countryCode_langCode_keywords
-        , Gender gender
-        , Age age
-        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
-        , const QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
         , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesFrom
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommon
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues) const
@@ -83,8 +91,8 @@ QCoro::Task<void> FillerSelectable::fill(
     {
         qDebug() << "FillerSelectable::fill Single Value Path. Value:" << *possibleValues.cbegin();
         const auto &uniquePossibleValue = *possibleValues.cbegin();
-        for (auto it = sku_fieldId_fromValues.cbegin();
-             it != sku_fieldId_fromValues.cend(); ++it)
+        for (auto it = context.sku_fieldId_fromValues.cbegin();
+             it != context.sku_fieldId_fromValues.cend(); ++it)
         {
             const auto &sku = it.key();
             sku_fieldId_toValues[sku][fieldIdTo] = uniquePossibleValue;
@@ -93,28 +101,18 @@ QCoro::Task<void> FillerSelectable::fill(
     }
     else if (possibleValues.size() > 0)
     {
-        if (countryCodeFrom == countryCodeTo && langCodeFrom == langCodeTo)
+        if (context.countryCodeFrom == countryCodeTo && context.langCodeFrom == langCodeTo)
         {
             co_await _fillSameLangCountry(
                         templateFiller
-                        , parentSku_variation_skus
-                        , marketplaceFrom
+                        , context
                         , marketplaceTo
                         , fieldIdFrom
                         , fieldIdTo
                         , attribute
-                        , productTypeFrom
                         , productTypeTo
-                        , countryCodeFrom
-                        , langCodeFrom
                         , countryCodeTo
                         , langCodeTo
-                        , countryCode_langCode_keywords
-                        , skuPattern_countryCode_langCode_keywords
-                        , gender
-                        , age
-                        , sku_fieldId_fromValues
-                        , sku_attribute_valuesForAi
                         , sku_fieldId_toValuesFrom
                         , sku_fieldId_toValueslangCommon
                         , sku_fieldId_toValues
@@ -124,24 +122,14 @@ QCoro::Task<void> FillerSelectable::fill(
         {
             co_await _fillDifferentLangCountry(
                         templateFiller
-                        , parentSku_variation_skus
-                        , marketplaceFrom
+                        , context
                         , marketplaceTo
                         , fieldIdFrom
                         , fieldIdTo
                         , attribute
-                        , productTypeFrom
                         , productTypeTo
-                        , countryCodeFrom
-                        , langCodeFrom
                         , countryCodeTo
                         , langCodeTo
-                        , countryCode_langCode_keywords
-                        , skuPattern_countryCode_langCode_keywords
-                        , gender
-                        , age
-                        , sku_fieldId_fromValues
-                        , sku_attribute_valuesForAi
                         , sku_fieldId_toValuesFrom
                         , sku_fieldId_toValueslangCommon
                         , sku_fieldId_toValues
@@ -163,26 +151,15 @@ QCoro::Task<void> FillerSelectable::fill(
     co_return;
 }
 
-void FillerSelectable::fillVariationsParents(
-        const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-        , QHash<QString, QString> &sku_parentSku
-        , QHash<QString, QString> &sku_variation)
+static QString parseValue(const QString &json)
 {
-    for (auto itParent = parentSku_variation_skus.begin();
-         itParent != parentSku_variation_skus.end(); ++itParent)
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8(), &error);
+    if (error.error == QJsonParseError::NoError && doc.isObject())
     {
-        const auto &skuParent = itParent.key();
-        for (auto itVar = itParent.value().begin();
-             itVar != itParent.value().end(); ++itVar)
-        {
-            const auto &variation = itVar.key();
-            for (const auto &sku : itVar.value())
-            {
-                sku_parentSku[sku] = skuParent;
-                sku_variation[sku] = variation;
-            }
-        }
+        return doc.object().value("value").toString();
     }
+    return QString();
 }
 
 static QSharedPointer<OpenAi2::StepMultipleAsk> createSelectStep(
@@ -197,7 +174,7 @@ static QSharedPointer<OpenAi2::StepMultipleAsk> createSelectStep(
     step->id = id;
     step->name = "Select value for " + fieldId;
     step->cachingKey = step->id;
-    step->gptModel = "gpt-5.2";
+    step->gptModel = SELECT_GPT_MODEL;
     step->maxRetries = 10;
 
     step->getPrompt = [marketplace, id, fieldId, valuesForAi, possibleValues](int nAttempts) -> QString
@@ -255,6 +232,293 @@ static QSharedPointer<OpenAi2::StepMultipleAsk> createSelectStep(
     return step;
 }
 
+// One request for several fields of a same product. Each answer is checked
+// on its own: a missing or invalid answer only sends its field to fill(),
+// which asks it again alone. Each request is one sample: the answers of the
+// samples of a same batch are votes decided per field by SelectConsensus.
+QSharedPointer<OpenAi2::StepMultipleAsk> FillerSelectable::_createSelectBatchStep(
+        const QString &marketplace
+        , const QString &sku
+        , const QMap<QString, QString> &valuesForAi
+        , const QList<SelectQuestion> &questions
+        , int sample)
+{
+    QStringList valueIds;
+    for (const auto &question : questions)
+    {
+        valueIds << question.valueId;
+    }
+    QSharedPointer<OpenAi2::StepMultipleAsk> step(new OpenAi2::StepMultipleAsk);
+    step->id = "selectBatch_" + sku + "_" + QCryptographicHash::hash(
+                valueIds.join(",").toUtf8(), QCryptographicHash::Sha1).toHex().left(16)
+            + "_s" + QString::number(sample);
+    step->name = "Select values for " + QString::number(questions.size()) + " fields";
+    step->cachingKey = step->id;
+    step->gptModel = SELECT_GPT_MODEL;
+    step->neededReplies = 1;
+    step->maxRetries = 10;
+
+    step->getPrompt = [marketplace, valuesForAi, questions](int nAttempts) -> QString
+    {
+        Q_UNUSED(nAttempts)
+        QString prompt = QString("Marketplace: %1\n").arg(marketplace);
+        prompt += "Product Attributes:\n";
+        for (auto it = valuesForAi.begin(); it != valuesForAi.end(); ++it)
+        {
+            if (!it.value().isEmpty())
+            {
+                prompt += QString("- %1: %2\n").arg(it.key(), it.value());
+            }
+        }
+        for (int i=0; i<questions.size(); ++i)
+        {
+            prompt += QString("\nKey: q%1\nField: %2\nPossible Values:\n").arg(
+                        QString::number(i+1), questions[i].fieldIdTo);
+            QList<QString> sortedValues = questions[i].possibleValues.values();
+            std::sort(sortedValues.begin(), sortedValues.end());
+            for (const auto &val : sortedValues)
+            {
+                prompt += QString("- %1\n").arg(val);
+            }
+        }
+        prompt += "\nInstruction: For each key, select the most appropriate value from the 'Possible Values' list of its field that matches the product attributes. Reply ONLY with a valid JSON object with one entry per key containing the exact selected value. Example: {\"q1\": \"Selected Value\", \"q2\": \"Selected Value\"}. If no value matches, suggest the closest one.";
+        return prompt;
+    };
+
+    step->validate = [questions](const QString &gptReply, const QString &lastWhy) -> bool
+    {
+        Q_UNUSED(lastWhy)
+        return !_batchValueId_reply(gptReply, questions).isEmpty();
+    };
+
+    // apply not used directly here, managed in caller
+    step->apply = [](const QString &reply) {
+        Q_UNUSED(reply)
+    };
+
+    return step;
+}
+
+QHash<QString, QString> FillerSelectable::_batchValueId_reply(
+        const QString &reply, const QList<SelectQuestion> &questions)
+{
+    QHash<QString, QString> valueId_reply;
+    QJsonParseError error;
+    const QJsonDocument &doc = QJsonDocument::fromJson(reply.toUtf8(), &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject())
+    {
+        return valueId_reply;
+    }
+    const QJsonObject &obj = doc.object();
+    for (int i=0; i<questions.size(); ++i)
+    {
+        const QString &value = obj.value("q" + QString::number(i+1)).toString();
+        if (questions[i].possibleValues.contains(value))
+        {
+            // Same reply format as createSelectStep
+            const QJsonObject valueObject{{"value", value}};
+            valueId_reply[questions[i].valueId]
+                    = QString::fromUtf8(QJsonDocument{valueObject}.toJson(QJsonDocument::Compact));
+        }
+    }
+    return valueId_reply;
+}
+
+QHash<QString, QString> FillerSelectable::_decideBatch(
+        SelectConsensus *selectConsensus
+        , const QList<SelectQuestion> &questions
+        , const QStringList &replies
+        , int nSamples)
+{
+    QList<QHash<QString, QString>> valueId_replies;
+    for (const auto &reply : replies)
+    {
+        valueId_replies << _batchValueId_reply(reply, questions);
+    }
+    QHash<QString, QString> valueId_reply;
+    for (const auto &question : questions)
+    {
+        QStringList votes;
+        QHash<QString, QString> value_reply;
+        for (const auto &valueId_replySample : valueId_replies)
+        {
+            const auto &reply = valueId_replySample.value(question.valueId);
+            if (!reply.isEmpty())
+            {
+                const QString &value = parseValue(reply);
+                votes << value;
+                value_reply[value] = reply;
+            }
+        }
+        const QString &selectedValue = selectConsensus->decide(
+                    question.fieldIdTo, question.possibleValues.size(), votes, nSamples);
+        if (!selectedValue.isEmpty())
+        {
+            selectConsensus->record(question.fieldIdTo, votes);
+            valueId_reply[question.valueId] = value_reply[selectedValue];
+        }
+    }
+    return valueId_reply;
+}
+
+QCoro::Task<void> FillerSelectable::prefetch(
+        TemplateFiller *templateFiller
+        , const FillContext &context
+        , const QString &marketplaceTo
+        , const QHash<QString, const Attribute *> &fieldIdFrom_attribute
+        , const QString &productTypeTo
+        , const QString &countryCodeTo
+        , const QString &langCodeTo
+        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues) const
+{
+    if (context.countryCodeFrom != countryCodeTo || context.langCodeFrom != langCodeTo)
+    {
+        co_return; // Values of other countries come from AttributeEquivalentTable
+    }
+    auto attributeFlagsTable = templateFiller->attributeFlagsTable();
+    auto selectConsensus = templateFiller->selectConsensus();
+    const QString settingsFileName{"selectedValues.ini"};
+
+    // Same valueIds as _fillSameLangCountry so fill() then finds them in cache
+    QStringList skus;
+    QHash<QString, QList<SelectQuestion>> sku_questions;
+    QSet<QString> scheduledValueIds;
+    QStringList fieldIdsFrom{fieldIdFrom_attribute.keyBegin(), fieldIdFrom_attribute.keyEnd()};
+    fieldIdsFrom.sort();
+    for (const auto &fieldIdFrom : fieldIdsFrom)
+    {
+        const auto &attribute = fieldIdFrom_attribute[fieldIdFrom];
+        const auto &fieldIdTo = attributeFlagsTable->getFieldId(
+                    context.marketplaceFrom, fieldIdFrom, marketplaceTo);
+        const auto &possibleValues = attribute->possibleValues(
+                    marketplaceTo, countryCodeTo, langCodeTo, productTypeTo);
+        if (possibleValues.size() < 2 || possibleValues.size() > BATCH_POSSIBLE_VALUES_MAX)
+        {
+            continue;
+        }
+        bool childSameValue = attributeFlagsTable->hasFlag(context.marketplaceFrom, fieldIdFrom, Attribute::ChildSameValue);
+        bool allSameValue = attributeFlagsTable->hasFlag(context.marketplaceFrom, fieldIdFrom, Attribute::SameValue);
+        bool childOnly = attributeFlagsTable->hasFlag(context.marketplaceFrom, fieldIdFrom, Attribute::ChildOnly);
+        for (auto it = context.sku_fieldId_fromValues.cbegin();
+             it != context.sku_fieldId_fromValues.cend(); ++it)
+        {
+            const auto &sku = it.key();
+            if (!it.value().value(fieldIdFrom).isEmpty()
+                    || !sku_fieldId_toValues.value(sku).value(fieldIdTo).isEmpty()
+                    || (childOnly && context.parentSku_variation_skus.contains(sku)))
+            {
+                continue;
+            }
+            const auto &valuesForAi = context.sku_attribute_valuesForAi.value(sku);
+            if (!valuesForAi.contains("0_ai_description"))
+            {
+                continue;
+            }
+            const QString &valueId = _getValueId(
+                        marketplaceTo
+                        , countryCodeTo
+                        , langCodeTo
+                        , allSameValue
+                        , childSameValue
+                        , context.sku_parentSku[sku]
+                        , context.sku_variation[sku]
+                        , fieldIdTo
+                        );
+            if (scheduledValueIds.contains(valueId))
+            {
+                continue;
+            }
+            scheduledValueIds.insert(valueId);
+            if (templateFiller->hasAiValue(settingsFileName, valueId))
+            {
+                continue;
+            }
+            if (!sku_questions.contains(sku))
+            {
+                skus << sku;
+            }
+            sku_questions[sku] << SelectQuestion{valueId, fieldIdTo, possibleValues};
+        }
+    }
+
+    // Each batch is asked as many times as its least trusted field needs,
+    // the fields left undecided by the votes are asked again alone by fill()
+    QList<QSharedPointer<OpenAi2::StepMultipleAsk>> steps;
+    QList<QList<QSharedPointer<OpenAi2::StepMultipleAsk>>> batches_steps;
+    QList<QList<SelectQuestion>> batches_questions;
+    QList<QSharedPointer<QStringList>> batches_replies;
+    QList<int> batches_nSamples;
+    int nQuestions = 0;
+    for (const auto &sku : skus)
+    {
+        const auto &questions = sku_questions[sku];
+        nQuestions += questions.size();
+        for (int i=0; i<questions.size(); i += BATCH_QUESTIONS_MAX)
+        {
+            const auto &questionsBatch = questions.mid(i, BATCH_QUESTIONS_MAX);
+            int nSamples = 1;
+            for (const auto &question : questionsBatch)
+            {
+                nSamples = qMax(nSamples, selectConsensus->samplesFirst(
+                                    question.fieldIdTo, question.possibleValues.size()));
+            }
+            auto replies = QSharedPointer<QStringList>::create();
+            QList<QSharedPointer<OpenAi2::StepMultipleAsk>> batchSteps;
+            for (int sample=1; sample<=nSamples; ++sample)
+            {
+                auto step = _createSelectBatchStep(
+                            marketplaceTo, sku, context.sku_attribute_valuesForAi[sku], questionsBatch, sample);
+                step->apply = [replies](const QString &reply)
+                {
+                    *replies << reply;
+                };
+                step->onLastError = [](const QString &reply, QNetworkReply::NetworkError networkError, const QString &lastWhy) -> bool
+                {
+                    Q_UNUSED(reply)
+                    Q_UNUSED(networkError)
+                    Q_UNUSED(lastWhy)
+                    return true; // The fields are then asked one by one by fill()
+                };
+                batchSteps << step;
+            }
+            steps << batchSteps;
+            batches_steps << batchSteps;
+            batches_questions << questionsBatch;
+            batches_replies << replies;
+            batches_nSamples << nSamples;
+        }
+    }
+    if (!steps.isEmpty())
+    {
+        qDebug() << "FillerSelectable::prefetch" << nQuestions << "values in" << steps.size() << "requests";
+        Tracer::instance()->traceSteps(steps);
+        for (int i=0; i<batches_questions.size(); ++i)
+        {
+            // A batch is counted under the fields of its questions
+            QStringList fieldIdsTo;
+            for (const auto &question : batches_questions[i])
+            {
+                if (!fieldIdsTo.contains(question.fieldIdTo))
+                {
+                    fieldIdsTo << question.fieldIdTo;
+                }
+            }
+            fieldIdsTo.sort();
+            AiTelemetry::instance()->instrument(
+                        batches_steps[i], "FillerSelectable.batch", fieldIdsTo.join("+"));
+        }
+        co_await AiScheduler::instance()->ask(steps, "gpt-5.2", AiScheduler::Normal);
+        for (int i=0; i<batches_questions.size(); ++i)
+        {
+            templateFiller->saveAiValue(
+                        settingsFileName
+                        , _decideBatch(selectConsensus, batches_questions[i], *batches_replies[i], batches_nSamples[i])
+                        , SELECT_GPT_MODEL);
+        }
+    }
+    co_return;
+}
+
 QString FillerSelectable::_getValueId(
         const QString &marketplaceTo
         , const QString &countryCodeTo
@@ -281,34 +545,24 @@ QString FillerSelectable::_getValueId(
 
 QCoro::Task<void> FillerSelectable::_fillSameLangCountry(
         TemplateFiller *templateFiller
-        , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-        , const QString &marketplaceFrom
+        , const FillContext &context
         , const QString &marketplaceTo
         , const QString &fieldIdFrom
         , const QString &fieldIdTo
         , const Attribute *attribute
-        , const QString &productTypeFrom
         , const QString &productTypeTo
-        , const QString &countryCodeFrom
-        , const QString &langCodeFrom
         , const QString &countryCodeTo
         , const QString &langCodeTo
-        , const QHash<QString, QHash<QString, QString>> &countryCode_langCode_keywords
-        , const QHash<QString, QHash<QString, QHash<QString, QString>>> &skuPattern_countryCode_langCode_keywords
-        , Gender gender
-        , Age age
-        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
-        , const QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
         , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesFrom
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommon
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues) const
 {
     auto attributeFlagsTable = templateFiller->attributeFlagsTable();
-    bool childSameValue = attributeFlagsTable->hasFlag(marketplaceFrom, fieldIdFrom, Attribute::ChildSameValue);
-    bool allSameValue = attributeFlagsTable->hasFlag(marketplaceFrom, fieldIdFrom, Attribute::SameValue);
-    bool childOnly = attributeFlagsTable->hasFlag(marketplaceFrom, fieldIdFrom, Attribute::ChildOnly);
-    for (auto it = sku_fieldId_fromValues.cbegin();
-         it != sku_fieldId_fromValues.cend(); ++it)
+    bool childSameValue = attributeFlagsTable->hasFlag(context.marketplaceFrom, fieldIdFrom, Attribute::ChildSameValue);
+    bool allSameValue = attributeFlagsTable->hasFlag(context.marketplaceFrom, fieldIdFrom, Attribute::SameValue);
+    bool childOnly = attributeFlagsTable->hasFlag(context.marketplaceFrom, fieldIdFrom, Attribute::ChildOnly);
+    for (auto it = context.sku_fieldId_fromValues.cbegin();
+         it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
         const auto &fieldId_fromValues = it.value();
@@ -322,35 +576,22 @@ QCoro::Task<void> FillerSelectable::_fillSameLangCountry(
                 marketplaceTo, fieldIdTo, Attribute::AMAZON_V02);
     const auto &possibleValues = attribute->possibleValues(
                 marketplaceTo, countryCodeTo, langCodeTo, productTypeTo);
-    QHash<QString, QString> sku_parentSku;
-    QHash<QString, QString> sku_variation;
-    fillVariationsParents(parentSku_variation_skus, sku_parentSku, sku_variation);
     const QString settingsFileName{"selectedValues.ini"};
 
     QList<QSharedPointer<QCoro::Task<void>>> tasks;
     QSet<QString> scheduledValueIds;
 
-    auto parseValue = [](const QString &json) -> QString {
-        QJsonParseError error;
-        QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8(), &error);
-        if (error.error == QJsonParseError::NoError && doc.isObject())
-        {
-            return doc.object().value("value").toString();
-        }
-        return QString();
-    };
-
-    for (auto it = sku_fieldId_fromValues.cbegin();
-         it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin();
+         it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
-        bool isParent = parentSku_variation_skus.contains(sku);
+        bool isParent = context.parentSku_variation_skus.contains(sku);
         if (!isParent || !childOnly)
         {
             const auto &fieldId_toValues = sku_fieldId_toValues[sku];
             if (!fieldId_toValues.contains(fieldIdTo) || fieldId_toValues[fieldIdTo].isEmpty())
             {
-                const QMap<QString, QString> &valuesForAi = sku_attribute_valuesForAi[sku];
+                const QMap<QString, QString> &valuesForAi = context.sku_attribute_valuesForAi[sku];
                 Q_ASSERT(valuesForAi.size() > 0);
                 Q_ASSERT(valuesForAi.contains("0_ai_description"));
                 const QString &valueId = _getValueId(
@@ -359,8 +600,8 @@ QCoro::Task<void> FillerSelectable::_fillSameLangCountry(
                             , langCodeTo
                             , allSameValue
                             , childSameValue
-                            , sku_parentSku[sku]
-                            , sku_variation[sku]
+                            , context.sku_parentSku[sku]
+                            , context.sku_variation[sku]
                             , fieldIdTo
                             );
 
@@ -402,96 +643,16 @@ QCoro::Task<void> FillerSelectable::_fillSameLangCountry(
                     }
                     scheduledValueIds.insert(valueId);
 
-
-                    auto task = [=]() -> QCoro::Task<void> {
-
-                        QString selectedValue;
-                        bool found = false;
-
-                        // Phase 1: Ask 2 times, agreement check
-                        auto step = ::createSelectStep(valueId + "_p1", marketplaceTo, fieldIdTo, valuesForAi, possibleValues);
-                        step->neededReplies = 2;
-                        step->chooseBest = OpenAi2::CHOOSE_ALL_SAME_OR_EMPTY; // Returns empty if not all same
-
-                        QList<QSharedPointer<OpenAi2::StepMultipleAsk>> steps;
-                        steps.append(step);
-
-                        QString phase1Result;
-                        step->apply = [&](const QString &reply) {
-                            phase1Result = reply;
-                        };
-                        step->onLastError = [templateFiller, marketplaceTo, countryCodeTo, countryCodeFrom, fieldIdTo](const QString &reply, QNetworkReply::NetworkError networkError, const QString &lastWhy) -> bool
-                        {
-                            QString errorMsg = QString("NetworkError: %1 | Reply: %2 | Error: %3")
-                                    .arg(QString::number(networkError), reply, lastWhy);
-                            templateFiller->aiFailureTable()->recordError(marketplaceTo, countryCodeTo, countryCodeFrom, fieldIdTo, errorMsg);
-                            return true;
-                        };
-
-                        for (const auto &step : steps)
-                        {
-                        }
-
-                        co_await OpenAi2::instance()->askGptMultipleTimeCoro(steps, "gpt-5.2");
-
-
-                        // phase1Result is the JSON string if successful/agreed
-                        if (!phase1Result.isEmpty())
-                        {
-                            QString val = parseValue(phase1Result);
-                            if (possibleValues.contains(val))
-                            {
-                                selectedValue = val;
-                                found = true;
-                                // Save valid JSON reply to cache
-                                templateFiller->saveAiValue(settingsFileName, valueId, phase1Result);
-                            }
-                        }
-
-                        if (!found)
-                        {
-                            // Phase 2: Ask 5 times, frequent
-                            step->id = valueId + "_p2"; // Change ID to avoid cache collision
-                            step->cachingKey = step->id;
-                            step->neededReplies = 5;
-                            step->chooseBest = OpenAi2::CHOOSE_MOST_FREQUENT;
-                            step->maxRetries = 10;
-
-                            steps.clear();
-                            steps.append(step);
-
-                            QString phase2Result;
-                            step->apply = [&](const QString &reply) {
-                                phase2Result = reply;
-                            };
-                            step->onLastError = [templateFiller, marketplaceTo, countryCodeTo, countryCodeFrom, fieldIdTo](const QString &reply, QNetworkReply::NetworkError networkError, const QString &lastWhy) -> bool
-                            {
-                                QString errorMsg = QString("NetworkError: %1 | Reply: %2 | Error: %3")
-                                        .arg(QString::number(networkError), reply, lastWhy);
-                                templateFiller->aiFailureTable()->recordError(marketplaceTo, countryCodeTo, countryCodeFrom, fieldIdTo, errorMsg);
-                                return true;
-                            };
-
-                            for (const auto &step : steps)
-                            {
-                            }
-                            co_await OpenAi2::instance()->askGptMultipleTimeCoro(steps, "gpt-5.2");
-
-                            if (!phase2Result.isEmpty())
-                            {
-                                QString val = parseValue(phase2Result);
-                                if (possibleValues.contains(val))
-                                {
-                                    selectedValue = val;
-                                    found = true;
-                                    // Save valid JSON reply to cache
-                                    templateFiller->saveAiValue(settingsFileName, valueId, phase2Result);
-                                }
-                            }
-                        }
-                        co_return;
-                    };
-                    tasks << QSharedPointer<QCoro::Task<void>>::create(task());
+                    tasks << QSharedPointer<QCoro::Task<void>>::create(
+                                 _askSelection(templateFiller
+                                               , settingsFileName
+                                               , valueId
+                                               , marketplaceTo
+                                               , countryCodeTo
+                                               , context.countryCodeFrom
+                                               , fieldIdTo
+                                               , valuesForAi
+                                               , possibleValues));
                 }
             }
         }
@@ -504,17 +665,17 @@ QCoro::Task<void> FillerSelectable::_fillSameLangCountry(
         taskIdx++;
     }
 
-    for (auto it = sku_fieldId_fromValues.cbegin();
-         it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin();
+         it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
-        bool isParent = parentSku_variation_skus.contains(sku);
+        bool isParent = context.parentSku_variation_skus.contains(sku);
         if (!isParent || !childOnly)
         {
             const auto &fieldId_toValues = sku_fieldId_toValues[sku];
             if (!fieldId_toValues.contains(fieldIdTo) || fieldId_toValues[fieldIdTo].isEmpty())
             {
-                const QMap<QString, QString> &valuesForAi = sku_attribute_valuesForAi[sku];
+                const QMap<QString, QString> &valuesForAi = context.sku_attribute_valuesForAi[sku];
                 Q_ASSERT(valuesForAi.size() > 0);
                 const QString &valueId = _getValueId(
                             marketplaceTo
@@ -522,8 +683,8 @@ QCoro::Task<void> FillerSelectable::_fillSameLangCountry(
                             , langCodeTo
                             , allSameValue
                             , childSameValue
-                            , sku_parentSku[sku]
-                            , sku_variation[sku]
+                            , context.sku_parentSku[sku]
+                            , context.sku_variation[sku]
                             , fieldIdTo
                             );
 
@@ -547,26 +708,85 @@ QCoro::Task<void> FillerSelectable::_fillSameLangCountry(
     co_return;
 }
 
+QCoro::Task<void> FillerSelectable::_askSelection(
+        TemplateFiller *templateFiller
+        , QString settingsFileName
+        , QString valueId
+        , QString marketplaceTo
+        , QString countryCodeTo
+        , QString countryCodeFrom
+        , QString fieldIdTo
+        , QMap<QString, QString> valuesForAi
+        , QSet<QString> possibleValues)
+{
+    // Replies are drawn until SelectConsensus finds a value with enough lead
+    auto selectConsensus = templateFiller->selectConsensus();
+    int nPossibleValues = possibleValues.size();
+    int nSamples = 0;
+    int nSamplesToAsk = selectConsensus->samplesFirst(fieldIdTo, nPossibleValues);
+    QStringList votes;
+    QHash<QString, QString> value_reply;
+    QString selectedValue;
+    while (selectedValue.isEmpty() && nSamplesToAsk > 0)
+    {
+        // Phase 1 asks the first samples together, phase 2 one more until decided
+        const QString &phase = nSamples == 0 ? "phase1" : "phase2";
+        QList<QSharedPointer<OpenAi2::StepMultipleAsk>> steps;
+        QStringList replies;
+        for (int i=0; i<nSamplesToAsk; ++i)
+        {
+            ++nSamples;
+            auto step = ::createSelectStep(
+                        valueId + "_s" + QString::number(nSamples)
+                        , marketplaceTo, fieldIdTo, valuesForAi, possibleValues);
+            step->neededReplies = 1;
+            step->apply = [&replies](const QString &reply) {
+                replies << reply;
+            };
+            step->onLastError = [templateFiller, marketplaceTo, countryCodeTo, countryCodeFrom, fieldIdTo](const QString &reply, QNetworkReply::NetworkError networkError, const QString &lastWhy) -> bool
+            {
+                QString errorMsg = QString("NetworkError: %1 | Reply: %2 | Error: %3")
+                        .arg(QString::number(networkError), reply, lastWhy);
+                templateFiller->aiFailureTable()->recordError(marketplaceTo, countryCodeTo, countryCodeFrom, fieldIdTo, errorMsg);
+                return true;
+            };
+            steps.append(step);
+        }
+        Tracer::instance()->traceSteps(steps);
+        AiTelemetry::instance()->instrument(steps, "FillerSelectable.consensus." + phase, fieldIdTo);
+        co_await AiScheduler::instance()->ask(steps, "gpt-5.2", AiScheduler::Normal);
+
+        for (const auto &reply : replies)
+        {
+            const QString &val = parseValue(reply);
+            if (possibleValues.contains(val))
+            {
+                votes << val;
+                value_reply[val] = reply;
+            }
+        }
+        selectedValue = selectConsensus->decide(fieldIdTo, nPossibleValues, votes, nSamples);
+        nSamplesToAsk = qMin(1, SelectConsensus::SAMPLES_MAX - nSamples);
+    }
+    if (selectedValue.isEmpty())
+    {
+        co_return;
+    }
+    selectConsensus->record(fieldIdTo, votes);
+    // Save valid JSON reply to cache
+    templateFiller->saveAiValue(settingsFileName, valueId, value_reply[selectedValue], SELECT_GPT_MODEL);
+}
+
 QCoro::Task<void> FillerSelectable::_fillDifferentLangCountry(
         TemplateFiller *templateFiller
-        , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-        , const QString &marketplaceFrom
+        , const FillContext &context
         , const QString &marketplaceTo
         , const QString &fieldIdFrom
         , const QString &fieldIdTo
         , const Attribute *attribute
-        , const QString &productTypeFrom
         , const QString &productTypeTo
-        , const QString &countryCodeFrom
-        , const QString &langCodeFrom
         , const QString &countryCodeTo
         , const QString &langCodeTo
-        , const QHash<QString, QHash<QString, QString>> &countryCode_langCode_keywords
-        , const QHash<QString, QHash<QString, QHash<QString, QString>>> &skuPattern_countryCode_langCode_keywords
-        , Gender gender
-        , Age age
-        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
-        , const QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
         , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesFrom
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommon
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues) const
@@ -587,8 +807,8 @@ QCoro::Task<void> FillerSelectable::_fillDifferentLangCountry(
     QList<QSharedPointer<QCoro::Task<void>>> tasks;
     QSet<QString> processedValues;
 
-    for (auto it = sku_fieldId_fromValues.cbegin();
-         it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin();
+         it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
         const auto &fieldId_toValuesFrom = sku_fieldId_toValuesFrom[sku];
@@ -607,7 +827,7 @@ QCoro::Task<void> FillerSelectable::_fillDifferentLangCountry(
                 if (equivalentTable->hasEquivalent(fieldIdToV02, fromValue)) // One value is missing
                 {
                     auto task =  equivalentTable->askAiEquivalentValues(
-                                fieldIdToV02, fromValue, langCodeFrom, langCodeTo, possibleValues);
+                                fieldIdToV02, fromValue, context.langCodeFrom, langCodeTo, possibleValues);
                     tasks << QSharedPointer<QCoro::Task<void>>::create(std::move(task));
                 }
                 else
@@ -624,8 +844,8 @@ QCoro::Task<void> FillerSelectable::_fillDifferentLangCountry(
         co_await *task;
     }
 
-    for (auto it = sku_fieldId_fromValues.cbegin();
-         it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin();
+         it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
         const auto &fieldId_toValuesFrom = sku_fieldId_toValuesFrom[sku];
@@ -1,50 +1,70 @@
 #ifndef FILLERSELECTABLE_H
 #define FILLERSELECTABLE_H
 
+#include <QSet>
+
 #include "../../common/openai/OpenAi2.h"
 
 #include "AbstractFiller.h"
 
+class SelectConsensus;
+
 class FillerSelectable : public AbstractFiller
 {
 public:
+    QString name() const override;
     bool canFill(const TemplateFiller *templateFiller
                  , const Attribute *attribute
                  , const QString &marketplaceFrom
                  , const QString &fieldIdFrom) const override;
     QCoro::Task<void> fill(
             TemplateFiller *templateFiller
-            , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-            , const QString &marketplaceFrom
+            , const FillContext &context
             , const QString &marketplaceTo
             , const QString &fieldIdFrom
             , const QString &fieldIdTo
             , const Attribute *attribute
-            , const QString &productTypeFrom
             , const QString &productTypeTo
-            , const QString &countryCodeFrom
-            , const QString &langCodeFrom
             , const QString &countryCodeTo
             , const QString &langCodeTo
-            , const QHash<QString, QHash<QString, QString>> &countryCode_langCode_keywords
-            , const QHash<QString, QHash<QString, QHash<QString, QString>>> &skuPattern_countryCode_langCode_keywords
-            , Gender gender
-            , Age age
-            , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
-            , const QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
             , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesFrom
             , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommon
             , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues
             ) const override;
-    static void fillVariationsParents(
-            const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-            , QHash<QString, QString> &sku_parentSku
-            , QHash<QString, QString> &sku_variation
-            );
+    QCoro::Task<void> prefetch(
+            TemplateFiller *templateFiller
+            , const FillContext &context
+            , const QString &marketplaceTo
+            , const QHash<QString, const Attribute *> &fieldIdFrom_attribute
+            , const QString &productTypeTo
+            , const QString &countryCodeTo
+            , const QString &langCodeTo
+            , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues) const override;
     using EditCallback = std::function<QCoro::Task<bool>(TemplateFiller*, const QString &error, const QString &message)>;
     static void recordEditCallback(EditCallback callback);
 private:
     static EditCallback EDIT_MISSING_CALLBACK;
+    static const int BATCH_QUESTIONS_MAX;
+    static const int BATCH_POSSIBLE_VALUES_MAX;
+    struct SelectQuestion
+    {
+        QString valueId;
+        QString fieldIdTo;
+        QSet<QString> possibleValues;
+    };
+    static QSharedPointer<OpenAi2::StepMultipleAsk> _createSelectBatchStep(
+            const QString &marketplace
+            , const QString &sku
+            , const QMap<QString, QString> &valuesForAi
+            , const QList<SelectQuestion> &questions
+            , int sample);
+    static QHash<QString, QString> _batchValueId_reply(
+            const QString &reply, const QList<SelectQuestion> &questions); // Valid answers in createSelectStep format
+    static QHash<QString, QString> _decideBatch(
+            SelectConsensus *selectConsensus
+            , const QList<SelectQuestion> &questions
+            , const QStringList &replies
+            , int nSamples); // Answers the votes decided, recorded in selectConsensus
     QString _getValueId(
             const QString &marketplaceTo
             , const QString &countryCodeTo
@@ -58,48 +78,39 @@ private:
 
     QCoro::Task<void> _fillSameLangCountry(
             TemplateFiller *templateFiller
-            , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-            , const QString &marketplaceFrom
+            , const FillContext &context
             , const QString &marketplaceTo
             , const QString &fieldIdFrom
             , const QString &fieldIdTo
             , const Attribute *attribute
-            , const QString &productTypeFrom
             , const QString &productTypeTo
-            , const QString &countryCodeFrom
-            , const QString &langCodeFrom
             , const QString &countryCodeTo
             , const QString &langCodeTo
-            , const QHash<QString, QHash<QString, QString>> &countryCode_langCode_keywords
-            , const QHash<QString, QHash<QString, QHash<QString, QString>>> &skuPattern_countryCode_langCode_keywords
-            , Gender gender
-            , Age age
-            , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
-            , const QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
             , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesFrom
             , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommon
             , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues
             ) const;
+    // Parameters by value so they live in the coroutine frame until the reply
+    static QCoro::Task<void> _askSelection(
+            TemplateFiller *templateFiller
+            , QString settingsFileName
+            , QString valueId
+            , QString marketplaceTo
+            , QString countryCodeTo
+            , QString countryCodeFrom
+            , QString fieldIdTo
+            , QMap<QString, QString> valuesForAi
+            , QSet<QString> possibleValues);
     QCoro::Task<void> _fillDifferentLangCountry(
             TemplateFiller *templateFiller
-            , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-            , const QString &marketplaceFrom
+            , const FillContext &context
             , const QString &marketplaceTo
             , const QString &fieldIdFrom
             , const QString &fieldIdTo
             , const Attribute *attribute
-            , const QString &productTypeFrom
             , const QString &productTypeTo
-            , const QString &countryCodeFrom
-            , const QString &langCodeFrom
             , const QString &countryCodeTo
             , const QString &langCodeTo
-            , const QHash<QString, QHash<QString, QString>> &countryCode_langCode_keywords
-            , const QHash<QString, QHash<QString, QHash<QString, QString>>> &skuPattern_countryCode_langCode_keywords
-            , Gender gender
-            , Age age
-            , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
-            , const QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
             , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesFrom
             , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommon
             , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues
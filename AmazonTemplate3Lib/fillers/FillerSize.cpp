@@ -6,6 +6,9 @@
 
 #include "FillerSize.h"
 #include "ExceptionTemplate.h"
+#include "AiScheduler.h"
+#include "AiTelemetry.h"
+#include "Tracer.h"
 #include <QSet>
 #include <QRegularExpression>
 
@@ -165,6 +168,11 @@ const QList<QHash<QString, double>> FillerSize::SHOE_MALE_ADULT_SIZES = []() {
     return _list_countryCode_size;
 }();
 
+QString FillerSize::name() const
+{
+    return "FillerSize";
+}
+
 bool FillerSize::canFill(const TemplateFiller *templateFiller, const Attribute *attribute, const QString &marketplaceFrom, const QString &fieldIdFrom) const
 {
     if (templateFiller->attributeFlagsTable()
@@ -177,24 +185,14 @@ bool FillerSize::canFill(const TemplateFiller *templateFiller, const Attribute *
 
 QCoro::Task<void> FillerSize::fill(
         TemplateFiller *templateFiller
-        , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-        , const QString &marketplaceFrom
+        , const FillContext &context
         , const QString &marketplaceTo
         , const QString &fieldIdFrom
         , const QString &fieldIdTo
         , const Attribute *attribute
-        , const QString &productTypeFrom
         , const QString &productTypeTo
-        , const QString &countryCodeFrom
-        , const QString &langCodeFrom
         , const QString &countryCodeTo
         , const QString &langCodeTo
-        , const QHash<QString, QHash<QString, QString>> &countryCode_langCode_keywords
-        , const QHash<QString, QHash<QString, QHash<QString, QString>>> &skuPattern_countryCode_langCode_keywords
-        , Gender gender
-        , Age age
-        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
-        , const QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
         , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesFrom
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommon
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues) const
@@ -203,7 +201,7 @@ QCoro::Task<void> FillerSize::fill(
     bool foundValue = false;
     
     // We check if at least one SKU has a value for the given fieldIdFrom
-    for (auto it = sku_fieldId_fromValues.cbegin(); it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin(); it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         if (it.value().contains(fieldIdFrom) && !it.value()[fieldIdFrom].isEmpty())
         {
@@ -216,15 +214,15 @@ QCoro::Task<void> FillerSize::fill(
     {
         auto attributeFlagsTable = templateFiller->attributeFlagsTable();
         bool doneOnce = false;
-        for (auto itSku = sku_fieldId_fromValues.cbegin();
-             itSku != sku_fieldId_fromValues.cend() && !doneOnce; ++itSku)
+        for (auto itSku = context.sku_fieldId_fromValues.cbegin();
+             itSku != context.sku_fieldId_fromValues.cend() && !doneOnce; ++itSku)
         {
             const auto &fieldId_fromValues = itSku.value();
             for (auto it = fieldId_fromValues.cbegin();
                  it != fieldId_fromValues.cend(); ++it)
             {
                 const auto &curFieldId = it.key();
-                if (attributeFlagsTable->hasFlag(marketplaceFrom, curFieldId, Attribute::Size)
+                if (attributeFlagsTable->hasFlag(context.marketplaceFrom, curFieldId, Attribute::Size)
                         && !it.value().isEmpty())
                 {
                     validFieldIdFrom = curFieldId;
@@ -238,17 +236,17 @@ QCoro::Task<void> FillerSize::fill(
     bool isShoes = false;
     bool isClothe = false;
     bool isNoSizeConv = false;
-    initCatBools(settings.data(), productTypeFrom, isShoes, isClothe, isNoSizeConv);
+    initCatBools(settings.data(), context.productTypeFrom, isShoes, isClothe, isNoSizeConv);
     if (!isShoes && !isClothe && !isNoSizeConv)
     {
         // We ask AI to classify and update settings
         co_await askAiToUpdateSettingsForProductType(
-                    productTypeFrom, settings.data());
-        initCatBools(settings.data(), productTypeFrom, isShoes, isClothe, isNoSizeConv);
+                    context.productTypeFrom, settings.data());
+        initCatBools(settings.data(), context.productTypeFrom, isShoes, isClothe, isNoSizeConv);
     }
 
 
-    for (auto it = sku_fieldId_fromValues.cbegin(); it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin(); it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
         if (it.value().contains(validFieldIdFrom))
@@ -263,12 +261,12 @@ QCoro::Task<void> FillerSize::fill(
             if (isShoes)
             {
                     convertedValue = convertShoeSize(
-                                countryCodeFrom, countryCodeTo, gender, age, productTypeFrom, origValueString);
+                                context.countryCodeFrom, countryCodeTo, context.gender, context.age, context.productTypeFrom, origValueString);
             }
             else if (isClothe)
             {
                     convertedValue = convertClothingSize(
-                                countryCodeFrom, countryCodeTo, langCodeTo, gender, age, productTypeFrom, origValueString);
+                                context.countryCodeFrom, countryCodeTo, langCodeTo, context.gender, context.age, context.productTypeFrom, origValueString);
             }
             else
             {
@@ -428,7 +426,9 @@ QCoro::Task<void> FillerSize::askAiToUpdateSettingsForProductType(
 
     qDebug() << "--\nFillerSize::askAiToUpdateSettingsForProductType:" << stepClassification->getPrompt(0);
     // Execute step
-    co_await OpenAi2::instance()->askGptMultipleTimeAiCoro(steps, "gpt-5.2");
+    Tracer::instance()->traceSteps(steps);
+    AiTelemetry::instance()->instrument(steps, "FillerSize", "classification");
+    co_await AiScheduler::instance()->ask(steps, "gpt-5.2", AiScheduler::Normal);
     co_return;
 }
 
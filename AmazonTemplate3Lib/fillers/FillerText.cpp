@@ -17,6 +17,14 @@
 #include "FillerBulletPoints.h"
 #include "FillerTitle.h"
 #include "FillerKeywords.h"
+#include "AiScheduler.h"
+#include "AiTelemetry.h"
+#include "Tracer.h"
+
+QString FillerText::name() const
+{
+    return "FillerText";
+}
 
 bool FillerText::canFill(
         const TemplateFiller *templateFiller
@@ -24,21 +32,26 @@ bool FillerText::canFill(
         , const QString &marketplaceFrom
         , const QString &fieldIdFrom) const
 {
-    QList<const AbstractFiller *> otherFillers;
-    const FillerCopy fillerCopy;
-    otherFillers << &fillerCopy;
-    const FillerPrice fillerPrice;
-    otherFillers << &fillerPrice;
-    const FillerSize fillerSize;
-    otherFillers << &fillerSize;
-    const FillerBulletPoints fillerBulletPoints;
-    otherFillers << &fillerBulletPoints;
-    const FillerSelectable fillerSelectable;
-    otherFillers << &fillerSelectable;
-    const FillerTitle fillerTitle;
-    otherFillers << &fillerTitle;
-    const FillerKeywords fillerKeywords;
-    otherFillers << &fillerKeywords;
+    static const QList<const AbstractFiller *> otherFillers
+            = []() -> QList<const AbstractFiller *>
+    {
+        QList<const AbstractFiller *> otherFillers;
+        static const FillerCopy fillerCopy;
+        otherFillers << &fillerCopy;
+        static const FillerPrice fillerPrice;
+        otherFillers << &fillerPrice;
+        static const FillerSize fillerSize;
+        otherFillers << &fillerSize;
+        static const FillerBulletPoints fillerBulletPoints;
+        otherFillers << &fillerBulletPoints;
+        static const FillerSelectable fillerSelectable;
+        otherFillers << &fillerSelectable;
+        static const FillerTitle fillerTitle;
+        otherFillers << &fillerTitle;
+        static const FillerKeywords fillerKeywords;
+        otherFillers << &fillerKeywords;
+        return otherFillers;
+    }();
     for (const auto &filler : otherFillers)
     {
         if (filler->canFill(templateFiller,
@@ -193,32 +206,22 @@ void FillerText::_saveGptReplies(
 
 QCoro::Task<void> FillerText::fill(
         TemplateFiller *templateFiller
-        , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-        , const QString &marketplaceFrom
+        , const FillContext &context
         , const QString &marketplaceTo
         , const QString &fieldIdFrom
         , const QString &fieldIdTo
         , const Attribute *attribute
-        , const QString &productTypeFrom
         , const QString &productTypeTo
-        , const QString &countryCodeFrom
-        , const QString &langCodeFrom
         , const QString &countryCodeTo
         , const QString &langCodeTo
-        , const QHash<QString, QHash<QString, QString>> &countryCode_langCode_keywords
-        , const QHash<QString, QHash<QString, QHash<QString, QString>>> &skuPattern_countryCode_langCode_keywords
-        , Gender gender
-        , Age age
-        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
-        , const QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
         , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesFrom
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommon
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues) const
 {
-    if (langCodeFrom == langCodeTo)
+    if (context.langCodeFrom == langCodeTo)
     {
-        for (auto it = sku_fieldId_fromValues.cbegin();
-             it != sku_fieldId_fromValues.cend(); ++it)
+        for (auto it = context.sku_fieldId_fromValues.cbegin();
+             it != context.sku_fieldId_fromValues.cend(); ++it)
         {
             const auto &sku = it.key();
             const auto &fieldId_fromValues = it.value();
@@ -234,12 +237,9 @@ QCoro::Task<void> FillerText::fill(
 
     const QString settingsFileName{"filledTexts.ini"};
     auto attributeFlagsTable = templateFiller->attributeFlagsTable();
-    bool childSameValue = attributeFlagsTable->hasFlag(marketplaceFrom, fieldIdFrom, Attribute::ChildSameValue);
-    bool allSameValue = attributeFlagsTable->hasFlag(marketplaceFrom, fieldIdFrom, Attribute::SameValue);
-    bool childOnly = attributeFlagsTable->hasFlag(marketplaceFrom, fieldIdFrom, Attribute::ChildOnly);
-    QHash<QString, QString> sku_parentSku;
-    QHash<QString, QString> sku_variation;
-    FillerSelectable::fillVariationsParents(parentSku_variation_skus, sku_parentSku, sku_variation);
+    bool childSameValue = attributeFlagsTable->hasFlag(context.marketplaceFrom, fieldIdFrom, Attribute::ChildSameValue);
+    bool allSameValue = attributeFlagsTable->hasFlag(context.marketplaceFrom, fieldIdFrom, Attribute::SameValue);
+    bool childOnly = attributeFlagsTable->hasFlag(context.marketplaceFrom, fieldIdFrom, Attribute::ChildOnly);
 
     QList<QSharedPointer<QCoro::Task<void>>> tasks;
     
@@ -261,22 +261,22 @@ QCoro::Task<void> FillerText::fill(
         {
             if (allSameValue)
             {
-                return *parentSku_variation_skus[sku].begin().value().begin(); // We take the first child sku
+                return *context.parentSku_variation_skus[sku].begin().value().begin(); // We take the first child sku
             }
         }
         else
         {
-            return sku_variation[sku];
+            return context.sku_variation[sku];
         }
         return QString();
     };
 
-    for (auto it = sku_fieldId_fromValues.cbegin();
-         it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin();
+         it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
 
-        bool isParent = parentSku_variation_skus.contains(sku);
+        bool isParent = context.parentSku_variation_skus.contains(sku);
         if (!isParent || !childOnly)
         {
             if (sku_fieldId_toValueslangCommon.contains(sku)
@@ -296,7 +296,7 @@ QCoro::Task<void> FillerText::fill(
                             , langCodeTo
                             , allSameValue
                             , childSameValue
-                            , isParent ? sku : sku_parentSku[sku]
+                            , isParent ? sku : context.sku_parentSku[sku]
                                          , variationForValueId
                             , fieldIdTo
                             );
@@ -317,14 +317,14 @@ QCoro::Task<void> FillerText::fill(
                 {
                     launchedValueIds.insert(valueId);
                     QString valueFrom;
-                    if (sku_fieldId_fromValues.contains(sku)
-                            && sku_fieldId_fromValues[sku].contains(fieldIdFrom)
-                            && !sku_fieldId_fromValues[sku][fieldIdFrom].isEmpty())
+                    if (context.sku_fieldId_fromValues.contains(sku)
+                            && context.sku_fieldId_fromValues[sku].contains(fieldIdFrom)
+                            && !context.sku_fieldId_fromValues[sku][fieldIdFrom].isEmpty())
                     {
-                        valueFrom = sku_fieldId_fromValues[sku][fieldIdFrom];
+                        valueFrom = context.sku_fieldId_fromValues[sku][fieldIdFrom];
                     }
 
-                    QMap<QString, QString> valuesForAi = sku_attribute_valuesForAi[sku];
+                    QMap<QString, QString> valuesForAi = context.sku_attribute_valuesForAi[sku];
 
                     auto task = [=, &fieldId_gptReplies]() -> QCoro::Task<void>
                     {
@@ -337,7 +337,7 @@ QCoro::Task<void> FillerText::fill(
 
                         if (!valueFrom.isEmpty())
                         {
-                            QString prompt = "Translate the following text from " + langCodeFrom + " to "
+                            QString prompt = "Translate the following text from " + context.langCodeFrom + " to "
                                     + langCodeTo + ".\n"
                                     "Product Type: "
                                     + productTypeTo + "\n"
@@ -368,7 +368,7 @@ QCoro::Task<void> FillerText::fill(
                                     apply(reply, valFormatted);
                                 }
                             };
-                            step->onLastError = [templateFiller, marketplaceTo, countryCodeTo, countryCodeFrom, fieldIdTo](
+                            step->onLastError = [templateFiller, marketplaceTo, countryCodeTo, countryCodeFrom = context.countryCodeFrom, fieldIdTo](
                                     const QString &reply, QNetworkReply::NetworkError networkError, const QString &lastWhy) -> bool
                             {
                                 QString errorMsg = QString("NetworkError: %1 | Reply: %2 | Error: %3")
@@ -471,7 +471,7 @@ QCoro::Task<void> FillerText::fill(
                                     apply(reply, valFormatted);
                                 }
                             };
-                            step->onLastError = [templateFiller, marketplaceTo, countryCodeTo, countryCodeFrom, fieldIdTo](const QString &reply, QNetworkReply::NetworkError networkError, const QString &lastWhy) -> bool
+                            step->onLastError = [templateFiller, marketplaceTo, countryCodeTo, countryCodeFrom = context.countryCodeFrom, fieldIdTo](const QString &reply, QNetworkReply::NetworkError networkError, const QString &lastWhy) -> bool
                             {
                                 QString errorMsg = QString("NetworkError: %1 | Reply: %2 | Error: %3")
                                         .arg(QString::number(networkError), reply, lastWhy);
@@ -480,7 +480,9 @@ QCoro::Task<void> FillerText::fill(
                             };
                             steps << step;
                         }
-                        co_await OpenAi2::instance()->askGptMultipleTimeCoro(steps, "gpt-5.2"); // std::move(steps) not needed as it is passed by const reference
+                        Tracer::instance()->traceSteps(steps);
+                        AiTelemetry::instance()->instrument(steps, "FillerText", fieldIdTo);
+                        co_await AiScheduler::instance()->ask(steps, "gpt-5.2", AiScheduler::Low);
                         // co_return is not needed for void coroutine that falls off end
                     };
                     tasks << QSharedPointer<QCoro::Task<void>>::create(task());
@@ -495,12 +497,12 @@ QCoro::Task<void> FillerText::fill(
         co_await *task;
     }
     _saveGptReplies(templateFiller, settingsFileName, fieldId_gptReplies);
-    for (auto it = sku_fieldId_fromValues.cbegin();
-         it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin();
+         it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
 
-        bool isParent = parentSku_variation_skus.contains(sku);
+        bool isParent = context.parentSku_variation_skus.contains(sku);
         if (!isParent || !childOnly)
         {
             if (!sku_fieldId_toValues.contains(sku)
@@ -514,7 +516,7 @@ QCoro::Task<void> FillerText::fill(
                             , langCodeTo
                             , allSameValue
                             , childSameValue
-                            , isParent ? sku : sku_parentSku[sku]
+                            , isParent ? sku : context.sku_parentSku[sku]
                                          , variationForValueId
                             , fieldIdTo
                             );
@@ -3,18 +3,37 @@
 #include "TemplateFiller.h"
 #include "AttributeFlagsTable.h"
 #include "FillerSize.h"
+#include "FillContext.h"
 
 #include "FillerTitle.h"
 #include "AiFailureTable.h"
+#include "AiScheduler.h"
+#include "AiTelemetry.h"
+#include "Tracer.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
 
+QString FillerTitle::name() const
+{
+    return "FillerTitle";
+}
+
 bool FillerTitle::canFill(const TemplateFiller *templateFiller, const Attribute *attribute, const QString &marketplaceFrom, const QString &fieldIdFrom) const
 {
     return fieldIdFrom.startsWith("item_name");
 }
 
+void FillerTitle::prepare(
+        const TemplateFiller *, const QStringList &fieldIdsFrom, FillContext &context) const
+{
+    for (const auto &fieldIdFrom : fieldIdsFrom)
+    {
+        context.fieldIdFrom_titleFrom_skus[fieldIdFrom] = _get_titleFrom_skus(
+                    context.sku_fieldId_fromValues, fieldIdFrom);
+    }
+}
+
 // Static helper to avoid ICE in coroutine
 static QSharedPointer<OpenAi2::StepMultipleAskAi> createTranslationStep(
         const QString &title,
@@ -88,40 +107,29 @@ static QSharedPointer<OpenAi2::StepMultipleAskAi> createTranslationStep(
 
 QCoro::Task<void> FillerTitle::fill(
         TemplateFiller *templateFiller
-        , const QHash<QString, QHash<QString, QSet<QString>>> &parentSku_variation_skus
-        , const QString &marketplaceFrom
+        , const FillContext &context
         , const QString &marketplaceTo
         , const QString &fieldIdFrom
         , const QString &fieldIdTo
         , const Attribute *attribute
-        , const QString &productTypeFrom
         , const QString &productTypeTo
-        , const QString &countryCodeFrom
-        , const QString &langCodeFrom
         , const QString &countryCodeTo
         , const QString &langCodeTo
-        , const QHash<QString, QHash<QString, QString>> &countryCode_langCode_keywords
-        , const QHash<QString, QHash<QString, QHash<QString, QString>>> &skuPattern_countryCode_langCode_keywords
-        , Gender gender
-        , Age age
-        , const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
-        , const QHash<QString, QMap<QString, QString>> &sku_attribute_valuesForAi
         , const QHash<QString, QHash<QString, QString>> &sku_fieldId_toValuesFrom
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValueslangCommon
         , QHash<QString, QHash<QString, QString>> &sku_fieldId_toValues) const
 {
-    const auto &titleFrom_skus = _get_titleFrom_skus(
-                sku_fieldId_fromValues, fieldIdFrom);
+    const auto &titleFrom_skus = context.fieldIdFrom_titleFrom_skus[fieldIdFrom];
 
-    for (auto it = sku_fieldId_fromValues.cbegin();
-         it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin();
+         it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
         if (it.value().contains(fieldIdFrom))
         {
-            if (countryCodeFrom == countryCodeTo && langCodeFrom == langCodeTo)
+            if (context.countryCodeFrom == countryCodeTo && context.langCodeFrom == langCodeTo)
             {
-                sku_fieldId_toValues[sku][fieldIdTo] = sku_fieldId_fromValues[sku][fieldIdFrom];
+                sku_fieldId_toValues[sku][fieldIdTo] = context.sku_fieldId_fromValues[sku][fieldIdFrom];
             }
             QString titleFromFull = it.value()[fieldIdFrom].trimmed();
             _fixTitleFormat(titleFromFull);
@@ -137,7 +145,7 @@ QCoro::Task<void> FillerTitle::fill(
                                 , sku_fieldId_toValueslangCommon[sku]
                                 , sku_fieldId_toValueslangCommon[sku][fieldIdFrom]);
                 }
-                else if (langCodeFrom == langCodeTo)
+                else if (context.langCodeFrom == langCodeTo)
                 {
                     recordAllMarketplace(
                                 templateFiller
@@ -151,7 +159,7 @@ QCoro::Task<void> FillerTitle::fill(
             {
                 const QString settingsFileName = "aiTitleTranslations.ini";
                 auto stepTranslation = createTranslationStep(titleFrom, langCodeTo);
-                stepTranslation->onLastError = [templateFiller, marketplaceTo, countryCodeTo, countryCodeFrom, fieldIdTo](const QString &reply, QNetworkReply::NetworkError networkError, const QString &lastWhy) -> bool
+                stepTranslation->onLastError = [templateFiller, marketplaceTo, countryCodeTo, countryCodeFrom = context.countryCodeFrom, fieldIdTo](const QString &reply, QNetworkReply::NetworkError networkError, const QString &lastWhy) -> bool
                 {
                     QString errorMsg = QString("NetworkError: %1 | Reply: %2 | Error: %3")
                             .arg(QString::number(networkError), reply, lastWhy);
@@ -185,14 +193,16 @@ QCoro::Task<void> FillerTitle::fill(
                     stepTranslation->apply = [&](const QString &reply) {
                         if (parseAndSetTitle(reply))
                         {
-                            templateFiller->saveAiValue(settingsFileName, stepTranslation->id, reply);
+                            templateFiller->saveAiValue(settingsFileName, stepTranslation->id, reply, stepTranslation->gptModel);
                         }
                     };
                     
                     QList<QSharedPointer<OpenAi2::StepMultipleAskAi>> steps;
                     steps.append(stepTranslation);
                     qDebug() << "--\nFillerTitle::fill translating - " + titleFrom + ":" << stepTranslation->getPrompt(0);
-                    co_await OpenAi2::instance()->askGptMultipleTimeAiCoro(steps, "gpt-5.2");
+                    Tracer::instance()->traceSteps(steps);
+                    AiTelemetry::instance()->instrument(steps, "FillerTitle", fieldIdTo);
+                    co_await AiScheduler::instance()->ask(steps, "gpt-5.2", AiScheduler::Normal);
                 }
                 
                 // If succeeded (cache or AI), update SKUs
@@ -215,8 +225,8 @@ QCoro::Task<void> FillerTitle::fill(
     
     auto attributeFlagTable = templateFiller->attributeFlagsTable();
     const auto &sizeFieldIds = attributeFlagTable->getSizeFieldIds();
-    for (auto it = sku_fieldId_fromValues.cbegin();
-         it != sku_fieldId_fromValues.cend(); ++it)
+    for (auto it = context.sku_fieldId_fromValues.cbegin();
+         it != context.sku_fieldId_fromValues.cend(); ++it)
     {
         const auto &sku = it.key();
         if (sku_fieldId_toValueslangCommon.contains(sku)
@@ -271,7 +281,7 @@ QCoro::Task<void> FillerTitle::fill(
                     }
                     if (labelSize != size && !size.isEmpty())
                     {
-                        newTitle += labelSize + "=" + _get_sizeCountry(templateFiller, countryCodeTo, productTypeFrom, gender, age) + "-" + size;
+                        newTitle += labelSize + "=" + _get_sizeCountry(templateFiller, countryCodeTo, context.productTypeFrom, context.gender, context.age) + "-" + size;
                     }
                     else
                     {
@@ -450,7 +460,7 @@ QString FillerTitle::_get_sizeCountry(
 }
 
 QHash<QString, QSet<QString>> FillerTitle::_get_titleFrom_skus(
-        const QHash<QString, QHash<QString, QString>> &sku_fieldId_fromValues
+        const SkuFieldMatrix &sku_fieldId_fromValues
         , const QString &fieldIdFrom) const
 {
     QHash<QString, QSet<QString>> titleFrom_skus;
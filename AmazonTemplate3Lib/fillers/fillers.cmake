@@ -17,4 +17,8 @@ SET(FILLER_FILES
     ${CMAKE_CURRENT_LIST_DIR}/FillerKeywords.h
     ${CMAKE_CURRENT_LIST_DIR}/FillerText.cpp
     ${CMAKE_CURRENT_LIST_DIR}/FillerText.h
+    ${CMAKE_CURRENT_LIST_DIR}/FillerDispatch.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/FillerDispatch.h
+    ${CMAKE_CURRENT_LIST_DIR}/FillContext.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/FillContext.h
 )
@@ -0,0 +1,414 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QSet>
+#include "xlsxdocument.h"
+#include "Attribute.h"
+#include "AttributeEquivalentTable.h"
+#include "AttributeFlagsTable.h"
+#include "AttributePossibleMissingTable.h"
+#include "AttributeValueReplacedTable.h"
+#include "TemplateFiller.h"
+#include "TemplateSnapshot.h"
+
+// Times the slow steps of TemplateFiller on generated templates. The scale
+// is read from the environment:
+// AMZ_BENCH_SKUS, AMZ_BENCH_COLUMNS, AMZ_BENCH_VALID_VALUES,
+// AMZ_BENCH_MARKETPLACES and AMZ_BENCH_VERSION (V01 or V02).
+// Run with -o results.csv,csv to get the results in CSV.
+class TemplateFillerBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void bench_loadTemplates();
+    void bench_skuFieldIdFromValues();
+    void bench_checkPossibleValues();
+    void bench_buildAttributes();
+    void bench_equivalentLookups();
+    void bench_valueReplacedLookups();
+    void bench_possibleMissingLookups();
+    void bench_saveTemplates();
+
+private:
+    struct Column
+    {
+        QString fieldId;
+        QString fieldName;
+        bool selectable = false;
+        bool mandatory = false;
+    };
+    static const QStringList LANG_COUNTRY_CODES;
+    QTemporaryDir m_tempDir;
+    int m_nSkus;
+    int m_nColumns;
+    int m_nValidValues;
+    int m_nMarketplaces;
+    bool m_isV02;
+    QList<Column> m_columns;
+    QString m_templateFromPath;
+    QStringList m_templateToPaths;
+    QSharedPointer<TemplateFiller> m_templateFiller;
+    static int _envInt(const char *name, int defaultValue);
+    void _buildColumns();
+    QString _validValue(const Column &column, int index, const QString &langCode) const;
+    QString _createTemplate(const QString &langCountryCode, int nSkus) const;
+    const Column &_columnColor() const;
+};
+
+const QStringList TemplateFillerBenchmark::LANG_COUNTRY_CODES{
+    "FR_FR", "DE_DE", "IT_IT", "ES_ES", "NL_NL", "SV_SE", "PL_PL", "FR_BE", "DE_AT", "EN_UK"};
+
+int TemplateFillerBenchmark::_envInt(const char *name, int defaultValue)
+{
+    bool ok = false;
+    int value = qEnvironmentVariableIntValue(name, &ok);
+    return ok ? value : defaultValue;
+}
+
+void TemplateFillerBenchmark::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+    m_nSkus = _envInt("AMZ_BENCH_SKUS", 1000);
+    m_nColumns = qMax(10, _envInt("AMZ_BENCH_COLUMNS", 120));
+    m_nValidValues = qMax(2, _envInt("AMZ_BENCH_VALID_VALUES", 40));
+    m_nMarketplaces = qBound(1, _envInt("AMZ_BENCH_MARKETPLACES", 4), int(LANG_COUNTRY_CODES.size()));
+    m_isV02 = qEnvironmentVariable("AMZ_BENCH_VERSION", "V02") != "V01";
+    qInfo() << "Templates" << (m_isV02 ? "V02" : "V01") << "skus" << m_nSkus
+            << "columns" << m_nColumns << "valid values" << m_nValidValues
+            << "marketplaces" << m_nMarketplaces;
+    _buildColumns();
+
+    m_templateFromPath = _createTemplate(LANG_COUNTRY_CODES[0], m_nSkus);
+    m_templateToPaths << m_templateFromPath;
+    for (int i=1; i<m_nMarketplaces; ++i)
+    {
+        m_templateToPaths << _createTemplate(LANG_COUNTRY_CODES[i], 0);
+    }
+
+    const QString &marketplace = m_isV02 ? Attribute::AMAZON_V02 : Attribute::AMAZON_V01;
+    {
+        AttributeFlagsTable flagsTable{m_tempDir.path()};
+        for (const auto &column : std::as_const(m_columns))
+        {
+            if (column.mandatory)
+            {
+                flagsTable.recordAttribute(QHash<QString, QString>{{marketplace, column.fieldId}});
+            }
+        }
+    }
+    m_templateFiller = QSharedPointer<TemplateFiller>::create(
+                m_tempDir.path()
+                , m_templateFromPath
+                , m_templateToPaths
+                , QStringList{}
+                , QMap<QString, QString>{});
+
+    const auto &columnColor = _columnColor();
+    auto equivalentTable = m_templateFiller->attributeEquivalentTable();
+    auto replacedTable = m_templateFiller->attributeValueReplacedTable();
+    auto missingTable = m_templateFiller->attributePossibleMissingTable();
+    for (int i=0; i<m_nValidValues; ++i)
+    {
+        QSet<QString> equivalentValues;
+        for (int j=0; j<m_nMarketplaces; ++j)
+        {
+            const auto &langCode = LANG_COUNTRY_CODES[j].split("_").first();
+            equivalentValues << _validValue(columnColor, i, langCode);
+        }
+        equivalentTable->recordAttribute(columnColor.fieldId, equivalentValues);
+        if (i % 4 == 0)
+        {
+            replacedTable->recordAttribute(
+                        marketplace, "FR", "FR", "DRESS", columnColor.fieldId
+                        , _validValue(columnColor, i, "FR"), _validValue(columnColor, i, "FR") + " replaced");
+        }
+    }
+    for (const auto &column : std::as_const(m_columns))
+    {
+        if (!column.selectable && column.fieldId.startsWith("attribute_2"))
+        {
+            missingTable->recordAttribute(
+                        marketplace, "DE", "DE", "DRESS", column.fieldId, {"A", "B"});
+        }
+    }
+}
+
+void TemplateFillerBenchmark::cleanupTestCase()
+{
+    m_templateFiller.reset();
+    TemplateSnapshotCache::instance()->clear();
+}
+
+void TemplateFillerBenchmark::_buildColumns()
+{
+    m_columns.clear();
+    const QStringList fieldIdsBase = m_isV02
+            ? QStringList{"contribution_sku#1.value", "child_parent_sku_relationship#1.parent_sku"
+                          , "color#1.value", "product_type#1.value"
+                          , "target_gender#1.value", "age_range_description#1.value"}
+            : QStringList{"item_sku", "parent_sku", "color_name", "feed_product_type"
+                          , "target_gender", "age_range_description"};
+    const QStringList fieldNamesBase{
+        "SKU", "Parent SKU", "Colour", "Product Type", "Target Gender", "Age Range Description"};
+    for (int i=0; i<fieldIdsBase.size(); ++i)
+    {
+        Column column;
+        column.fieldId = fieldIdsBase[i];
+        column.fieldName = fieldNamesBase[i];
+        column.selectable = i >= 2;
+        column.mandatory = column.selectable;
+        m_columns << column;
+    }
+    for (int i=m_columns.size(); i<m_nColumns; ++i)
+    {
+        Column column;
+        column.fieldId = m_isV02 ? QString{"attribute_%1#1.value"}.arg(i) : QString{"attribute_%1"}.arg(i);
+        column.fieldName = QString{"Attribute %1"}.arg(i);
+        column.selectable = i % 3 == 0;
+        column.mandatory = column.selectable && i % 2 == 0;
+        m_columns << column;
+    }
+}
+
+const TemplateFillerBenchmark::Column &TemplateFillerBenchmark::_columnColor() const
+{
+    return m_columns[2];
+}
+
+QString TemplateFillerBenchmark::_validValue(
+        const Column &column, int index, const QString &langCode) const
+{
+    if (column.fieldName == "Product Type")
+    {
+        return "DRESS";
+    }
+    return column.fieldName + " " + QString::number(index) + " " + langCode;
+}
+
+QString TemplateFillerBenchmark::_createTemplate(
+        const QString &langCountryCode, int nSkus) const
+{
+    const auto &langCode = langCountryCode.split("_").first();
+    const QString &filePath = m_tempDir.filePath("bench-TOFILL-" + langCountryCode + ".xlsx");
+    QXlsx::Document doc;
+    doc.addSheet("Template");
+    doc.selectSheet("Template");
+    int rowFieldId = m_isV02 ? 5 : 3; // 1-based
+    doc.write(1, 1, m_isV02 ? QString{"settings=contentLanguageTag=" + langCountryCode}
+                            : QString{"TemplateType=fptcustom"});
+    for (int j=0; j<m_columns.size(); ++j)
+    {
+        doc.write(rowFieldId - 1, j + 1, m_columns[j].fieldName);
+        doc.write(rowFieldId, j + 1, m_columns[j].fieldId);
+    }
+    doc.write(rowFieldId + 1, 1, "ABC123"); // Example row
+    int row = rowFieldId + 2;
+    QString skuParent;
+    for (int i=0; i<nSkus; ++i)
+    {
+        bool isParent = i % 10 == 0;
+        QString sku;
+        if (isParent)
+        {
+            skuParent = "P" + QString::number(i);
+            sku = skuParent;
+        }
+        else
+        {
+            sku = skuParent + "-C" + QString::number(i);
+        }
+        doc.write(row, 1, sku);
+        if (!isParent)
+        {
+            doc.write(row, 2, skuParent);
+        }
+        for (int j=2; j<m_columns.size(); ++j)
+        {
+            const auto &column = m_columns[j];
+            if (column.selectable)
+            {
+                doc.write(row, j + 1, _validValue(column, (i / 10 + j) % m_nValidValues, langCode));
+            }
+            else
+            {
+                doc.write(row, j + 1, "Text " + QString::number(i) + " " + QString::number(j));
+            }
+        }
+        ++row;
+    }
+
+    doc.addSheet("Data Definitions");
+    doc.selectSheet("Data Definitions");
+    doc.write(2, 1, "Group");
+    doc.write(2, 2, "Field Name");
+    doc.write(2, 3, "Local Label Name");
+    doc.write(2, 4, "Required");
+    for (int j=0; j<m_columns.size(); ++j)
+    {
+        const auto &column = m_columns[j];
+        doc.write(j + 4, 2, column.fieldId);
+        doc.write(j + 4, 3, column.fieldName);
+        doc.write(j + 4, 4, column.mandatory ? "Required" : "Optional");
+    }
+
+    doc.addSheet("Valid Values");
+    doc.selectSheet("Valid Values");
+    int rowValid = 2;
+    for (const auto &column : std::as_const(m_columns))
+    {
+        if (column.selectable)
+        {
+            doc.write(rowValid, 2, column.fieldName);
+            int nValues = column.fieldName == "Product Type" ? 1 : m_nValidValues;
+            for (int k=0; k<nValues; ++k)
+            {
+                doc.write(rowValid, k + 3, _validValue(column, k, langCode));
+            }
+            ++rowValid;
+        }
+    }
+    doc.selectSheet("Template");
+    doc.saveAs(filePath);
+    return filePath;
+}
+
+void TemplateFillerBenchmark::bench_loadTemplates()
+{
+    QBENCHMARK
+    {
+        for (const auto &templatePath : std::as_const(m_templateToPaths))
+        {
+            auto snapshot = m_templateFiller->_readSnapshot(templatePath);
+            QVERIFY(!snapshot->fieldId_index.isEmpty());
+        }
+    }
+}
+
+void TemplateFillerBenchmark::bench_skuFieldIdFromValues()
+{
+    SkuFieldMatrix sku_fieldId_fromValues;
+    QBENCHMARK
+    {
+        sku_fieldId_fromValues = m_templateFiller->_get_sku_fieldId_fromValues(m_templateFromPath);
+    }
+    QCOMPARE(sku_fieldId_fromValues.size(), m_nSkus);
+}
+
+void TemplateFillerBenchmark::bench_checkPossibleValues()
+{
+    QBENCHMARK
+    {
+        const auto &possibleValues = m_templateFiller->checkPossibleValues();
+        QVERIFY(!possibleValues.isEmpty());
+    }
+}
+
+void TemplateFillerBenchmark::bench_buildAttributes()
+{
+    QBENCHMARK
+    {
+        m_templateFiller->buildAttributes();
+    }
+}
+
+void TemplateFillerBenchmark::bench_equivalentLookups()
+{
+    const auto &columnColor = _columnColor();
+    const QString &langCodeTo = LANG_COUNTRY_CODES[m_nMarketplaces - 1].split("_").first();
+    QSet<QString> possibleValuesTo;
+    for (int i=0; i<m_nValidValues; ++i)
+    {
+        possibleValuesTo << _validValue(columnColor, i, langCodeTo);
+    }
+    const auto &sku_fieldId_fromValues = m_templateFiller->_get_sku_fieldId_fromValues(m_templateFromPath);
+    auto equivalentTable = m_templateFiller->attributeEquivalentTable();
+    int nFound = 0;
+    QBENCHMARK
+    {
+        nFound = 0;
+        for (auto it = sku_fieldId_fromValues.cbegin(); it != sku_fieldId_fromValues.cend(); ++it)
+        {
+            const auto &value = it.value().value(columnColor.fieldId);
+            if (equivalentTable->hasEquivalent(columnColor.fieldId, value, possibleValuesTo)
+                    && !equivalentTable->getEquivalentValue(columnColor.fieldId, value, possibleValuesTo).isEmpty())
+            {
+                ++nFound;
+            }
+        }
+    }
+    QVERIFY(nFound > 0);
+}
+
+void TemplateFillerBenchmark::bench_valueReplacedLookups()
+{
+    const QString &marketplace = m_isV02 ? Attribute::AMAZON_V02 : Attribute::AMAZON_V01;
+    const auto &sku_fieldId_fromValues = m_templateFiller->_get_sku_fieldId_fromValues(m_templateFromPath);
+    auto replacedTable = m_templateFiller->attributeValueReplacedTable();
+    int nReplaced = 0;
+    QBENCHMARK
+    {
+        nReplaced = 0;
+        for (auto it = sku_fieldId_fromValues.cbegin(); it != sku_fieldId_fromValues.cend(); ++it)
+        {
+            for (auto itField = it.value().cbegin(); itField != it.value().cend(); ++itField)
+            {
+                QString value{itField.value()};
+                if (replacedTable->replaceIfContains(
+                            marketplace, "FR", "FR", "DRESS", itField.key(), value))
+                {
+                    ++nReplaced;
+                }
+            }
+        }
+    }
+    QVERIFY(nReplaced > 0);
+}
+
+void TemplateFillerBenchmark::bench_possibleMissingLookups()
+{
+    const QString &marketplace = m_isV02 ? Attribute::AMAZON_V02 : Attribute::AMAZON_V01;
+    auto missingTable = m_templateFiller->attributePossibleMissingTable();
+    int nFound = 0;
+    QBENCHMARK
+    {
+        nFound = 0;
+        for (int i=0; i<m_nSkus; ++i)
+        {
+            for (const auto &column : std::as_const(m_columns))
+            {
+                if (missingTable->contains(marketplace, "DE", "DE", "DRESS", column.fieldId))
+                {
+                    ++nFound;
+                }
+            }
+        }
+    }
+    Q_UNUSED(nFound)
+}
+
+void TemplateFillerBenchmark::bench_saveTemplates()
+{
+    const auto &sku_fieldId_fromValues
+            = m_templateFiller->_get_sku_fieldId_fromValues(m_templateFromPath).toHash();
+    for (const auto &templatePath : std::as_const(m_templateToPaths))
+    {
+        const auto &countryCode = m_templateFiller->_get_countryCode(templatePath);
+        const auto &langCode = m_templateFiller->_get_langCode(templatePath);
+        m_templateFiller->m_countryCode_langCode_sku_fieldId_toValues[countryCode][langCode]
+                = sku_fieldId_fromValues;
+    }
+    QBENCHMARK
+    {
+        m_templateFiller->_saveTemplates();
+    }
+    QString filledPath{m_templateToPaths.last()};
+    filledPath.replace("TOFILL", "FILLED");
+    QVERIFY(QFileInfo::exists(filledPath));
+}
+
+QTEST_MAIN(TemplateFillerBenchmark)
+#include "bench_templatefiller.moc"
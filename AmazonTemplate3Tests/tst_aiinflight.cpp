@@ -0,0 +1,70 @@
+#include <stdexcept>
+
+#include <QtTest>
+#include <QCoreApplication>
+#include <QCoro/QCoroTask>
+#include <QCoro/QCoroTimer>
+
+#include "AiInFlight.h"
+
+class AiInFlightTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void test_questionKey();
+    void test_sameQuestionAskedOnce();
+    void test_errorSharedThenForgotten();
+};
+
+void AiInFlightTests::test_questionKey()
+{
+    const QMap<QString, QString> valuesForAi{{"0_ai_description", "Robe"}, {"color", "Red"}};
+    const auto &key = AiInFlight::questionKey(
+                {"select", "amazon", "de", "color"}, valuesForAi, QSet<QString>{"Rot", "Blau"});
+    QCOMPARE(key, AiInFlight::questionKey(
+                 {"select", "amazon", "de", "color"}, valuesForAi, QSet<QString>{"Blau", "Rot"}));
+    QVERIFY(key != AiInFlight::questionKey(
+                {"select", "amazon", "fr", "color"}, valuesForAi, QSet<QString>{"Rot", "Blau"}));
+    QVERIFY(AiInFlight::questionKey({"ab", "c"}) != AiInFlight::questionKey({"a", "bc"}));
+}
+
+void AiInFlightTests::test_sameQuestionAskedOnce()
+{
+    int nAsked = 0;
+    auto askAi = [&nAsked]() -> QCoro::Task<QString> {
+        ++nAsked;
+        co_await QCoro::sleepFor(std::chrono::milliseconds{20});
+        co_return QString{"{\"value\":\"Rot\"}"};
+    };
+    auto inFlight = AiInFlight::instance();
+    auto taskDe = inFlight->ask("same", askAi);
+    auto taskAt = inFlight->ask("same", askAi);
+    auto taskFr = inFlight->ask("other", askAi);
+    QCOMPARE(inFlight->countInFlight(), 2);
+    QCOMPARE(QCoro::waitFor(taskDe), QString{"{\"value\":\"Rot\"}"});
+    QCOMPARE(QCoro::waitFor(taskAt), QString{"{\"value\":\"Rot\"}"});
+    QCoro::waitFor(taskFr);
+    QCOMPARE(nAsked, 2);
+    QCOMPARE(inFlight->countInFlight(), 0);
+}
+
+void AiInFlightTests::test_errorSharedThenForgotten()
+{
+    int nAsked = 0;
+    auto askAi = [&nAsked]() -> QCoro::Task<QString> {
+        ++nAsked;
+        co_await QCoro::sleepFor(std::chrono::milliseconds{20});
+        throw std::runtime_error{"No reply"};
+    };
+    auto inFlight = AiInFlight::instance();
+    auto taskFirst = inFlight->ask("failing", askAi);
+    auto taskSecond = inFlight->ask("failing", askAi);
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, QCoro::waitFor(taskFirst));
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, QCoro::waitFor(taskSecond));
+    QCOMPARE(nAsked, 1);
+    QCOMPARE(inFlight->countInFlight(), 0);
+}
+
+QTEST_MAIN(AiInFlightTests)
+#include "tst_aiinflight.moc"
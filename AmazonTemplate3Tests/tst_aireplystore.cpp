@@ -0,0 +1,120 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QSettings>
+#include <QTemporaryDir>
+
+#include "AiReplyStore.h"
+#include "ExceptionTemplate.h"
+
+class AiReplyStoreTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void test_importSettings();
+    void test_appendAndReopen();
+    void test_truncatedRecord();
+    void test_compact();
+    void test_foreignFile();
+
+private:
+    QTemporaryDir m_tempDir;
+};
+
+void AiReplyStoreTests::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+}
+
+void AiReplyStoreTests::test_importSettings()
+{
+    const auto &filePath = m_tempDir.filePath("import.ini");
+    {
+        QSettings settings{filePath, QSettings::IniFormat};
+        settings.setValue("SKU-1_color", "Red");
+        settings.setValue("SKU-2_color", "Blue");
+    }
+    auto store = AiReplyStore::instance();
+    QCOMPARE(store->value(filePath, "SKU-1_color"), QString("Red"));
+    QVERIFY(store->contains(filePath, "SKU-2_color"));
+    QVERIFY(!store->contains(filePath, "SKU-3_color"));
+    QVERIFY(QFile::exists(AiReplyStore::logFilePath(filePath)));
+    QVERIFY(QFile::exists(AiReplyStore::indexFilePath(filePath)));
+    const auto &importFileNames = QDir{m_tempDir.path()}.entryList({"import*"}, QDir::Files);
+    QCOMPARE(importFileNames.size(), 3); // No temporary file left by the import
+}
+
+void AiReplyStoreTests::test_appendAndReopen()
+{
+    const auto &filePath = m_tempDir.filePath("append.ini");
+    auto store = AiReplyStore::instance();
+    store->setValue(filePath, "SKU-1_title", "Robe d'été", "gpt-5.2");
+    store->setValues(filePath, {{"SKU-2_title", "Robe"}, {"SKU-3_title", "Jupe"}});
+    store->flush();
+    store->setValue(filePath, "SKU-2_title", "Robe longue"); // Not indexed yet
+    QCOMPARE(store->value(filePath, "SKU-2_title"), QString("Robe longue"));
+    store->clear();
+    QCOMPARE(store->value(filePath, "SKU-1_title"), QString("Robe d'été"));
+    QCOMPARE(store->value(filePath, "SKU-2_title"), QString("Robe longue"));
+    QCOMPARE(store->value(filePath, "SKU-3_title"), QString("Jupe"));
+    QVERIFY(!QFile::exists(filePath)); // The .ini file is only read
+}
+
+void AiReplyStoreTests::test_truncatedRecord()
+{
+    const auto &filePath = m_tempDir.filePath("truncated.ini");
+    auto store = AiReplyStore::instance();
+    store->setValue(filePath, "SKU-1_size", "M");
+    store->setValue(filePath, "SKU-2_size", "L");
+    store->clear();
+    {
+        // Run killed while the last record was written
+        QFile logFile{AiReplyStore::logFilePath(filePath)};
+        QVERIFY(logFile.open(QFile::ReadWrite));
+        QVERIFY(logFile.resize(logFile.size() - 1));
+    }
+    QFile::remove(AiReplyStore::indexFilePath(filePath));
+    QCOMPARE(store->value(filePath, "SKU-1_size"), QString("M"));
+    QVERIFY(!store->contains(filePath, "SKU-2_size"));
+    store->setValue(filePath, "SKU-3_size", "S");
+    store->clear();
+    QCOMPARE(store->value(filePath, "SKU-3_size"), QString("S"));
+}
+
+void AiReplyStoreTests::test_compact()
+{
+    const auto &filePath = m_tempDir.filePath("compact.ini");
+    auto store = AiReplyStore::instance();
+    for (int i=0; i<10; ++i)
+    {
+        store->setValue(filePath, "SKU-1_description", "Description " + QString::number(i));
+    }
+    store->setValue(filePath, "SKU-2_description", "Other");
+    store->flush();
+    qint64 sizeBefore = QFileInfo{AiReplyStore::logFilePath(filePath)}.size();
+    QVERIFY(store->compact(filePath));
+    QVERIFY(QFileInfo{AiReplyStore::logFilePath(filePath)}.size() < sizeBefore);
+    QCOMPARE(store->value(filePath, "SKU-1_description"), QString("Description 9"));
+    store->clear();
+    QCOMPARE(store->value(filePath, "SKU-1_description"), QString("Description 9"));
+    QCOMPARE(store->value(filePath, "SKU-2_description"), QString("Other"));
+}
+
+void AiReplyStoreTests::test_foreignFile()
+{
+    const auto &filePath = m_tempDir.filePath("foreign.ini");
+    {
+        QFile logFile{AiReplyStore::logFilePath(filePath)};
+        QVERIFY(logFile.open(QFile::WriteOnly));
+        logFile.write("Not a log of AI replies");
+    }
+    auto store = AiReplyStore::instance();
+    QVERIFY_THROWS_EXCEPTION(ExceptionTemplate, store->value(filePath, "SKU-1_color"));
+    QFile logFile{AiReplyStore::logFilePath(filePath)};
+    QVERIFY(logFile.open(QFile::ReadOnly));
+    QCOMPARE(logFile.readAll(), QByteArray{"Not a log of AI replies"}); // Left as it is
+}
+
+QTEST_MAIN(AiReplyStoreTests)
+#include "tst_aireplystore.moc"
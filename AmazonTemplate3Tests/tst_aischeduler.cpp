@@ -0,0 +1,137 @@
+#include <functional>
+
+#include <QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QCoro/QCoroTask>
+
+#define private public
+#include "AiScheduler.h"
+#undef private
+
+static constexpr int NOT_PACED_MS = 50;
+
+struct StepFake
+{
+    std::function<QString(int nAttempts)> getPrompt;
+    std::function<bool(const QString &gptReply)> validate;
+    std::function<void()> apply;
+};
+
+class AiSchedulerTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void test_noLimit_notPaced();
+    void test_requestsPerMinute_paced();
+    void test_tokensPerMinute_paced();
+    void test_highPriority_first();
+    void test_retry_charged();
+};
+
+void AiSchedulerTests::init()
+{
+    AiScheduler::instance()->clear();
+}
+
+void AiSchedulerTests::test_noLimit_notPaced()
+{
+    auto scheduler = AiScheduler::instance();
+    QElapsedTimer timer;
+    timer.start();
+    for (int i=0; i<100; ++i)
+    {
+        QCoro::waitFor(scheduler->acquire("unlimited", AiScheduler::Low, AiScheduler::CHUNK_SIZE));
+    }
+    QVERIFY(timer.elapsed() < NOT_PACED_MS);
+    QCOMPARE(scheduler->queueDepth(), 0);
+    const auto &lowObject = scheduler->summary()["priorities"].toObject()["low"].toObject();
+    QCOMPARE(lowObject["requests"].toInteger(), qint64(100 * AiScheduler::CHUNK_SIZE));
+    QCOMPARE(lowObject["chunks"].toInteger(), qint64(100));
+}
+
+void AiSchedulerTests::test_requestsPerMinute_paced()
+{
+    auto scheduler = AiScheduler::instance();
+    scheduler->setLimits("rpm", 6000, 0); // 0.09 request per ms, 450 in the bucket
+    QElapsedTimer timer;
+    timer.start();
+    QCoro::waitFor(scheduler->acquire("rpm", AiScheduler::Normal, 450));
+    QVERIFY(timer.elapsed() < NOT_PACED_MS);
+    timer.restart();
+    QCoro::waitFor(scheduler->acquire("rpm", AiScheduler::Normal, 9));
+    QVERIFY(timer.elapsed() >= 90);
+    QVERIFY(timer.elapsed() < 1000);
+    const auto &normalObject = scheduler->summary()["priorities"].toObject()["normal"].toObject();
+    QVERIFY(normalObject["waitMs"].toObject()["max"].toInteger() >= 90);
+}
+
+void AiSchedulerTests::test_tokensPerMinute_paced()
+{
+    auto scheduler = AiScheduler::instance();
+    scheduler->setLimits("tpm", 0, 600000, 1000); // 9 tokens per ms, 45000 in the bucket
+    QElapsedTimer timer;
+    timer.start();
+    QCoro::waitFor(scheduler->acquire("tpm", AiScheduler::Normal, 45));
+    QVERIFY(timer.elapsed() < NOT_PACED_MS);
+    timer.restart();
+    QCoro::waitFor(scheduler->acquire("tpm", AiScheduler::Normal, 1));
+    QVERIFY(timer.elapsed() >= 100);
+    QVERIFY(timer.elapsed() < 1000);
+}
+
+void AiSchedulerTests::test_highPriority_first()
+{
+    auto scheduler = AiScheduler::instance();
+    scheduler->setLimits("priority", 6000, 0);
+    QCoro::waitFor(scheduler->acquire("priority", AiScheduler::Normal, 450)); // Bucket emptied
+    QStringList order;
+    auto acquireThenRecord = [scheduler, &order](AiScheduler::Priority priority, QString name) -> QCoro::Task<void> {
+        co_await scheduler->acquire("priority", priority, 9);
+        order << name;
+    };
+    auto taskLow = acquireThenRecord(AiScheduler::Low, "low");
+    auto taskHigh = acquireThenRecord(AiScheduler::High, "high");
+    QCOMPARE(scheduler->queueDepth(), 18);
+    QCoro::waitFor(taskLow);
+    QCoro::waitFor(taskHigh);
+    QCOMPARE(order, QStringList({"high", "low"}));
+    QCOMPARE(scheduler->queueDepth(), 0);
+    const auto &prioritiesObject = scheduler->summary()["priorities"].toObject();
+    QCOMPARE(prioritiesObject["low"].toObject()["queueDepthMax"].toInteger(), qint64(9));
+    QCOMPARE(prioritiesObject["high"].toObject()["queueDepthMax"].toInteger(), qint64(18));
+}
+
+void AiSchedulerTests::test_retry_charged()
+{
+    auto scheduler = AiScheduler::instance();
+    scheduler->setLimits("retry", 6000, 600000, 1000);
+    QCoro::waitFor(scheduler->acquire("retry", AiScheduler::Normal, 1));
+    const auto &bucket = scheduler->m_model_bucket["retry"];
+    const double requestsAcquired = bucket.requests;
+    const double tokensAcquired = bucket.tokens;
+    auto step = QSharedPointer<StepFake>::create();
+    step->getPrompt = [](int) -> QString { return QString(400, 'p'); }; // 100 tokens
+    step->validate = [](const QString &) { return true; };
+    step->apply = []{};
+    scheduler->_charge(QList<QSharedPointer<StepFake>>{step}, "retry");
+
+    step->getPrompt(0); // The 1000 tokens estimated are refunded
+    QVERIFY(step->validate(QString(200, 'r'))); // 50 tokens
+    QCOMPARE(bucket.requests, requestsAcquired);
+    QCOMPARE(bucket.tokens, tokensAcquired + 1000. - 150.);
+
+    step->getPrompt(1);
+    QVERIFY(step->validate(QString(200, 'r')));
+    QCOMPARE(bucket.requests, requestsAcquired - 1.);
+    QCOMPARE(bucket.tokens, tokensAcquired + 1000. - 300.);
+    QCOMPARE(scheduler->m_model_usage["retry"].replies, qint64(2));
+
+    step->apply(); // Nothing left to refund
+    QCOMPARE(bucket.tokens, tokensAcquired + 1000. - 300.);
+}
+
+QTEST_MAIN(AiSchedulerTests)
+#include "tst_aischeduler.moc"
@@ -0,0 +1,124 @@
+#include <functional>
+
+#include <QtTest>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include "AiTelemetry.h"
+
+class AiTelemetryTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void test_percentile();
+    void test_instrument_countsRequests();
+    void test_run_writesSummary();
+
+private:
+    struct StepFake
+    {
+        std::function<QString(int)> getPrompt;
+        std::function<bool(const QString &, const QString &)> validate;
+        std::function<void(const QString &)> apply;
+    };
+    QTemporaryDir m_tempDir;
+    QSharedPointer<StepFake> createStep(QString &replyApplied) const;
+};
+
+void AiTelemetryTests::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+}
+
+QSharedPointer<AiTelemetryTests::StepFake> AiTelemetryTests::createStep(QString &replyApplied) const
+{
+    auto step = QSharedPointer<StepFake>::create();
+    step->getPrompt = [](int nAttempts) -> QString {
+        return nAttempts == 0 ? QString{"12345678"} : QString{"1234"};
+    };
+    step->validate = [](const QString &gptReply, const QString &lastWhy) -> bool {
+        Q_UNUSED(lastWhy)
+        return gptReply.startsWith("{");
+    };
+    step->apply = [&replyApplied](const QString &reply) {
+        replyApplied = reply;
+    };
+    return step;
+}
+
+void AiTelemetryTests::test_percentile()
+{
+    QList<qint64> values;
+    for (int i=100; i>=1; --i)
+    {
+        values << i;
+    }
+    QCOMPARE(AiTelemetry::percentile(values, 50.), qint64(50));
+    QCOMPARE(AiTelemetry::percentile(values, 95.), qint64(95));
+    QCOMPARE(AiTelemetry::percentile(values, 99.), qint64(99));
+    QCOMPARE(AiTelemetry::percentile({7}, 99.), qint64(7));
+    QCOMPARE(AiTelemetry::percentile({}, 50.), qint64(0));
+}
+
+void AiTelemetryTests::test_instrument_countsRequests()
+{
+    auto telemetry = AiTelemetry::instance();
+    telemetry->clear();
+    QString replyApplied;
+    auto step = createStep(replyApplied);
+    telemetry->instrument(QList<QSharedPointer<StepFake>>{step}, "FillerSelectable.consensus.phase1", "color#1.value");
+
+    QCOMPARE(step->getPrompt(0), QString{"12345678"});
+    QVERIFY(!step->validate("Not JSON", QString{}));
+    QCOMPARE(step->getPrompt(1), QString{"1234"});
+    QVERIFY(step->validate("{\"value\":\"Rot\"}", QString{}));
+    step->apply("{\"value\":\"Rot\"}");
+    QCOMPARE(replyApplied, QString{"{\"value\":\"Rot\"}"});
+
+    const auto &stats = telemetry->stats("FillerSelectable.consensus.phase1", "color#1.value");
+    QCOMPARE(stats.requests, qint64(2));
+    QCOMPARE(stats.retries, qint64(1));
+    QCOMPARE(stats.validationFailures, qint64(1));
+    QCOMPARE(stats.promptChars, qint64(12));
+    QCOMPARE(stats.replyChars, qint64(8 + 15));
+    QCOMPARE(stats.latenciesMs.size(), qsizetype(2));
+    QCOMPARE(stats.stepsApplied, qint64(1));
+    QCOMPARE(telemetry->stats("FillerText", "color#1.value").requests, qint64(0));
+}
+
+void AiTelemetryTests::test_run_writesSummary()
+{
+    const auto &filePath = m_tempDir.filePath(AiTelemetry::FILE_NAME);
+    auto telemetry = AiTelemetry::instance();
+    QString replyApplied;
+    {
+        AiTelemetry::Run run{filePath};
+        QCOMPARE(telemetry->stats("FillerSelectable.consensus.phase1", "color#1.value").requests, qint64(0));
+        auto step = createStep(replyApplied);
+        telemetry->instrument(QList<QSharedPointer<StepFake>>{step}, "FillerText", "item_name#1.value");
+        step->getPrompt(0);
+        step->validate("{}", QString{});
+        step->apply("{}");
+        telemetry->recordCacheLookup("aiText.ini", true);
+        telemetry->recordCacheLookup("aiText.ini", false);
+    }
+    QFile file{filePath};
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const auto &summary = QJsonDocument::fromJson(file.readAll()).object();
+    QCOMPARE(summary["total"].toObject()["requests"].toInteger(), qint64(1));
+    const auto &fillerObject = summary["fillers"].toObject()["FillerText"].toObject();
+    QCOMPARE(fillerObject["stepsApplied"].toInteger(), qint64(1));
+    const auto &fieldObject = fillerObject["fields"].toObject()["item_name#1.value"].toObject();
+    QCOMPARE(fieldObject["latencyMs"].toObject()["count"].toInteger(), qint64(1));
+    QCOMPARE(fieldObject["promptTokensEstimated"].toInteger(), qint64(2));
+    const auto &cacheObject = summary["caches"].toObject()["aiText.ini"].toObject();
+    QCOMPARE(cacheObject["lookups"].toInteger(), qint64(2));
+    QCOMPARE(cacheObject["hitRatio"].toDouble(), 0.5);
+}
+
+QTEST_MAIN(AiTelemetryTests)
+#include "tst_aitelemetry.moc"
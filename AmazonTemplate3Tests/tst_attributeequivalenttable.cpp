@@ -19,6 +19,8 @@ private slots:
     void initTestCase();
     void cleanupTestCase();
     void test_sorted_insertion();
+    void test_equivalents_mergedWhenSharingValue();
+    void test_equivalentValue_cacheCleared();
 
 private:
     QTemporaryDir m_tempDir;
@@ -80,5 +82,72 @@ void AttributeEquivalentTableTests::test_sorted_insertion()
     QCOMPARE(table.data(table.index(2, 0)).toString(), QString("Zebra"));
 }
 
+void AttributeEquivalentTableTests::test_equivalents_mergedWhenSharingValue()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fieldId{"color#1.value"};
+    {
+        AttributeEquivalentTable table(tempDir.path());
+        table.recordAttribute(fieldId, {"Red", "Rouge"});
+        table.recordAttribute(fieldId, {"Blue", "Bleu"});
+        table.recordAttribute(fieldId, {"Rot", "Rosso"});
+        QCOMPARE(table.rowCount(), 3);
+        QVERIFY(table.hasEquivalent(fieldId, "Rouge"));
+        QVERIFY(!table.hasEquivalent(fieldId, "Rot", {"Red", "Blue"}));
+        QVERIFY(!table.hasEquivalent("size#1.value", "Rouge"));
+
+        // A value of the new equivalents is known: the classes are merged
+        table.recordAttribute(fieldId, {"Rot", "Rouge", "Rojo"});
+        QCOMPARE(table.rowCount(), 2);
+        QCOMPARE(table.getEquivalentValues(fieldId, "Rosso")
+                 , QSet<QString>({"Red", "Rouge", "Rot", "Rosso", "Rojo"}));
+        QCOMPARE(table.getEquivalentValue(fieldId, "Rojo", {"Red", "Blue"}), QString("Red"));
+        QVERIFY(table.hasEquivalent(fieldId, "Rot", {"Red", "Blue"}));
+        QCOMPARE(table.getEquivalentValue(fieldId, "Bleu", {"Red", "Blue"}), QString("Blue"));
+        // Several possible values in the merged class: the smallest one is used
+        QCOMPARE(table.getEquivalentValue(fieldId, "Rosso", {"Rouge", "Rot", "Rojo"}), QString("Rojo"));
+        QCOMPARE(table.getEquivalentValue(fieldId, "Red", {"Rot", "Rouge"}), QString("Rot"));
+    }
+
+    // The merged row is saved
+    AttributeEquivalentTable tableReloaded(tempDir.path());
+    QCOMPARE(tableReloaded.rowCount(), 2);
+    QCOMPARE(tableReloaded.getEquivalentValues(fieldId, "Red").size(), 5);
+
+    // Edited rows are indexed again
+    int row = tableReloaded.getPosAttr(fieldId, QString{"Blue"});
+    QVERIFY(tableReloaded.setData(tableReloaded.index(row, 1), QString{"Blau"}));
+    QVERIFY(!tableReloaded.hasEquivalent(fieldId, "Bleu"));
+    QCOMPARE(tableReloaded.getEquivalentValue(fieldId, "Blau", {"Blau"}), QString("Blau"));
+    tableReloaded.remove(tableReloaded.index(row, 0));
+    QVERIFY(!tableReloaded.hasEquivalent(fieldId, "Blau"));
+    QVERIFY(tableReloaded.hasEquivalent(fieldId, "Rojo"));
+}
+
+void AttributeEquivalentTableTests::test_equivalentValue_cacheCleared()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fieldId{"color#1.value"};
+    const QSet<QString> possibleValues{"Rojo", "Rot"};
+    AttributeEquivalentTable table(tempDir.path());
+    table.recordAttribute(fieldId, {"Red", "Rouge"});
+    QVERIFY(!table.hasEquivalent(fieldId, "Red", possibleValues));
+    QCOMPARE(table.getEquivalentValue(fieldId, "Rouge", possibleValues), QString{});
+
+    // A value added to the class
+    table.recordAttribute(fieldId, {"Red", "Rot"});
+    QCOMPARE(table.getEquivalentValue(fieldId, "Rouge", possibleValues), QString("Rot"));
+    QCOMPARE(table.getEquivalentValue(fieldId, "Red", possibleValues), QString("Rot"));
+
+    // A class united with a smaller possible value
+    table.recordAttribute(fieldId, {"Rojo", "Rosso"});
+    QCOMPARE(table.getEquivalentValue(fieldId, "Rosso", possibleValues), QString("Rojo"));
+    table.recordAttribute(fieldId, {"Rosso", "Rouge"});
+    QCOMPARE(table.getEquivalentValue(fieldId, "Red", possibleValues), QString("Rojo"));
+    QCOMPARE(table.getEquivalentValue(fieldId, "Red", {"Rot"}), QString("Rot"));
+}
+
 QTEST_MAIN(AttributeEquivalentTableTests)
 #include "tst_attributeequivalenttable.moc"
@@ -1,5 +1,6 @@
 #include <QtTest>
 #include <QCoreApplication>
+#include <QSignalSpy>
 #include "AttributeFlagsTable.h"
 #include "Attribute.h"
 
@@ -9,6 +10,8 @@ class AttributeFlagsTableTests : public QObject
 
 private slots:
     void testGetSizeFieldIds();
+    void testBatch_savedOnceOnCommit();
+    void testSchema_followsEdits();
 };
 
 void AttributeFlagsTableTests::testGetSizeFieldIds()
@@ -46,5 +49,92 @@ void AttributeFlagsTableTests::testGetSizeFieldIds()
     QVERIFY(!result.contains("id3"));
 }
 
+void AttributeFlagsTableTests::testBatch_savedOnceOnCommit()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = QDir{tempDir.path()}.absoluteFilePath("attributeFlags.csv");
+
+    AttributeFlagsTable table(tempDir.path());
+    QSignalSpy spyReset(&table, &QAbstractItemModel::modelReset);
+    QSignalSpy spyInserted(&table, &QAbstractItemModel::rowsInserted);
+    table.beginBatch();
+    for (int i=99; i>=0; --i)
+    {
+        const QString &id = QString("id%1").arg(i, 3, 10, QChar('0'));
+        table.recordAttribute({{Attribute::AMAZON_V02, id}, {Attribute::AMAZON_V01, id + "_v01"}});
+    }
+    QSet<QString> fieldIds;
+    for (int i=0; i<150; ++i)
+    {
+        fieldIds << QString("id%1").arg(i, 3, 10, QChar('0'));
+    }
+    table.recordAttributeNotRecordedYet(Attribute::AMAZON_V02, fieldIds);
+    QVERIFY(!QFile::exists(filePath));
+    QCOMPARE(table.getFieldId(Attribute::AMAZON_V02, "id042", Attribute::AMAZON_V01), QString("id042_v01"));
+    table.commitBatch();
+
+    QVERIFY(QFile::exists(filePath));
+    QCOMPARE(spyReset.count(), 1);
+    QCOMPARE(spyInserted.count(), 0);
+    QCOMPARE(table.rowCount(), 150);
+    const int indV02 = Attribute::MARKETPLACES.indexOf(Attribute::AMAZON_V02);
+    QCOMPARE(table.data(table.index(0, indV02)).toString(), QString("id000"));
+    QCOMPARE(table.data(table.index(149, indV02)).toString(), QString("id149"));
+    QCOMPARE(table.getFieldId(Attribute::AMAZON_V02, "id042", Attribute::AMAZON_V01), QString("id042_v01"));
+
+    AttributeFlagsTable tableReloaded(tempDir.path());
+    QCOMPARE(tableReloaded.rowCount(), 150);
+    for (int i=0; i<table.rowCount(); ++i)
+    {
+        for (int j=0; j<table.columnCount(); ++j)
+        {
+            QCOMPARE(tableReloaded.data(tableReloaded.index(i, j)), table.data(table.index(i, j)));
+        }
+    }
+}
+
+void AttributeFlagsTableTests::testSchema_followsEdits()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    AttributeFlagsTable table(tempDir.path());
+    table.recordAttribute({{Attribute::AMAZON_V01, "color_name"}
+                           , {Attribute::AMAZON_V02, "color"}
+                           , {Attribute::TEMU_EN, "Color"}}
+                          , static_cast<Attribute::Flag>(Attribute::ChildOnly | Attribute::Copy));
+    table.recordAttribute({{Attribute::AMAZON_V02, "item_name"}}, Attribute::NoAI);
+
+    QVERIFY(table.hasFlag(Attribute::AMAZON_V02, "color", Attribute::ChildOnly));
+    QVERIFY(table.hasFlag(Attribute::TEMU_EN, "Color", Attribute::Copy));
+    QVERIFY(!table.hasFlag(Attribute::AMAZON_V01, "color_name", Attribute::NoAI));
+    QVERIFY(!table.hasFlag(Attribute::AMAZON_V02, "unknown", Attribute::NoAI));
+    QCOMPARE(table.getFlags(Attribute::AMAZON_V02, "item_name"), Attribute::NoAI);
+    QCOMPARE(table.getFieldId(Attribute::AMAZON_V01, "color_name", Attribute::TEMU_EN), QString("Color"));
+    QCOMPARE(table.getFieldId(Attribute::AMAZON_V02, "item_name", Attribute::AMAZON_V01), QString{});
+    QCOMPARE(table.getFieldId(Attribute::AMAZON_V02, "item_name", Attribute::AMAZON_V02), QString("item_name"));
+    QCOMPARE(table.get_marketplace_id(Attribute::AMAZON_V02, "color").size(), 3);
+    QCOMPARE(table.get_marketplace_id(Attribute::AMAZON_V02, "unknown").size(), 0);
+    QCOMPARE(table.getUnrecordedFieldIds(Attribute::AMAZON_V02, {"color", "size"}), QSet<QString>{"size"});
+
+    const auto &schemaBefore = table.schema();
+    const int indV01 = Attribute::MARKETPLACES.indexOf(Attribute::AMAZON_V01);
+    const int rowItemName = schemaBefore->row(Attribute::AMAZON_V02, "item_name");
+    QVERIFY(rowItemName >= 0);
+    const int indV02 = Attribute::MARKETPLACES.indexOf(Attribute::AMAZON_V02);
+    QCOMPARE(schemaBefore->row(indV02, schemaBefore->fieldIndex("item_name")), rowItemName);
+    QCOMPARE(schemaBefore->fieldIndex("unknown"), -1);
+    QVERIFY(table.setData(table.index(rowItemName, indV01), QString("item_name_v01")));
+    const int indNoAI = Attribute::MARKETPLACES.size()
+            + Attribute::STRING_FLAG.keys().indexOf(Attribute::FLAG_STRING[Attribute::NoAI]);
+    QVERIFY(table.setData(table.index(rowItemName, indNoAI), false));
+
+    QCOMPARE(table.getFieldId(Attribute::AMAZON_V02, "item_name", Attribute::AMAZON_V01), QString("item_name_v01"));
+    QVERIFY(!table.hasFlag(Attribute::AMAZON_V01, "item_name_v01", Attribute::NoAI));
+    QVERIFY(schemaBefore->hasFlag(Attribute::AMAZON_V02, "item_name", Attribute::NoAI)); // A snapshot is not changed
+    QVERIFY(table.schema() != schemaBefore);
+}
+
 QTEST_MAIN(AttributeFlagsTableTests)
 #include "tst_attributeflagstable.moc"
@@ -16,6 +16,7 @@ private slots:
     void cleanupTestCase();
     void test_recordAndContains();
     void test_replaceIfContains();
+    void test_index_followsEditsAndReload();
 
 private:
     QString m_workingDir;
@@ -99,6 +100,46 @@ void AttributeValueReplacedTableTests::test_replaceIfContains()
     QVERIFY(!values.contains("Rouge"));
 }
 
+void AttributeValueReplacedTableTests::test_index_followsEditsAndReload()
+{
+    AttributeValueReplacedTable table(m_workingDir);
+
+    QString marketplace = "Amazon.de";
+    QString country = "DE";
+    QString lang = "de";
+    QString productType = "DRESS";
+    QString fieldId = "color";
+
+    table.recordAttribute(marketplace, country, lang, productType, fieldId, "Rot", "Rot (Kirsche)");
+    QCOMPARE(table.data(table.index(0, 5)).toString(), QString("Rot"));
+
+    // Editing the value from updates the lookups
+    QVERIFY(table.setData(table.index(0, 5), "Dunkelrot"));
+    QVERIFY(!table.contains(marketplace, country, lang, productType, fieldId, "Rot"));
+    QString val = "Dunkelrot";
+    QVERIFY(table.replaceIfContains(marketplace, country, lang, productType, fieldId, val));
+    QCOMPARE(val, QString("Rot (Kirsche)"));
+
+    // Editing the value to as well
+    QVERIFY(table.setData(table.index(0, 6), "Weinrot"));
+    val = "Dunkelrot";
+    QVERIFY(table.replaceIfContains(marketplace, country, lang, productType, fieldId, val));
+    QCOMPARE(val, QString("Weinrot"));
+
+    // The index is built again when the file is read
+    {
+        AttributeValueReplacedTable tableReloaded(m_workingDir);
+        QVERIFY(tableReloaded.contains(marketplace, country, lang, productType, fieldId, "Dunkelrot"));
+        QVERIFY(!tableReloaded.contains(marketplace, "AT", lang, productType, fieldId, "Dunkelrot"));
+    }
+
+    table.remove(table.index(0, 0));
+    QVERIFY(!table.contains(marketplace, country, lang, productType, fieldId, "Dunkelrot"));
+    QSet<QString> values{"Dunkelrot", "Blau"};
+    table.replaceIfContains(marketplace, country, lang, productType, fieldId, values);
+    QCOMPARE(values, QSet<QString>({"Dunkelrot", "Blau"}));
+}
+
 QTEST_MAIN(AttributeValueReplacedTableTests)
 
 #include "tst_attributevaluereplacedtable.moc"
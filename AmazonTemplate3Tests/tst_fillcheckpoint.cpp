@@ -0,0 +1,187 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "FillCheckpoint.h"
+
+class FillCheckpointTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void test_saveLoad_resumes();
+    void test_load_otherInputs();
+    void test_journal_replays();
+    void test_changedValues();
+    void test_remove();
+
+private:
+    QTemporaryDir m_tempDir;
+};
+
+void FillCheckpointTests::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+}
+
+void FillCheckpointTests::test_saveLoad_resumes()
+{
+    const auto &filePath = m_tempDir.filePath("resume_" + FillCheckpoint::FILE_NAME);
+    QHash<QString, QHash<QString, QHash<QString, QHash<QString, QString>>>> countryCode_langCode_sku_fieldId_toValues;
+    QHash<QString, QHash<QString, QHash<QString, QString>>> langCode_sku_fieldId_toValues;
+    countryCode_langCode_sku_fieldId_toValues["DE"]["DE"]["SKU-1"]["color_name"] = "Rot";
+    countryCode_langCode_sku_fieldId_toValues["FR"]["FR"];
+    langCode_sku_fieldId_toValues["DE"]["SKU-1"]["color_name"] = "Rot";
+    {
+        FillCheckpoint checkpoint{filePath, "inputs"};
+        checkpoint.setDone("Template_DE_TOFILL.xlsm", "FillerSelectable", "color_name");
+        checkpoint.setTargetDone("Template_DE_TOFILL.xlsm");
+        QVERIFY(checkpoint.save(countryCode_langCode_sku_fieldId_toValues, langCode_sku_fieldId_toValues));
+    }
+
+    QHash<QString, QHash<QString, QHash<QString, QHash<QString, QString>>>> countryCode_langCode_sku_fieldId_toValuesLoaded;
+    QHash<QString, QHash<QString, QHash<QString, QString>>> langCode_sku_fieldId_toValuesLoaded;
+    FillCheckpoint checkpoint{filePath, "inputs"};
+    QVERIFY(checkpoint.load(countryCode_langCode_sku_fieldId_toValuesLoaded, langCode_sku_fieldId_toValuesLoaded));
+    QCOMPARE(countryCode_langCode_sku_fieldId_toValuesLoaded, countryCode_langCode_sku_fieldId_toValues);
+    QCOMPARE(langCode_sku_fieldId_toValuesLoaded, langCode_sku_fieldId_toValues);
+    QCOMPARE(checkpoint.nDone(), 1);
+    QVERIFY(checkpoint.isDone("Template_DE_TOFILL.xlsm", "FillerSelectable", "color_name"));
+    QVERIFY(!checkpoint.isDone("Template_DE_TOFILL.xlsm", "FillerText", "color_name"));
+    QVERIFY(!checkpoint.isDone("Template_FR_TOFILL.xlsm", "FillerSelectable", "color_name"));
+    QVERIFY(checkpoint.isTargetDone("Template_DE_TOFILL.xlsm"));
+    QVERIFY(!checkpoint.isTargetDone("Template_FR_TOFILL.xlsm"));
+}
+
+void FillCheckpointTests::test_load_otherInputs()
+{
+    const auto &filePath = m_tempDir.filePath("inputs_" + FillCheckpoint::FILE_NAME);
+    QHash<QString, QHash<QString, QHash<QString, QHash<QString, QString>>>> countryCode_langCode_sku_fieldId_toValues;
+    QHash<QString, QHash<QString, QHash<QString, QString>>> langCode_sku_fieldId_toValues;
+    countryCode_langCode_sku_fieldId_toValues["DE"]["DE"]["SKU-1"]["color_name"] = "Rot";
+    {
+        FillCheckpoint checkpoint{filePath, "inputs"};
+        checkpoint.setDone("Template_DE_TOFILL.xlsm", "FillerSelectable", "color_name");
+        QVERIFY(checkpoint.save(countryCode_langCode_sku_fieldId_toValues, langCode_sku_fieldId_toValues));
+    }
+    QHash<QString, QHash<QString, QHash<QString, QHash<QString, QString>>>> countryCode_langCode_sku_fieldId_toValuesLoaded;
+    QHash<QString, QHash<QString, QHash<QString, QString>>> langCode_sku_fieldId_toValuesLoaded;
+    FillCheckpoint checkpoint{filePath, "inputs with a colour fixed"};
+    QVERIFY(!checkpoint.load(countryCode_langCode_sku_fieldId_toValuesLoaded, langCode_sku_fieldId_toValuesLoaded));
+    QVERIFY(countryCode_langCode_sku_fieldId_toValuesLoaded.isEmpty());
+    QCOMPARE(checkpoint.nDone(), 0);
+
+    FillCheckpoint checkpointMissing{m_tempDir.filePath("missing.dat"), "inputs"};
+    QVERIFY(!checkpointMissing.load(countryCode_langCode_sku_fieldId_toValuesLoaded, langCode_sku_fieldId_toValuesLoaded));
+}
+
+void FillCheckpointTests::test_journal_replays()
+{
+    const auto &filePath = m_tempDir.filePath("journal_" + FillCheckpoint::FILE_NAME);
+    QHash<QString, QHash<QString, QHash<QString, QHash<QString, QString>>>> countryCode_langCode_sku_fieldId_toValues;
+    QHash<QString, QHash<QString, QHash<QString, QString>>> langCode_sku_fieldId_toValues;
+    countryCode_langCode_sku_fieldId_toValues["UK"]["EN"]["SKU-1"]["color_name"] = "Red";
+    qint64 sizeSnapshot = 0;
+    qint64 sizeJournalField = 0;
+    qint64 sizeJournal = 0;
+    {
+        FillCheckpoint checkpoint{filePath, "inputs"};
+        QVERIFY(!checkpoint.appendProgress("Template_DE_TOFILL.xlsm", "DE", "DE", {}, {})); // No snapshot yet
+        QVERIFY(checkpoint.save(countryCode_langCode_sku_fieldId_toValues, langCode_sku_fieldId_toValues));
+        sizeSnapshot = QFileInfo{filePath}.size();
+        QVERIFY(sizeSnapshot > 0);
+
+        checkpoint.setDone("Template_DE_TOFILL.xlsm", "FillerCopy", "item_sku");
+        QVERIFY(checkpoint.appendProgress("Template_DE_TOFILL.xlsm"
+                                          , "DE"
+                                          , "DE"
+                                          , {{"SKU-1", {{"item_sku", "SKU-1"}}}}
+                                          , {}));
+        checkpoint.setDone("Template_DE_TOFILL.xlsm", "FillerSelectable", "color_name");
+        QVERIFY(checkpoint.appendProgress("Template_DE_TOFILL.xlsm"
+                                          , "DE"
+                                          , "DE"
+                                          , {{"SKU-1", {{"color_name", "Rot"}}}}
+                                          , {{"SKU-1", {{"color_name", "Rot"}}}}));
+        sizeJournalField = QFileInfo{filePath}.size();
+        checkpoint.setTargetDone("Template_DE_TOFILL.xlsm");
+        QVERIFY(checkpoint.appendProgress("Template_DE_TOFILL.xlsm", "DE", "DE", {}, {}));
+        sizeJournal = QFileInfo{filePath}.size();
+
+        // Done but not journaled: filled again on resume
+        checkpoint.setDone("Template_FR_TOFILL.xlsm", "FillerCopy", "item_sku");
+    }
+
+    QHash<QString, QHash<QString, QHash<QString, QHash<QString, QString>>>> countryCode_langCode_sku_fieldId_toValuesLoaded;
+    QHash<QString, QHash<QString, QHash<QString, QString>>> langCode_sku_fieldId_toValuesLoaded;
+    {
+        FillCheckpoint checkpoint{filePath, "inputs"};
+        QVERIFY(checkpoint.load(countryCode_langCode_sku_fieldId_toValuesLoaded, langCode_sku_fieldId_toValuesLoaded));
+        QCOMPARE(countryCode_langCode_sku_fieldId_toValuesLoaded["UK"]["EN"]["SKU-1"]["color_name"], QString("Red"));
+        QCOMPARE(countryCode_langCode_sku_fieldId_toValuesLoaded["DE"]["DE"]["SKU-1"]["item_sku"], QString("SKU-1"));
+        QCOMPARE(countryCode_langCode_sku_fieldId_toValuesLoaded["DE"]["DE"]["SKU-1"]["color_name"], QString("Rot"));
+        QCOMPARE(langCode_sku_fieldId_toValuesLoaded["DE"]["SKU-1"]["color_name"], QString("Rot"));
+        QVERIFY(!countryCode_langCode_sku_fieldId_toValuesLoaded.contains("FR"));
+        QCOMPARE(checkpoint.nDone(), 2);
+        QVERIFY(checkpoint.isDone("Template_DE_TOFILL.xlsm", "FillerSelectable", "color_name"));
+        QVERIFY(!checkpoint.isDone("Template_FR_TOFILL.xlsm", "FillerCopy", "item_sku"));
+        QVERIFY(checkpoint.isTargetDone("Template_DE_TOFILL.xlsm"));
+    }
+
+    // The last record truncated by a crash is ignored, only its field is filled again
+    {
+        QFile file{filePath};
+        QVERIFY(file.resize(sizeJournalField - 3));
+    }
+    countryCode_langCode_sku_fieldId_toValuesLoaded.clear();
+    langCode_sku_fieldId_toValuesLoaded.clear();
+    FillCheckpoint checkpoint{filePath, "inputs"};
+    QVERIFY(checkpoint.load(countryCode_langCode_sku_fieldId_toValuesLoaded, langCode_sku_fieldId_toValuesLoaded));
+    QCOMPARE(countryCode_langCode_sku_fieldId_toValuesLoaded["DE"]["DE"]["SKU-1"]["item_sku"], QString("SKU-1"));
+    QVERIFY(!countryCode_langCode_sku_fieldId_toValuesLoaded["DE"]["DE"]["SKU-1"].contains("color_name"));
+    QCOMPARE(checkpoint.nDone(), 1);
+    QVERIFY(checkpoint.isDone("Template_DE_TOFILL.xlsm", "FillerCopy", "item_sku"));
+    QVERIFY(!checkpoint.isTargetDone("Template_DE_TOFILL.xlsm"));
+
+    // Saving again compacts the journal into one snapshot
+    QVERIFY(checkpoint.save(countryCode_langCode_sku_fieldId_toValuesLoaded, langCode_sku_fieldId_toValuesLoaded));
+    QVERIFY(QFileInfo{filePath}.size() < sizeJournal);
+}
+
+void FillCheckpointTests::test_changedValues()
+{
+    QHash<QString, QHash<QString, QString>> sku_fieldId_values;
+    sku_fieldId_values["SKU-1"]["item_sku"] = "SKU-1";
+    sku_fieldId_values["SKU-1"]["color_name"] = "Red";
+    sku_fieldId_values["SKU-2"]["item_sku"] = "SKU-2";
+    const auto sku_fieldId_valuesBefore = sku_fieldId_values;
+    QVERIFY(FillCheckpoint::changedValues(sku_fieldId_valuesBefore, sku_fieldId_values).isEmpty());
+
+    sku_fieldId_values["SKU-1"]["color_name"] = "Blue";
+    sku_fieldId_values["SKU-2"]["size_name"] = "M";
+    sku_fieldId_values["SKU-3"]["item_sku"] = "SKU-3";
+    const auto &sku_fieldId_valuesChanged = FillCheckpoint::changedValues(
+                sku_fieldId_valuesBefore, sku_fieldId_values);
+    QCOMPARE(sku_fieldId_valuesChanged.size(), 3);
+    QCOMPARE(sku_fieldId_valuesChanged["SKU-1"], (QHash<QString, QString>{{"color_name", "Blue"}}));
+    QCOMPARE(sku_fieldId_valuesChanged["SKU-2"], (QHash<QString, QString>{{"size_name", "M"}}));
+    QCOMPARE(sku_fieldId_valuesChanged["SKU-3"], (QHash<QString, QString>{{"item_sku", "SKU-3"}}));
+}
+
+void FillCheckpointTests::test_remove()
+{
+    const auto &filePath = m_tempDir.filePath("remove_" + FillCheckpoint::FILE_NAME);
+    FillCheckpoint checkpoint{filePath, "inputs"};
+    checkpoint.setDone("Template_DE_TOFILL.xlsm", "FillerSelectable", "color_name");
+    QVERIFY(checkpoint.save({}, {}));
+    QVERIFY(QFile::exists(filePath));
+    checkpoint.remove();
+    QVERIFY(!QFile::exists(filePath));
+    QCOMPARE(checkpoint.nDone(), 0);
+}
+
+QTEST_MAIN(FillCheckpointTests)
+#include "tst_fillcheckpoint.moc"
@@ -0,0 +1,95 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#define private public
+#include "fillers/FillerSelectable.h"
+#include "SelectConsensus.h"
+#undef private
+
+class FillerSelectableTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void test_batchStep_prompt();
+    void test_batchStep_validatePerKey();
+    void test_decideBatch_votes();
+
+private:
+    QList<FillerSelectable::SelectQuestion> questions() const;
+};
+
+QList<FillerSelectable::SelectQuestion> FillerSelectableTests::questions() const
+{
+    return QList<FillerSelectable::SelectQuestion>{
+        {"all_FR_FR_fr_SKU-1_color_name", "color_name", {"Rouge", "Bleu"}}
+        , {"all_FR_FR_fr_SKU-1_material_type", "material_type", {"Coton", "Lin", "Soie"}}};
+}
+
+void FillerSelectableTests::test_batchStep_prompt()
+{
+    const QMap<QString, QString> valuesForAi{{"0_ai_description", "Robe rouge en lin"}};
+    auto step = FillerSelectable::_createSelectBatchStep(
+                "amazon.fr", "SKU-1", valuesForAi, questions(), 1);
+    QCOMPARE(step->neededReplies, 1);
+    const QString &prompt = step->getPrompt(0);
+    QVERIFY(prompt.contains("Robe rouge en lin"));
+    QVERIFY(prompt.contains("Key: q1\nField: color_name"));
+    QVERIFY(prompt.contains("Key: q2\nField: material_type"));
+    QVERIFY(prompt.contains("- Soie"));
+
+    auto stepSameSample = FillerSelectable::_createSelectBatchStep(
+                "amazon.fr", "SKU-1", valuesForAi, questions(), 1);
+    QCOMPARE(stepSameSample->id, step->id); // Same questions, same cache entry
+    auto stepOtherSample = FillerSelectable::_createSelectBatchStep(
+                "amazon.fr", "SKU-1", valuesForAi, questions(), 2);
+    QVERIFY(stepOtherSample->id != step->id); // Each sample is a reply of its own
+}
+
+void FillerSelectableTests::test_batchStep_validatePerKey()
+{
+    auto step = FillerSelectable::_createSelectBatchStep(
+                "amazon.fr", "SKU-1", {{"0_ai_description", "Robe"}}, questions(), 1);
+    QVERIFY(step->validate(R"({"q1": "Rouge", "q2": "Lin"})", QString{}));
+    QVERIFY(step->validate(R"({"q1": "Rouge", "q2": "Polyester"})", QString{}));
+    QVERIFY(step->validate(R"({"q2": "Lin"})", QString{}));
+    QVERIFY(!step->validate(R"({"q1": "Vert", "q2": 3})", QString{}));
+    QVERIFY(!step->validate("Rouge", QString{}));
+
+    const auto &valueId_reply = FillerSelectable::_batchValueId_reply(
+                R"({"q1": "Rouge", "q2": "Polyester"})", questions());
+    QCOMPARE(valueId_reply.size(), 1);
+    const auto &valueObject = QJsonDocument::fromJson(
+                valueId_reply.value("all_FR_FR_fr_SKU-1_color_name").toUtf8()).object();
+    QCOMPARE(valueObject.value("value").toString(), QString("Rouge"));
+}
+
+void FillerSelectableTests::test_decideBatch_votes()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    SelectConsensus selectConsensus{tempDir.filePath("aiSelectConsensus.ini")};
+    const auto &valueId_reply = FillerSelectable::_decideBatch(
+                &selectConsensus
+                , questions()
+                , {R"({"q1": "Rouge", "q2": "Lin"})", R"({"q1": "Rouge", "q2": "Coton"})"}
+                , 2);
+    QCOMPARE(valueId_reply.size(), 1); // q2 disagrees, asked again alone
+    const auto &valueObject = QJsonDocument::fromJson(
+                valueId_reply.value("all_FR_FR_fr_SKU-1_color_name").toUtf8()).object();
+    QCOMPARE(valueObject.value("value").toString(), QString("Rouge"));
+    QCOMPARE(selectConsensus.m_fieldId_stats.value("color_name").decisions, 1);
+    QCOMPARE(selectConsensus.m_fieldId_stats.value("color_name").agreed, 1);
+    QVERIFY(!selectConsensus.m_fieldId_stats.contains("material_type"));
+
+    // One reply never decides a field that is not trusted yet
+    const auto &valueId_replyOne = FillerSelectable::_decideBatch(
+                &selectConsensus, questions(), {R"({"q1": "Rouge", "q2": "Lin"})"}, 1);
+    QVERIFY(valueId_replyOne.isEmpty());
+}
+
+QTEST_MAIN(FillerSelectableTests)
+#include "tst_fillerselectable.moc"
@@ -0,0 +1,90 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "FillManifest.h"
+
+class FillManifestTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void test_changedSkus();
+    void test_saveLoad();
+    void test_canRefill();
+
+private:
+    QTemporaryDir m_tempDir;
+    void writeFile(const QString &filePath, const QByteArray &content) const;
+};
+
+void FillManifestTests::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+}
+
+void FillManifestTests::writeFile(const QString &filePath, const QByteArray &content) const
+{
+    QFile file{filePath};
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(content);
+}
+
+void FillManifestTests::test_changedSkus()
+{
+    FillManifest previous;
+    previous.setSkuFingerprint("SKU-1", "a");
+    previous.setSkuFingerprint("SKU-2", "b");
+    previous.setSkuFingerprint("SKU-REMOVED", "c");
+    FillManifest current;
+    current.setSkuFingerprint("SKU-1", "a");
+    current.setSkuFingerprint("SKU-2", "B");
+    current.setSkuFingerprint("SKU-NEW", "d");
+    QCOMPARE(current.changedSkus(previous), (QSet<QString>{"SKU-2", "SKU-NEW"}));
+    QCOMPARE(current.changedSkus(FillManifest{}).size(), qsizetype{3});
+}
+
+void FillManifestTests::test_saveLoad()
+{
+    const auto &filledPath = m_tempDir.filePath("Template_FR_FILLED.xlsm");
+    writeFile(filledPath, "filled");
+    FillManifest manifest;
+    manifest.setRunFingerprint(QByteArray::fromHex("0a1b2c"));
+    manifest.setSkuFingerprint("SKU-1", QByteArray::fromHex("ff00"));
+    manifest.recordFilled(filledPath);
+    const auto &manifestPath = m_tempDir.filePath(FillManifest::FILE_NAME);
+    QVERIFY(manifest.save(manifestPath));
+
+    const auto &loaded = FillManifest::load(manifestPath);
+    QCOMPARE(loaded.runFingerprint(), QByteArray::fromHex("0a1b2c"));
+    QCOMPARE(loaded.skuFingerprint("SKU-1"), QByteArray::fromHex("ff00"));
+    QVERIFY(loaded.skuFingerprint("SKU-2").isEmpty());
+    QVERIFY(loaded.isFilledUnchanged(filledPath));
+    QVERIFY(FillManifest::load(m_tempDir.filePath("missing.json")).isEmpty());
+}
+
+void FillManifestTests::test_canRefill()
+{
+    const auto &filledPath = m_tempDir.filePath("Template_DE_FILLED.xlsm");
+    writeFile(filledPath, "filled");
+    FillManifest previous;
+    previous.setRunFingerprint("run");
+    previous.recordFilled(filledPath);
+    FillManifest current;
+    current.setRunFingerprint("run");
+    QVERIFY(previous.canRefill(current, QStringList{filledPath}));
+    QVERIFY(!previous.canRefill(current, QStringList{m_tempDir.filePath("Template_IT_FILLED.xlsm")}));
+    QVERIFY(!FillManifest{}.canRefill(current, QStringList{filledPath}));
+
+    FillManifest currentOtherSettings;
+    currentOtherSettings.setRunFingerprint("run with other flags");
+    QVERIFY(!previous.canRefill(currentOtherSettings, QStringList{filledPath}));
+
+    writeFile(filledPath, "filled then edited by hand");
+    QVERIFY(!previous.canRefill(current, QStringList{filledPath}));
+}
+
+QTEST_MAIN(FillManifestTests)
+#include "tst_fillmanifest.moc"
@@ -0,0 +1,86 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QImage>
+#include <QTemporaryDir>
+#include <QCoro/QCoroTask>
+
+#include "ImagePreparer.h"
+
+class ImagePreparerTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void test_downscaled();
+    void test_cachedByContent();
+    void test_notAnImage();
+
+private:
+    QTemporaryDir m_tempDir;
+    QString createImage(const QString &fileName, int width, int height);
+};
+
+void ImagePreparerTests::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+}
+
+QString ImagePreparerTests::createImage(const QString &fileName, int width, int height)
+{
+    QImage image{width, height, QImage::Format_RGB32};
+    for (int y=0; y<height; ++y)
+    {
+        auto line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x=0; x<width; ++x)
+        {
+            line[x] = qRgb(x % 256, y % 256, (x * y) % 256);
+        }
+    }
+    const auto &filePath = m_tempDir.filePath(fileName);
+    image.save(filePath, "JPG", 100);
+    return filePath;
+}
+
+void ImagePreparerTests::test_downscaled()
+{
+    const auto &imagePath = createImage("big.jpg", 3000, 2000);
+    ImagePreparer preparer{m_tempDir.filePath(".prepared"), 1000, 80};
+    const auto &imagePath_preparedPath = QCoro::waitFor(preparer.prepare({imagePath}));
+    QCOMPARE(imagePath_preparedPath.size(), 1);
+    const auto &preparedPath = imagePath_preparedPath[imagePath];
+    QVERIFY(preparedPath != imagePath);
+    QVERIFY(preparedPath.startsWith(m_tempDir.filePath(".prepared")));
+    QImage prepared{preparedPath};
+    QCOMPARE(prepared.width(), 1000);
+    QCOMPARE(prepared.height(), 667);
+    QVERIFY(QFileInfo{preparedPath}.size() < QFileInfo{imagePath}.size());
+}
+
+void ImagePreparerTests::test_cachedByContent()
+{
+    const auto &imagePath = createImage("first.jpg", 1200, 800);
+    const auto &imagePathCopy = m_tempDir.filePath("copy.jpg");
+    QVERIFY(QFile::copy(imagePath, imagePathCopy));
+    ImagePreparer preparer{m_tempDir.filePath(".prepared"), 500, 80};
+    const auto &preparedPath = preparer.prepareImage(imagePath);
+    QCOMPARE(preparer.prepareImage(imagePathCopy), preparedPath);
+
+    ImagePreparer preparerOtherSize{m_tempDir.filePath(".prepared"), 600, 80};
+    QVERIFY(preparerOtherSize.prepareImage(imagePath) != preparedPath);
+}
+
+void ImagePreparerTests::test_notAnImage()
+{
+    const auto &filePath = m_tempDir.filePath("notAnImage.jpg");
+    QFile file{filePath};
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("Not an image");
+    file.close();
+    ImagePreparer preparer{m_tempDir.filePath(".prepared")};
+    QCOMPARE(preparer.prepareImage(filePath), filePath);
+    QCOMPARE(preparer.prepareImage(m_tempDir.filePath("missing.jpg")), m_tempDir.filePath("missing.jpg"));
+}
+
+QTEST_MAIN(ImagePreparerTests)
+#include "tst_imagepreparer.moc"
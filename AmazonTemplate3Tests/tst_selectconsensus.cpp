@@ -0,0 +1,70 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QTemporaryDir>
+
+#include "SelectConsensus.h"
+
+class SelectConsensusTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void test_decide();
+    void test_trustedFieldAskedOnce();
+    void test_statsPersisted();
+
+private:
+    QTemporaryDir m_tempDir;
+};
+
+void SelectConsensusTests::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+}
+
+void SelectConsensusTests::test_decide()
+{
+    SelectConsensus consensus{m_tempDir.filePath("decide.ini")};
+    QCOMPARE(consensus.samplesFirst("color_name", 10), 2);
+    QCOMPARE(consensus.decide("color_name", 10, {"Red", "Red"}, 2), QString("Red"));
+    QVERIFY(consensus.decide("color_name", 10, {"Red", "Blue"}, 2).isEmpty());
+    QVERIFY(consensus.decide("color_name", 10, {"Red", "Blue", "Red"}, 3).isEmpty());
+    QCOMPARE(consensus.decide("color_name", 10, {"Red", "Blue", "Red", "Red"}, 4), QString("Red"));
+    QCOMPARE(consensus.decide("color_name", 10, {"Red", "Blue", "Blue", "Red", "Green"}, SelectConsensus::SAMPLES_MAX)
+             , QString("Blue")); // First to reach 2 votes
+    QVERIFY(consensus.decide("color_name", 10, {}, 2).isEmpty());
+}
+
+void SelectConsensusTests::test_trustedFieldAskedOnce()
+{
+    SelectConsensus consensus{m_tempDir.filePath("trusted.ini")};
+    for (int i=0; i<10; ++i)
+    {
+        consensus.record("department", {"Women", "Women"});
+        consensus.record("style", {"Casual", i % 2 == 0 ? "Casual" : "Boho"});
+    }
+    QCOMPARE(consensus.samplesFirst("department", 5), 2); // Checked every SelectConsensus::VERIFY_EVERY
+    consensus.record("department", {"Women", "Women"});
+    QCOMPARE(consensus.samplesFirst("department", 5), 1);
+    QCOMPARE(consensus.decide("department", 5, {"Women"}, 1), QString("Women"));
+    QCOMPARE(consensus.samplesFirst("department", 2), 2); // Not enough history for 2 values
+    QCOMPARE(consensus.samplesFirst("style", 5), 3);
+}
+
+void SelectConsensusTests::test_statsPersisted()
+{
+    const auto &filePath = m_tempDir.filePath("persisted.ini");
+    {
+        SelectConsensus consensus{filePath};
+        for (int i=0; i<11; ++i)
+        {
+            consensus.record("item_type_name#1.value", {"Dress", "Dress"});
+        }
+    }
+    SelectConsensus consensus{filePath};
+    QCOMPARE(consensus.samplesFirst("item_type_name#1.value", 5), 1);
+}
+
+QTEST_MAIN(SelectConsensusTests)
+#include "tst_selectconsensus.moc"
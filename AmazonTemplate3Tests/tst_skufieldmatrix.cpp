@@ -0,0 +1,118 @@
+#include <QtTest>
+#include <QCoreApplication>
+
+#include "SkuFieldMatrix.h"
+
+class SkuFieldMatrixTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void test_rows_likeHash();
+    void test_duplicateSku_lastWins();
+    void test_columnScan();
+    void test_rows_subset();
+};
+
+void SkuFieldMatrixTests::test_rows_likeHash()
+{
+    SkuFieldMatrix matrix{{"item_sku", "color", "size"}};
+    int row1 = matrix.addRow("SKU-1");
+    matrix.setValue(row1, 0, "SKU-1");
+    matrix.setValue(row1, 2, "M");
+    int row2 = matrix.addRow("SKU-2");
+    matrix.setValue(row2, 0, "SKU-2");
+    matrix.setValue(row2, 1, "Red");
+
+    QCOMPARE(matrix.size(), qsizetype{2});
+    QVERIFY(matrix.contains("SKU-1"));
+    QVERIFY(!matrix.contains("SKU-3"));
+    QVERIFY(matrix["SKU-1"].contains("size"));
+    QVERIFY(!matrix["SKU-1"].contains("color"));
+    QVERIFY(!matrix["SKU-1"].contains("unknown"));
+    QCOMPARE(matrix["SKU-1"]["size"], QString("M"));
+    QCOMPARE(matrix["SKU-1"]["color"], QString{});
+    QCOMPARE(matrix["SKU-1"].value("color", "None"), QString("None"));
+    QVERIFY(matrix["SKU-3"].isEmpty());
+    QCOMPARE(matrix["SKU-3"]["size"], QString{});
+
+    QStringList skus;
+    for (auto it = matrix.cbegin(); it != matrix.cend(); ++it)
+    {
+        skus << it.key();
+    }
+    QCOMPARE(skus, QStringList({"SKU-1", "SKU-2"}));
+
+    QHash<QString, QString> fieldId_value;
+    const auto &row = matrix["SKU-2"];
+    for (auto it = row.cbegin(); it != row.cend(); ++it)
+    {
+        fieldId_value[it.key()] = it.value();
+    }
+    QCOMPARE(row.size(), qsizetype{2});
+    QCOMPARE(fieldId_value, (QHash<QString, QString>{{"item_sku", "SKU-2"}, {"color", "Red"}}));
+    QCOMPARE(matrix.toHash()["SKU-1"], (QHash<QString, QString>{{"item_sku", "SKU-1"}, {"size", "M"}}));
+}
+
+void SkuFieldMatrixTests::test_duplicateSku_lastWins()
+{
+    SkuFieldMatrix matrix{{"color", "size"}};
+    int row = matrix.addRow("SKU-1");
+    matrix.setValue(row, 0, "Red");
+    QCOMPARE(matrix.addRow("SKU-1"), row);
+    matrix.setValue(row, 0, "Blue");
+    matrix.setValue(row, 1, "L");
+    QCOMPARE(matrix.rowCount(), 1);
+    QCOMPARE(matrix["SKU-1"]["color"], QString("Blue"));
+    QCOMPARE(matrix["SKU-1"]["size"], QString("L"));
+}
+
+void SkuFieldMatrixTests::test_columnScan()
+{
+    QStringList fieldIds;
+    for (int i=0; i<70; ++i)
+    {
+        fieldIds << QString("field_%1").arg(i);
+    }
+    SkuFieldMatrix matrix{fieldIds};
+    for (int i=0; i<5; ++i)
+    {
+        int row = matrix.addRow(QString("SKU-%1").arg(i));
+        if (i % 2 == 0)
+        {
+            matrix.setValue(row, 65, QString::number(i));
+        }
+    }
+    int column = matrix.columnIndex("field_65");
+    QCOMPARE(column, 65);
+    QCOMPARE(matrix.columnIndex("unknown"), -1);
+    QStringList values;
+    matrix.forEachInColumn(column, [&values](int, const QString &value){
+        values << value;
+    });
+    QCOMPARE(values, QStringList({"0", "2", "4"}));
+    QVERIFY(!matrix.has(1, 65));
+    QVERIFY(!matrix.has(0, 64));
+}
+
+void SkuFieldMatrixTests::test_rows_subset()
+{
+    SkuFieldMatrix matrix{{"color", "size"}};
+    for (int i=0; i<4; ++i)
+    {
+        int row = matrix.addRow(QString("SKU-%1").arg(i));
+        matrix.setValue(row, i % 2, QString::number(i));
+    }
+    const auto &subset = matrix.rows(QSet<QString>{"SKU-3", "SKU-0", "SKU-9"});
+    QCOMPARE(subset.columnCount(), 2);
+    QCOMPARE(subset.rowCount(), 2);
+    QCOMPARE(subset.sku(0), QString("SKU-0"));
+    QCOMPARE(subset.sku(1), QString("SKU-3"));
+    QCOMPARE(subset["SKU-0"]["color"], QString("0"));
+    QVERIFY(!subset["SKU-0"].contains("size"));
+    QCOMPARE(subset["SKU-3"]["size"], QString("3"));
+    QVERIFY(!subset.contains("SKU-1"));
+}
+
+QTEST_MAIN(SkuFieldMatrixTests)
+#include "tst_skufieldmatrix.moc"
@@ -6,6 +6,51 @@
 #include <QSet>
 #include "xlsxdocument.h"
 #include "TemplateFiller.h"
+#include "TemplateSnapshot.h"
+#include "fillers/AbstractFiller.h"
+#include "fillers/FillerDispatch.h"
+
+// Filler of a fixed set of field ids, to check the routing
+class FillerFake : public AbstractFiller
+{
+public:
+    FillerFake(const QString &name, const QSet<QString> &fieldIds)
+        : m_name(name)
+        , m_fieldIds(fieldIds)
+    {
+    }
+    QString name() const override
+    {
+        return m_name;
+    }
+    bool canFill(const TemplateFiller *
+                 , const Attribute *
+                 , const QString &
+                 , const QString &fieldIdFrom) const override
+    {
+        return m_fieldIds.contains(fieldIdFrom);
+    }
+    QCoro::Task<void> fill(
+            TemplateFiller *
+            , const FillContext &
+            , const QString &
+            , const QString &
+            , const QString &
+            , const Attribute *
+            , const QString &
+            , const QString &
+            , const QString &
+            , const QHash<QString, QHash<QString, QString>> &
+            , QHash<QString, QHash<QString, QString>> &
+            , QHash<QString, QHash<QString, QString>> &) const override
+    {
+        co_return;
+    }
+
+private:
+    QString m_name;
+    QSet<QString> m_fieldIds;
+};
 
 class TemplateFillerTests : public QObject
 {
@@ -15,6 +60,9 @@ private slots:
     void initTestCase();
     void cleanupTestCase();
     void test_getAllFieldIds();
+    void test_snapshotCacheInvalidation();
+    void test_fillerNames_stable();
+    void test_fillerDispatch_oneFillerPerField();
 
 private:
     QTemporaryDir m_tempDir;
@@ -123,5 +171,69 @@ void TemplateFillerTests::test_getAllFieldIds() {
     QCOMPARE(fieldIds.size(), expected.size());
 }
 
+void TemplateFillerTests::test_snapshotCacheInvalidation()
+{
+    QString filePath = createTemplateFile("snapshot.xlsx", {"item_sku", "feed_product_type"});
+    QFileInfo fileInfo{filePath};
+    auto snapshot = QSharedPointer<TemplateSnapshot>::create();
+    snapshot->filePath = fileInfo.absoluteFilePath();
+    snapshot->lastModified = fileInfo.lastModified();
+    snapshot->fileSize = fileInfo.size();
+    snapshot->fieldId_index["item_sku"] = 0;
+
+    auto cache = TemplateSnapshotCache::instance();
+    cache->insert(snapshot);
+    auto cached = cache->get(filePath);
+    QVERIFY(!cached.isNull());
+    QCOMPARE(cached->fieldId_index.value("item_sku"), 0);
+
+    QFile file{filePath};
+    QVERIFY(file.open(QFile::ReadWrite));
+    QVERIFY(file.setFileTime(fileInfo.lastModified().addSecs(60), QFileDevice::FileModificationTime));
+    file.close();
+    QVERIFY(cache->get(filePath).isNull());
+
+    cache->clear();
+}
+
+void TemplateFillerTests::test_fillerNames_stable()
+{
+    // The names are the keys of the fill checkpoints
+    QSet<QString> names;
+    for (const auto &filler : AbstractFiller::ALL_FILLERS_SORTED)
+    {
+        const auto &name = FillerDispatch::fillerName(filler);
+        QVERIFY(name.startsWith("Filler"));
+        QVERIFY(!names.contains(name));
+        names.insert(name);
+    }
+    QVERIFY(names.contains("FillerCopy"));
+    QVERIFY(names.contains("FillerSelectable"));
+}
+
+void TemplateFillerTests::test_fillerDispatch_oneFillerPerField()
+{
+    const FillerFake fillerCopy{"FillerCopy", {"brand_name", "color_name"}};
+    const FillerFake fillerSelectable{"FillerSelectable", {"color_name", "size_name"}};
+    const FillerFake fillerText{"FillerText", {"brand_name", "item_name", "size_name"}};
+    const QStringList sortedFieldIds{"brand_name", "color_name", "item_name", "size_name", "weight"};
+    FillerDispatch dispatch{nullptr
+                            , "amazon.fr"
+                            , sortedFieldIds
+                            , QList<const Attribute *>(sortedFieldIds.size(), nullptr)
+                            , {&fillerCopy, &fillerSelectable, &fillerText}};
+    QCOMPARE(dispatch.filler(0), &fillerCopy);
+    QCOMPARE(dispatch.filler(1), &fillerCopy);
+    QCOMPARE(dispatch.filler(2), &fillerText);
+    QCOMPARE(dispatch.filler(3), &fillerSelectable);
+    QCOMPARE(dispatch.filler(4), nullptr);
+    const auto &entries = dispatch.entries();
+    QCOMPARE(entries.size(), 3);
+    QCOMPARE(entries[0].positions, (QList<int>{0, 1}));
+    QCOMPARE(entries[1].positions, (QList<int>{3}));
+    QCOMPARE(entries[2].positions, (QList<int>{2}));
+    QVERIFY(dispatch.dump().contains("weight -> NONE"));
+}
+
 QTEST_MAIN(TemplateFillerTests)
 #include "tst_templatefiller.moc"
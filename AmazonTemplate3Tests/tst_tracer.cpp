@@ -0,0 +1,144 @@
+#include <functional>
+
+#include <QtTest>
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include "Tracer.h"
+
+class TracerTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void test_disabled_noEvent();
+    void test_spans_savedAsChromeTrace();
+    void test_traceSteps_untilApplied();
+
+private:
+    struct StepFake
+    {
+        QString name;
+        std::function<void(const QString &)> apply;
+    };
+    QTemporaryDir m_tempDir;
+    QJsonArray readEvents(const QString &filePath) const;
+};
+
+void TracerTests::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+}
+
+QJsonArray TracerTests::readEvents(const QString &filePath) const
+{
+    QFile file{filePath};
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return QJsonArray{};
+    }
+    return QJsonDocument::fromJson(file.readAll()).object()["traceEvents"].toArray();
+}
+
+void TracerTests::test_disabled_noEvent()
+{
+    if (Tracer::instance()->isEnabled())
+    {
+        QSKIP("AMZ_TRACE is set");
+    }
+    {
+        TraceSpan span{"notRecorded"};
+        span.setCounter("rows", 3);
+    }
+    QVERIFY(!Tracer::instance()->save());
+}
+
+void TracerTests::test_spans_savedAsChromeTrace()
+{
+    const auto &filePath = m_tempDir.filePath("trace.json");
+    auto tracer = Tracer::instance();
+    tracer->start(filePath);
+    tracer->clear();
+    {
+        TraceSpan spanRun{"run"};
+        {
+            TraceSpan span{"fillField", "DE"};
+            span.setArg("field", "color#1.value");
+            span.setCounter("rows", 12);
+            tracer->count("aiCacheHits", 2);
+        }
+    }
+    QVERIFY(tracer->save());
+
+    const auto &events = readEvents(filePath);
+    QJsonObject eventRun;
+    QJsonObject eventField;
+    QJsonObject eventTrackName;
+    for (const auto &event : events)
+    {
+        const auto &object = event.toObject();
+        if (object["name"] == "run")
+        {
+            eventRun = object;
+        }
+        else if (object["name"] == "fillField")
+        {
+            eventField = object;
+        }
+        else if (object["ph"] == "M" && object["args"].toObject()["name"] == "DE")
+        {
+            eventTrackName = object;
+        }
+    }
+    QCOMPARE(eventRun["ph"].toString(), QString("X"));
+    QVERIFY(eventRun["dur"].toInteger() >= eventField["dur"].toInteger());
+    QVERIFY(eventRun["ts"].toInteger() <= eventField["ts"].toInteger());
+    QCOMPARE(eventRun["args"].toObject()["aiCacheHits"].toInteger(), qint64(2));
+    const auto &argsField = eventField["args"].toObject();
+    QCOMPARE(argsField["field"].toString(), QString("color#1.value"));
+    QCOMPARE(argsField["rows"].toInteger(), qint64(12));
+    QCOMPARE(argsField["aiCacheHits"].toInteger(), qint64(2));
+    QVERIFY(argsField.contains("peakRssKb"));
+    QCOMPARE(eventTrackName["tid"].toInteger(), eventField["tid"].toInteger());
+    QVERIFY(eventRun["tid"].toInteger() != eventField["tid"].toInteger());
+}
+
+void TracerTests::test_traceSteps_untilApplied()
+{
+    const auto &filePath = m_tempDir.filePath("traceSteps.json");
+    auto tracer = Tracer::instance();
+    tracer->start(filePath);
+    tracer->clear();
+    QString replyApplied;
+    auto step = QSharedPointer<StepFake>::create();
+    step->name = "Select colour";
+    step->apply = [&replyApplied](const QString &reply) {
+        replyApplied = reply;
+    };
+    auto stepNotApplied = QSharedPointer<StepFake>::create();
+    stepNotApplied->name = "Never applied";
+    stepNotApplied->apply = [](const QString &) {};
+    tracer->traceSteps(QList<QSharedPointer<StepFake>>{step, stepNotApplied});
+    step->apply("Rot");
+    QCOMPARE(replyApplied, QString("Rot"));
+    QVERIFY(tracer->save());
+
+    QStringList phases;
+    for (const auto &event : readEvents(filePath))
+    {
+        const auto &object = event.toObject();
+        if (object["cat"] == "ai")
+        {
+            QCOMPARE(object["name"].toString(), QString("Select colour"));
+            phases << object["ph"].toString();
+        }
+    }
+    QCOMPARE(phases, QStringList({"b", "e"}));
+}
+
+QTEST_MAIN(TracerTests)
+#include "tst_tracer.moc"
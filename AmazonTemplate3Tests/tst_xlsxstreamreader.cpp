@@ -0,0 +1,229 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QTemporaryDir>
+
+#include "xlsxdocument.h"
+#include "XlsxStreamReader.h"
+#include "XlsxTemplateWriter.h"
+
+class XlsxStreamReaderTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void test_cellRefs();
+    void test_readSheet_sameAsQXlsx();
+    void test_readSheet_onlyRequested();
+    void test_readSheet_rowHandler();
+    void test_templateWriter_appendRows();
+    void test_templateWriter_mergeRowCells();
+    void test_templateWriter_keepsStyles();
+
+private:
+    QTemporaryDir m_tempDir;
+    QString createWorkbook(const QString &fileName);
+};
+
+void XlsxStreamReaderTests::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+}
+
+QString XlsxStreamReaderTests::createWorkbook(const QString &fileName)
+{
+    QString filePath = m_tempDir.filePath(fileName);
+    QXlsx::Document doc;
+    doc.addSheet("Template");
+    doc.selectSheet("Template");
+    doc.write(1, 1, "settings=V02");
+    doc.write(5, 1, "contribution_sku#1.value");
+    doc.write(5, 3, "item_name#1.value");
+    doc.write(6, 1, "SKU-1");
+    doc.write(6, 2, 42);
+    doc.write(6, 3, "Robe d'été");
+    doc.write(7, 1, "SKU-2");
+    doc.write(7, 2, 3.5);
+    doc.addSheet("Valid Values");
+    doc.selectSheet("Valid Values");
+    doc.write(2, 2, "Colour");
+    doc.write(2, 3, "Red");
+    doc.write(2, 4, "Blue");
+    doc.saveAs(filePath);
+    return filePath;
+}
+
+void XlsxStreamReaderTests::test_cellRefs()
+{
+    QCOMPARE(XlsxStreamReader::columnIndex(u"A1"), 0);
+    QCOMPARE(XlsxStreamReader::columnIndex(u"Z9"), 25);
+    QCOMPARE(XlsxStreamReader::columnIndex(u"AB12"), 27);
+    QCOMPARE(XlsxStreamReader::rowIndex(u"AB12"), 11);
+    QCOMPARE(XlsxStreamReader::columnName(0), QString("A"));
+    QCOMPARE(XlsxStreamReader::columnName(27), QString("AB"));
+    QCOMPARE(XlsxStreamReader::columnName(701), QString("ZZ"));
+}
+
+void XlsxStreamReaderTests::test_readSheet_sameAsQXlsx()
+{
+    const auto &filePath = createWorkbook("values.xlsx");
+    QXlsx::Document doc{filePath};
+    doc.selectSheet("Template");
+
+    XlsxStreamReader reader{filePath};
+    QVERIFY(reader.isValid());
+    QVERIFY(reader.sheetNames().contains("Template"));
+    const auto &sheet = reader.readSheet("Template");
+    QCOMPARE(sheet.lastRow, doc.dimension().lastRow());
+    QCOMPARE(sheet.lastColumn, doc.dimension().lastColumn());
+    for (int i=0; i<sheet.lastRow; ++i)
+    {
+        for (int j=0; j<sheet.lastColumn; ++j)
+        {
+            auto cell = doc.cellAt(i+1, j+1);
+            QCOMPARE(sheet.hasCell(i, j), cell != nullptr);
+            if (cell)
+            {
+                QCOMPARE(sheet.cellVal(i, j), cell->value().toString());
+            }
+        }
+    }
+}
+
+void XlsxStreamReaderTests::test_readSheet_onlyRequested()
+{
+    const auto &filePath = createWorkbook("sheets.xlsx");
+    XlsxStreamReader reader{filePath};
+    const auto &sheet = reader.readSheet("Valid Values");
+    QCOMPARE(sheet.cellVal(1, 1), QString("Colour"));
+    QCOMPARE(sheet.cellVal(1, 3), QString("Blue"));
+    QVERIFY(!sheet.hasCell(0, 0));
+    QCOMPARE(reader.readSheet("Not a sheet").lastRow, 0);
+}
+
+void XlsxStreamReaderTests::test_readSheet_rowHandler()
+{
+    const auto &filePath = createWorkbook("handler.xlsx");
+    XlsxStreamReader reader{filePath};
+    QList<int> rowsHandled;
+    const auto &sheet = reader.readSheet(
+                "Template"
+                , [&rowsHandled](int row, QStringList &values) -> bool
+    {
+        rowsHandled << row;
+        return values.value(0).startsWith("SKU-");
+    }, 2);
+    QCOMPARE(rowsHandled, (QList<int>{0, 4, 5, 6}));
+    QCOMPARE(sheet.lastRow, 7);
+    QCOMPARE(sheet.lastColumn, 3);
+    QVERIFY(!sheet.hasCell(0, 0));
+    QVERIFY(!sheet.hasCell(4, 0));
+    QCOMPARE(sheet.cellVal(5, 0), QString("SKU-1"));
+    QCOMPARE(sheet.cellVal(5, 1), QString("42"));
+    QVERIFY(!sheet.hasCell(5, 2));
+    QCOMPARE(sheet.cellVal(6, 1), QString("3.5"));
+}
+
+void XlsxStreamReaderTests::test_templateWriter_appendRows()
+{
+    const auto &filePath = createWorkbook("toWrite.xlsx");
+    const auto &filePathWritten = m_tempDir.filePath("written.xlsx");
+    XlsxTemplateWriter writer{filePath};
+    QVERIFY(writer.selectSheet("Template"));
+    writer.write(8, 1, "SKU-3");
+    writer.write(8, 3, "Rock & <Roll>");
+    writer.write(10, 5, "Last");
+    QVERIFY(writer.saveAs(filePathWritten));
+
+    QXlsx::Document doc{filePathWritten};
+    QVERIFY(doc.sheetNames().contains("Valid Values"));
+    doc.selectSheet("Template");
+    QCOMPARE(doc.read(6, 3).toString(), QString("Robe d'été"));
+    QCOMPARE(doc.read(8, 1).toString(), QString("SKU-3"));
+    QCOMPARE(doc.read(8, 3).toString(), QString("Rock & <Roll>"));
+    QCOMPARE(doc.read(10, 5).toString(), QString("Last"));
+
+    XlsxStreamReader reader{filePathWritten};
+    const auto &sheet = reader.readSheet("Template");
+    QCOMPARE(sheet.lastRow, 10);
+    QCOMPARE(sheet.lastColumn, 5);
+    QCOMPARE(sheet.cellVal(6, 1), QString("3.5"));
+    QCOMPARE(reader.readSheet("Valid Values").cellVal(1, 3), QString("Blue"));
+}
+
+void XlsxStreamReaderTests::test_templateWriter_mergeRowCells()
+{
+    const auto &filePath = createWorkbook("toMerge.xlsx");
+    const auto &filePathWritten = m_tempDir.filePath("merged.xlsx");
+    XlsxTemplateWriter writer{filePath};
+    QVERIFY(writer.selectSheet("Template"));
+    writer.write(6, 3, "Robe d'hiver");
+    writer.write(6, 4, "Rouge");
+    writer.write(7, 3, "Jupe");
+    QVERIFY(writer.saveAs(filePathWritten));
+
+    QXlsx::Document doc{filePathWritten};
+    doc.selectSheet("Template");
+    QCOMPARE(doc.read(6, 1).toString(), QString("SKU-1"));
+    QCOMPARE(doc.read(6, 2).toInt(), 42);
+    QCOMPARE(doc.read(6, 3).toString(), QString("Robe d'hiver"));
+    QCOMPARE(doc.read(6, 4).toString(), QString("Rouge"));
+    QCOMPARE(doc.read(7, 1).toString(), QString("SKU-2"));
+    QCOMPARE(doc.read(7, 3).toString(), QString("Jupe"));
+
+    XlsxStreamReader reader{filePathWritten};
+    const auto &sheet = reader.readSheet("Template");
+    QCOMPARE(sheet.lastRow, 7);
+    QCOMPARE(sheet.lastColumn, 4);
+    QCOMPARE(sheet.cellVal(5, 0), QString("SKU-1"));
+    QCOMPARE(sheet.cellVal(5, 1), QString("42"));
+    QCOMPARE(sheet.cellVal(5, 2), QString("Robe d'hiver"));
+    QCOMPARE(sheet.cellVal(6, 1), QString("3.5"));
+}
+
+void XlsxStreamReaderTests::test_templateWriter_keepsStyles()
+{
+    const auto &filePath = m_tempDir.filePath("styled.xlsx");
+    const auto &filePathWritten = m_tempDir.filePath("styledWritten.xlsx");
+    {
+        QXlsx::Document doc;
+        doc.addSheet("Template");
+        doc.selectSheet("Template");
+        QXlsx::Format formatBold;
+        formatBold.setFontBold(true);
+        doc.write(6, 1, "SKU-1");
+        doc.write(6, 2, "Vert", formatBold);
+        doc.write(6, 3, "Lin", formatBold);
+        doc.saveAs(filePath);
+    }
+    XlsxTemplateWriter writer{filePath};
+    QVERIFY(writer.selectSheet("Template"));
+    writer.write(6, 2, "Rouge");
+    writer.write(6, 3, "");
+    writer.write(6, 5, "Coton");
+    QVERIFY(writer.saveAs(filePathWritten));
+
+    QXlsx::Document doc{filePathWritten};
+    doc.selectSheet("Template");
+    auto cellWritten = doc.cellAt(6, 2);
+    QVERIFY(cellWritten != nullptr);
+    QCOMPARE(cellWritten->value().toString(), QString("Rouge"));
+    QVERIFY(cellWritten->format().fontBold());
+    auto cellEmptied = doc.cellAt(6, 3);
+    QVERIFY(cellEmptied != nullptr);
+    QVERIFY(cellEmptied->value().toString().isEmpty());
+    QVERIFY(cellEmptied->format().fontBold());
+    QCOMPARE(doc.read(6, 5).toString(), QString("Coton"));
+    QVERIFY(!doc.cellAt(6, 5)->format().fontBold());
+
+    // The columns hint of the row covers the cell added after the others
+    XlsxStreamReader reader{filePathWritten};
+    const QByteArray &sheetXml = reader.entryData(reader.sheetEntryPath("Template"));
+    int posRow = sheetXml.indexOf("<row r=\"6\"");
+    QVERIFY(posRow >= 0);
+    const QByteArray &rowTag = sheetXml.mid(posRow, sheetXml.indexOf('>', posRow) - posRow);
+    QVERIFY(!rowTag.contains("spans=") || rowTag.contains("spans=\"1:5\""));
+}
+
+QTEST_MAIN(XlsxStreamReaderTests)
+#include "tst_xlsxstreamreader.moc"